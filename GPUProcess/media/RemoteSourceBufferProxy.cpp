@@ -36,6 +36,8 @@
 #include <WebCore/MediaDescription.h>
 #include <WebCore/PlatformTimeRanges.h>
 
+#define MESSAGE_CHECK_COMPLETION(assertion, completion) MESSAGE_CHECK_COMPLETION_BASE(assertion, (&m_connectionToWebProcess.connection()), completion)
+
 namespace WebKit {
 
 using namespace WebCore;
@@ -165,6 +167,24 @@ void RemoteSourceBufferProxy::append(const IPC::DataReference& data)
     m_sourceBufferPrivate->append(data.vector());
 }
 
+void RemoteSourceBufferProxy::setAppendSharedMemory(const SharedMemory::IPCHandle& ipcHandle)
+{
+    m_appendSharedMemory = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
+}
+
+void RemoteSourceBufferProxy::appendFromSharedMemory(uint64_t size, CompletionHandler<void()>&& completionHandler)
+{
+    MESSAGE_CHECK_COMPLETION(m_appendSharedMemory && size <= m_appendSharedMemory->size(), completionHandler());
+
+    Vector<unsigned char> data;
+    data.append(static_cast<const unsigned char*>(m_appendSharedMemory->data()), size);
+
+    // The segment has been copied out of shared memory, so the WebProcess is free to reuse it.
+    completionHandler();
+
+    m_sourceBufferPrivate->append(WTFMove(data));
+}
+
 void RemoteSourceBufferProxy::abort()
 {
     m_sourceBufferPrivate->abort();
@@ -313,4 +333,6 @@ void RemoteSourceBufferProxy::bufferedSamplesForTrackId(TrackPrivateRemoteIdenti
 
 } // namespace WebKit
 
+#undef MESSAGE_CHECK_COMPLETION
+
 #endif // ENABLE(GPU_PROCESS) && ENABLE(MEDIA_SOURCE)
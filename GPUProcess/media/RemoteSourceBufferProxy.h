@@ -31,6 +31,7 @@
 #include "GPUConnectionToWebProcess.h"
 #include "MessageReceiver.h"
 #include "RemoteSourceBufferIdentifier.h"
+#include "SharedMemory.h"
 #include "TrackPrivateRemoteIdentifier.h"
 #include <WebCore/MediaDescription.h>
 #include <WebCore/SourceBufferPrivate.h>
@@ -86,6 +87,8 @@ private:
     void setActive(bool);
     void setMode(WebCore::SourceBufferAppendMode);
     void append(const IPC::DataReference&);
+    void setAppendSharedMemory(const SharedMemory::IPCHandle&);
+    void appendFromSharedMemory(uint64_t size, CompletionHandler<void()>&&);
     void abort();
     void resetParserState();
     void removedFromMediaSource();
@@ -115,6 +118,7 @@ private:
     RemoteSourceBufferIdentifier m_identifier;
     Ref<WebCore::SourceBufferPrivate> m_sourceBufferPrivate;
     WeakPtr<RemoteMediaPlayerProxy> m_remoteMediaPlayerProxy;
+    RefPtr<SharedMemory> m_appendSharedMemory;
 
     HashMap<TrackPrivateRemoteIdentifier, AtomString> m_trackIds;
     HashMap<TrackPrivateRemoteIdentifier, Ref<WebCore::MediaDescription>> m_mediaDescriptions;
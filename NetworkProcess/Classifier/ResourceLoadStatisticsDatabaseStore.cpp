@@ -75,22 +75,22 @@ constexpr auto insertObservedDomainQuery = "INSERT INTO ObservedDomains (registr
     "mostRecentUserInteractionTime, grandfathered, isPrevalent, isVeryPrevalent, dataRecordsRemoved, timesAccessedAsFirstPartyDueToUserInteraction,"
     "timesAccessedAsFirstPartyDueToStorageAccessAPI, isScheduledForAllButCookieDataRemoval) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"_s;
 constexpr auto insertTopLevelDomainQuery = "INSERT INTO TopLevelDomains VALUES (?)"_s;
-constexpr auto storageAccessUnderTopFrameDomainsQuery = "INSERT OR IGNORE INTO StorageAccessUnderTopFrameDomains (domainID, topLevelDomainID) SELECT ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
-constexpr auto topFrameUniqueRedirectsToQuery = "INSERT OR IGNORE into TopFrameUniqueRedirectsTo (sourceDomainID, toDomainID) SELECT ?, domainID FROM ObservedDomains where registrableDomain in ( "_s;
-constexpr auto topFrameUniqueRedirectsToSinceSameSiteStrictEnforcementQuery = "INSERT OR IGNORE into TopFrameUniqueRedirectsToSinceSameSiteStrictEnforcement (sourceDomainID, toDomainID) SELECT ?, domainID FROM ObservedDomains where registrableDomain in ( "_s;
-constexpr auto topFrameUniqueRedirectsFromQuery = "INSERT OR IGNORE INTO TopFrameUniqueRedirectsFrom (targetDomainID, fromDomainID) SELECT ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
-constexpr auto topFrameLoadedThirdPartyScriptsQuery = "INSERT OR IGNORE into TopFrameLoadedThirdPartyScripts (topFrameDomainID, subresourceDomainID) SELECT ?, domainID FROM ObservedDomains where registrableDomain in ( "_s;
-constexpr auto subresourceUniqueRedirectsFromQuery = "INSERT OR IGNORE INTO SubresourceUniqueRedirectsFrom (subresourceDomainID, fromDomainID) SELECT ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
+constexpr auto storageAccessUnderTopFrameDomainsQuery = "INSERT OR IGNORE INTO StorageAccessUnderTopFrameDomains (domainID, topLevelDomainID) VALUES (?, ?)"_s;
+constexpr auto topFrameUniqueRedirectsToQuery = "INSERT OR IGNORE into TopFrameUniqueRedirectsTo (sourceDomainID, toDomainID) VALUES (?, ?)"_s;
+constexpr auto topFrameUniqueRedirectsToSinceSameSiteStrictEnforcementQuery = "INSERT OR IGNORE into TopFrameUniqueRedirectsToSinceSameSiteStrictEnforcement (sourceDomainID, toDomainID) VALUES (?, ?)"_s;
+constexpr auto topFrameUniqueRedirectsFromQuery = "INSERT OR IGNORE INTO TopFrameUniqueRedirectsFrom (targetDomainID, fromDomainID) VALUES (?, ?)"_s;
+constexpr auto topFrameLoadedThirdPartyScriptsQuery = "INSERT OR IGNORE into TopFrameLoadedThirdPartyScripts (topFrameDomainID, subresourceDomainID) VALUES (?, ?)"_s;
+constexpr auto subresourceUniqueRedirectsFromQuery = "INSERT OR IGNORE INTO SubresourceUniqueRedirectsFrom (subresourceDomainID, fromDomainID) VALUES (?, ?)"_s;
 constexpr auto insertUnattributedPrivateClickMeasurementQuery = "INSERT OR REPLACE INTO UnattributedPrivateClickMeasurement (sourceSiteDomainID, attributeOnSiteDomainID, "
     "sourceID, timeOfAdClick) VALUES (?, ?, ?, ?)"_s;
 constexpr auto insertAttributedPrivateClickMeasurementQuery = "INSERT OR REPLACE INTO AttributedPrivateClickMeasurement (sourceSiteDomainID, attributeOnSiteDomainID, "
     "sourceID, attributionTriggerData, priority, timeOfAdClick, earliestTimeToSend) VALUES (?, ?, ?, ?, ?, ?, ?)"_s;
 
 // INSERT OR REPLACE Queries
-constexpr auto subframeUnderTopFrameDomainsQuery = "INSERT OR REPLACE into SubframeUnderTopFrameDomains (subFrameDomainID, lastUpdated, topFrameDomainID) SELECT ?, ?, domainID FROM ObservedDomains where registrableDomain in ( "_s;
-constexpr auto topFrameLinkDecorationsFromQuery = "INSERT OR REPLACE INTO TopFrameLinkDecorationsFrom (toDomainID, lastUpdated, fromDomainID) SELECT ?, ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
-constexpr auto subresourceUnderTopFrameDomainsQuery = "INSERT OR REPLACE INTO SubresourceUnderTopFrameDomains (subresourceDomainID, lastUpdated, topFrameDomainID) SELECT ?, ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
-constexpr auto subresourceUniqueRedirectsToQuery = "INSERT OR REPLACE INTO SubresourceUniqueRedirectsTo (subresourceDomainID, lastUpdated, toDomainID) SELECT ?, ?, domainID FROM ObservedDomains WHERE registrableDomain in ( "_s;
+constexpr auto subframeUnderTopFrameDomainsQuery = "INSERT OR REPLACE into SubframeUnderTopFrameDomains (subFrameDomainID, lastUpdated, topFrameDomainID) VALUES (?, ?, ?)"_s;
+constexpr auto topFrameLinkDecorationsFromQuery = "INSERT OR REPLACE INTO TopFrameLinkDecorationsFrom (toDomainID, lastUpdated, fromDomainID) VALUES (?, ?, ?)"_s;
+constexpr auto subresourceUnderTopFrameDomainsQuery = "INSERT OR REPLACE INTO SubresourceUnderTopFrameDomains (subresourceDomainID, lastUpdated, topFrameDomainID) VALUES (?, ?, ?)"_s;
+constexpr auto subresourceUniqueRedirectsToQuery = "INSERT OR REPLACE INTO SubresourceUniqueRedirectsTo (subresourceDomainID, lastUpdated, toDomainID) VALUES (?, ?, ?)"_s;
 
 // EXISTS Queries
 constexpr auto subframeUnderTopFrameDomainExistsQuery = "SELECT EXISTS (SELECT 1 FROM SubframeUnderTopFrameDomains WHERE subFrameDomainID = ? "
@@ -248,6 +248,10 @@ constexpr auto createAttributedPrivateClickMeasurement = "CREATE TABLE Attribute
     "FOREIGN KEY(sourceSiteDomainID) REFERENCES ObservedDomains(domainID) ON DELETE CASCADE, "
     "FOREIGN KEY(attributeOnSiteDomainID) REFERENCES ObservedDomains(domainID) ON DELETE CASCADE);"_s;
 
+// Domains whose classification inputs changed since the last classification pass.
+constexpr auto createPendingClassificationDomains = "CREATE TABLE PendingClassificationDomains ("
+    "domainID INTEGER PRIMARY KEY, FOREIGN KEY(domainID) REFERENCES ObservedDomains(domainID) ON DELETE CASCADE);"_s;
+
 // CREATE UNIQUE INDEX Queries.
 constexpr auto createUniqueIndexStorageAccessUnderTopFrameDomains = "CREATE UNIQUE INDEX IF NOT EXISTS StorageAccessUnderTopFrameDomains_domainID_topLevelDomainID on StorageAccessUnderTopFrameDomains ( domainID, topLevelDomainID );"_s;
 constexpr auto createUniqueIndexTopFrameUniqueRedirectsTo = "CREATE UNIQUE INDEX IF NOT EXISTS TopFrameUniqueRedirectsTo_sourceDomainID_toDomainID on TopFrameUniqueRedirectsTo ( sourceDomainID, toDomainID );"_s;
@@ -263,6 +267,23 @@ constexpr auto createUniqueIndexOperatingDates = "CREATE UNIQUE INDEX IF NOT EXI
 constexpr auto createUniqueIndexUnattributedPrivateClickMeasurement = "CREATE UNIQUE INDEX IF NOT EXISTS UnattributedPrivateClickMeasurement_sourceSiteDomainID_attributeOnSiteDomainID on UnattributedPrivateClickMeasurement ( sourceSiteDomainID, attributeOnSiteDomainID );"_s;
 constexpr auto createUniqueIndexAttributedPrivateClickMeasurement = "CREATE UNIQUE INDEX IF NOT EXISTS AttributedPrivateClickMeasurement_sourceSiteDomainID_attributeOnSiteDomainID on AttributedPrivateClickMeasurement ( sourceSiteDomainID, attributeOnSiteDomainID );"_s;
 
+// CREATE TRIGGER Queries.
+constexpr auto createSubresourceUnderTopFrameDomainsClassificationTrigger = "CREATE TRIGGER IF NOT EXISTS SubresourceUnderTopFrameDomains_markPendingClassification "
+    "AFTER INSERT ON SubresourceUnderTopFrameDomains BEGIN INSERT OR IGNORE INTO PendingClassificationDomains (domainID) VALUES (NEW.subresourceDomainID); END;"_s;
+constexpr auto createSubresourceUniqueRedirectsToClassificationTrigger = "CREATE TRIGGER IF NOT EXISTS SubresourceUniqueRedirectsTo_markPendingClassification "
+    "AFTER INSERT ON SubresourceUniqueRedirectsTo BEGIN INSERT OR IGNORE INTO PendingClassificationDomains (domainID) VALUES (NEW.subresourceDomainID); END;"_s;
+constexpr auto createSubframeUnderTopFrameDomainsClassificationTrigger = "CREATE TRIGGER IF NOT EXISTS SubframeUnderTopFrameDomains_markPendingClassification "
+    "AFTER INSERT ON SubframeUnderTopFrameDomains BEGIN INSERT OR IGNORE INTO PendingClassificationDomains (domainID) VALUES (NEW.subFrameDomainID); END;"_s;
+constexpr auto createTopFrameUniqueRedirectsToClassificationTrigger = "CREATE TRIGGER IF NOT EXISTS TopFrameUniqueRedirectsTo_markPendingClassification "
+    "AFTER INSERT ON TopFrameUniqueRedirectsTo BEGIN INSERT OR IGNORE INTO PendingClassificationDomains (domainID) VALUES (NEW.sourceDomainID); END;"_s;
+// A domain whose prevalence was lowered, e.g. through clearPrevalentResource(), needs to be looked at again even though its relationships did not change.
+constexpr auto createObservedDomainsClassificationTrigger = "CREATE TRIGGER IF NOT EXISTS ObservedDomains_markPendingClassification "
+    "AFTER UPDATE OF isPrevalent, isVeryPrevalent ON ObservedDomains WHEN NEW.isPrevalent < OLD.isPrevalent OR NEW.isVeryPrevalent < OLD.isVeryPrevalent "
+    "BEGIN INSERT OR IGNORE INTO PendingClassificationDomains (domainID) VALUES (NEW.domainID); END;"_s;
+
+constexpr auto markAllNotVeryPrevalentDomainsPendingClassificationQuery = "INSERT OR IGNORE INTO PendingClassificationDomains (domainID) SELECT domainID FROM ObservedDomains WHERE isVeryPrevalent = 0"_s;
+constexpr auto clearPendingClassificationDomainsQuery = "DELETE FROM PendingClassificationDomains"_s;
+
 static const String ObservedDomainsTableSchemaV1()
 {
     return createObservedDomain;
@@ -295,7 +316,8 @@ static const HashMap<String, String>& createTableQueries()
         { "SubresourceUniqueRedirectsFrom"_s, createSubresourceUniqueRedirectsFrom},
         { "OperatingDates"_s, createOperatingDates},
         { "UnattributedPrivateClickMeasurement"_s, createUnattributedPrivateClickMeasurement},
-        { "AttributedPrivateClickMeasurement"_s, createAttributedPrivateClickMeasurement}
+        { "AttributedPrivateClickMeasurement"_s, createAttributedPrivateClickMeasurement},
+        { "PendingClassificationDomains"_s, createPendingClassificationDomains}
     });
     
     return createTableQueries;
@@ -338,6 +360,7 @@ ResourceLoadStatisticsDatabaseStore::~ResourceLoadStatisticsDatabaseStore()
 void ResourceLoadStatisticsDatabaseStore::close()
 {
     destroyStatements();
+    clearDomainIDCache();
     if (m_database.isOpen())
         m_database.close();
 }
@@ -482,6 +505,13 @@ void ResourceLoadStatisticsDatabaseStore::migrateDataToNewTablesIfNecessary()
         ASSERT_NOT_REACHED();
         return;
     }
+
+    // The triggers moved to the renamed tables and were dropped with them.
+    if (!createClassificationTriggers()) {
+        RELEASE_LOG_ERROR(Network, "%p - ResourceLoadStatisticsDatabaseStore::migrateDataToNewTablesWithCascadingDeletion failed to create classification triggers, error message: %{private}s", this, m_database.lastErrorMsg());
+        ASSERT_NOT_REACHED();
+        return;
+    }
 }
 
 void ResourceLoadStatisticsDatabaseStore::addMissingTablesIfNecessary()
@@ -501,6 +531,16 @@ void ResourceLoadStatisticsDatabaseStore::addMissingTablesIfNecessary()
         ASSERT_NOT_REACHED();
         return;
     }
+
+    if (!createClassificationTriggers()) {
+        RELEASE_LOG_ERROR(Network, "%p - ResourceLoadStatisticsDatabaseStore::addMissingTables failed to create classification triggers, error message: %{private}s", this, m_database.lastErrorMsg());
+        ASSERT_NOT_REACHED();
+        return;
+    }
+
+    // Nothing has tracked changes in an existing database yet, so the first pass has to look at every candidate.
+    if (missingTables->contains("PendingClassificationDomains") && !m_database.executeCommand(markAllNotVeryPrevalentDomainsPendingClassificationQuery))
+        RELEASE_LOG_ERROR(Network, "%p - ResourceLoadStatisticsDatabaseStore::addMissingTables failed to mark domains pending classification, error message: %{private}s", this, m_database.lastErrorMsg());
 }
 
 void ResourceLoadStatisticsDatabaseStore::openAndUpdateSchemaIfNecessary()
@@ -596,6 +636,19 @@ bool ResourceLoadStatisticsDatabaseStore::createUniqueIndices()
     return true;
 }
 
+bool ResourceLoadStatisticsDatabaseStore::createClassificationTriggers()
+{
+    if (!m_database.executeCommand(createSubresourceUnderTopFrameDomainsClassificationTrigger)
+        || !m_database.executeCommand(createSubresourceUniqueRedirectsToClassificationTrigger)
+        || !m_database.executeCommand(createSubframeUnderTopFrameDomainsClassificationTrigger)
+        || !m_database.executeCommand(createTopFrameUniqueRedirectsToClassificationTrigger)
+        || !m_database.executeCommand(createObservedDomainsClassificationTrigger)) {
+        RELEASE_LOG_ERROR(Network, "%p - ResourceLoadStatisticsDatabaseStore::createClassificationTriggers failed to execute, error message: %{private}s", this, m_database.lastErrorMsg());
+        return false;
+    }
+    return true;
+}
+
 bool ResourceLoadStatisticsDatabaseStore::createSchema()
 {
     ASSERT(!RunLoop::isMain());
@@ -675,9 +728,17 @@ bool ResourceLoadStatisticsDatabaseStore::createSchema()
         return false;
     }
 
+    if (!m_database.executeCommand(createPendingClassificationDomains)) {
+        LOG_ERROR("Could not create PendingClassificationDomains table in database (%i) - %s", m_database.lastError(), m_database.lastErrorMsg());
+        return false;
+    }
+
     if (!createUniqueIndices())
         return false;
 
+    if (!createClassificationTriggers())
+        return false;
+
     return true;
 }
 
@@ -734,6 +795,7 @@ void ResourceLoadStatisticsDatabaseStore::destroyStatements()
     m_findAttributedStatement = nullptr;
     m_updateAttributionsEarliestTimeToSendStatement = nullptr;
     m_removeUnattributedStatement = nullptr;
+    m_insertDomainRelationshipStatements.clear();
 }
 
 bool ResourceLoadStatisticsDatabaseStore::insertObservedDomain(const ResourceLoadStatistics& loadStatistics)
@@ -789,10 +851,46 @@ bool ResourceLoadStatisticsDatabaseStore::relationshipExists(SQLiteStatementAuto
     return !!statement->getColumnInt(0);
 }
 
+// Most lookups are for the few domains of the pages being loaded, there's no need to keep every ID in memory.
+static const size_t maximumDomainIDCacheSize = 1000;
+
+Optional<unsigned> ResourceLoadStatisticsDatabaseStore::cachedDomainID(const RegistrableDomain& domain) const
+{
+    auto iterator = m_domainIDCache.find(domain);
+    if (iterator == m_domainIDCache.end())
+        return WTF::nullopt;
+
+    m_domainIDCacheRecency.appendOrMoveToLast(domain);
+    return iterator->value;
+}
+
+void ResourceLoadStatisticsDatabaseStore::cacheDomainID(const RegistrableDomain& domain, unsigned domainID) const
+{
+    m_domainIDCache.set(domain, domainID);
+    m_domainIDCacheRecency.appendOrMoveToLast(domain);
+    if (m_domainIDCacheRecency.size() > maximumDomainIDCacheSize)
+        m_domainIDCache.remove(m_domainIDCacheRecency.takeFirst());
+}
+
+void ResourceLoadStatisticsDatabaseStore::removeCachedDomainID(const RegistrableDomain& domain)
+{
+    m_domainIDCache.remove(domain);
+    m_domainIDCacheRecency.remove(domain);
+}
+
+void ResourceLoadStatisticsDatabaseStore::clearDomainIDCache()
+{
+    m_domainIDCache.clear();
+    m_domainIDCacheRecency.clear();
+}
+
 Optional<unsigned> ResourceLoadStatisticsDatabaseStore::domainID(const RegistrableDomain& domain) const
 {
     ASSERT(!RunLoop::isMain());
 
+    if (auto domainID = cachedDomainID(domain))
+        return domainID;
+
     auto scopedStatement = this->scopedStatement(m_domainIDFromStringStatement, domainIDFromStringQuery, "domainID"_s);
     if (!scopedStatement
         || scopedStatement->bindText(1, domain.string()) != SQLITE_OK) {
@@ -804,52 +902,43 @@ Optional<unsigned> ResourceLoadStatisticsDatabaseStore::domainID(const Registrab
     if (scopedStatement->step() != SQLITE_ROW)
         return WTF::nullopt;
 
-    return scopedStatement->getColumnInt(0);
+    unsigned domainID = scopedStatement->getColumnInt(0);
+    cacheDomainID(domain, domainID);
+    return domainID;
 }
 
-String ResourceLoadStatisticsDatabaseStore::ensureAndMakeDomainList(const HashSet<RegistrableDomain>& domainList)
+void ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList(const String& statement, const HashSet<RegistrableDomain>& domainList, unsigned domainID)
 {
-    StringBuilder builder;
-    
-    for (auto& topFrameResource : domainList) {
-        
-        // Insert query will fail if top frame domain is not already in the database
-        auto result = ensureResourceStatisticsForRegistrableDomain(topFrameResource);
-        if (result.second) {
-            if (!builder.isEmpty())
-                builder.appendLiteral(", ");
-            builder.append('"');
-            builder.append(topFrameResource.string());
-            builder.append('"');
-        }
-    }
+    if (domainList.isEmpty())
+        return;
 
-    return builder.toString();
-}
+    bool hasLastUpdatedColumn = statement.contains("REPLACE");
+    auto lastUpdated = WallTime::now().secondsSinceEpoch().value();
+    unsigned relatedDomainIndex = hasLastUpdatedColumn ? 3 : 2;
 
-void ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList(const String& statement, const HashSet<RegistrableDomain>& domainList, unsigned domainID)
-{
-    SQLiteStatement insertRelationshipStatement(m_database, makeString(statement, ensureAndMakeDomainList(domainList), " );"));
-    
-    if (insertRelationshipStatement.prepare() != SQLITE_OK
-        || insertRelationshipStatement.bindInt(1, domainID) != SQLITE_OK) {
-            RELEASE_LOG_ERROR_IF_ALLOWED(m_sessionID, "%p - ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList failed, error message: %{private}s", this, m_database.lastErrorMsg());
+    auto& insertRelationshipStatement = m_insertDomainRelationshipStatements.add(statement, nullptr).iterator->value;
+    for (auto& relatedDomain : domainList) {
+        // Insert query will fail if the related domain is not already in the database.
+        auto relatedDomainID = ensureResourceStatisticsForRegistrableDomain(relatedDomain).second;
+        if (!relatedDomainID)
+            continue;
+
+        auto scopedStatement = this->scopedStatement(insertRelationshipStatement, statement, "insertDomainRelationshipList"_s);
+        if (!scopedStatement
+            || scopedStatement->bindInt(1, domainID) != SQLITE_OK
+            || (hasLastUpdatedColumn && scopedStatement->bindDouble(2, lastUpdated) != SQLITE_OK)
+            || scopedStatement->bindInt(relatedDomainIndex, *relatedDomainID) != SQLITE_OK) {
+            RELEASE_LOG_ERROR_IF_ALLOWED(m_sessionID, "%p - ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList failed to bind, error message: %{private}s", this, m_database.lastErrorMsg());
             ASSERT_NOT_REACHED();
-    }
-    
-    if (statement.contains("REPLACE")) {
-        if (insertRelationshipStatement.bindDouble(2, WallTime::now().secondsSinceEpoch().value()) != SQLITE_OK) {
+            return;
+        }
+
+        if (scopedStatement->step() != SQLITE_DONE) {
             RELEASE_LOG_ERROR_IF_ALLOWED(m_sessionID, "%p - ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList failed, error message: %{private}s", this, m_database.lastErrorMsg());
             ASSERT_NOT_REACHED();
             return;
         }
     }
-
-    if (insertRelationshipStatement.step() != SQLITE_DONE) {
-        RELEASE_LOG_ERROR_IF_ALLOWED(m_sessionID, "%p - ResourceLoadStatisticsDatabaseStore::insertDomainRelationshipList failed, error message: %{private}s", this, m_database.lastErrorMsg());
-        ASSERT_NOT_REACHED();
-        return;
-    }
 }
 
 void ResourceLoadStatisticsDatabaseStore::insertDomainRelationships(const ResourceLoadStatistics& loadStatistics)
@@ -879,6 +968,9 @@ void ResourceLoadStatisticsDatabaseStore::populateFromMemoryStore(const Resource
     if (!isEmpty())
         return;
 
+    SQLiteTransaction transaction(m_database);
+    transaction.begin();
+
     auto& statisticsMap = memoryStore.data();
     for (const auto& statistic : statisticsMap) {
         auto result = insertObservedDomain(statistic.value);
@@ -893,6 +985,8 @@ void ResourceLoadStatisticsDatabaseStore::populateFromMemoryStore(const Resource
     // can refer to the ObservedDomain table entries
     for (auto& statistic : statisticsMap)
         insertDomainRelationships(statistic.value);
+
+    transaction.commit();
 }
 
 void ResourceLoadStatisticsDatabaseStore::merge(WebCore::SQLiteStatement* current, const ResourceLoadStatistics& other)
@@ -952,6 +1046,10 @@ void ResourceLoadStatisticsDatabaseStore::mergeStatistics(Vector<ResourceLoadSta
 {
     ASSERT(!RunLoop::isMain());
 
+    // One transaction for the whole batch, so SQLite does not sync to disk after every row.
+    SQLiteTransaction transaction(m_database);
+    transaction.begin();
+
     for (auto& statistic : statistics) {
         if (!domainID(statistic.registrableDomain)) {
             auto result = insertObservedDomain(statistic);
@@ -968,6 +1066,8 @@ void ResourceLoadStatisticsDatabaseStore::mergeStatistics(Vector<ResourceLoadSta
     // can refer to the ObservedDomain table entries.
     for (auto& statistic : statistics)
         insertDomainRelationships(statistic);
+
+    transaction.commit();
 }
 
 static const StringView joinSubStatisticsForSorting()
@@ -1151,12 +1251,12 @@ void ResourceLoadStatisticsDatabaseStore::markAsPrevalentIfHasRedirectedToPreval
     }
 }
 
-HashMap<unsigned, ResourceLoadStatisticsDatabaseStore::NotVeryPrevalentResources> ResourceLoadStatisticsDatabaseStore::findNotVeryPrevalentResources()
+HashMap<unsigned, ResourceLoadStatisticsDatabaseStore::NotVeryPrevalentResources> ResourceLoadStatisticsDatabaseStore::findNotVeryPrevalentResourcesPendingClassification()
 {
     ASSERT(!RunLoop::isMain());
 
     HashMap<unsigned, NotVeryPrevalentResources> results;
-    SQLiteStatement notVeryPrevalentResourcesStatement(m_database, "SELECT domainID, registrableDomain, isPrevalent FROM ObservedDomains WHERE isVeryPrevalent = 0"_s);
+    SQLiteStatement notVeryPrevalentResourcesStatement(m_database, "SELECT o.domainID, o.registrableDomain, o.isPrevalent FROM ObservedDomains o INNER JOIN PendingClassificationDomains p ON o.domainID = p.domainID WHERE o.isVeryPrevalent = 0"_s);
     if (notVeryPrevalentResourcesStatement.prepare() == SQLITE_OK) {
         while (notVeryPrevalentResourcesStatement.step() == SQLITE_ROW) {
             unsigned key = static_cast<unsigned>(notVeryPrevalentResourcesStatement.getColumnInt(0));
@@ -1167,6 +1267,9 @@ HashMap<unsigned, ResourceLoadStatisticsDatabaseStore::NotVeryPrevalentResources
         }
     }
 
+    if (results.isEmpty())
+        return results;
+
     StringBuilder builder;
     for (auto value : results.keys()) {
         if (!builder.isEmpty())
@@ -1223,7 +1326,8 @@ void ResourceLoadStatisticsDatabaseStore::reclassifyResources()
 {
     ASSERT(!RunLoop::isMain());
 
-    auto notVeryPrevalentResources = findNotVeryPrevalentResources();
+    // Only domains whose relationship counts changed since the last pass can get a different result from the classifier.
+    auto notVeryPrevalentResources = findNotVeryPrevalentResourcesPendingClassification();
 
     for (auto& resourceStatistic : notVeryPrevalentResources.values()) {
         if (shouldSkip(resourceStatistic.registrableDomain))
@@ -1233,6 +1337,9 @@ void ResourceLoadStatisticsDatabaseStore::reclassifyResources()
         if (newPrevalence != resourceStatistic.prevalence)
             setPrevalentResource(resourceStatistic.registrableDomain, newPrevalence);
     }
+
+    if (!m_database.executeCommand(clearPendingClassificationDomainsQuery))
+        RELEASE_LOG_ERROR_IF_ALLOWED(m_sessionID, "%p - ResourceLoadStatisticsDatabaseStore::reclassifyResources failed to clear pending domains, error message: %{private}s", this, m_database.lastErrorMsg());
 }
 
 void ResourceLoadStatisticsDatabaseStore::classifyPrevalentResources()
@@ -1993,6 +2100,9 @@ std::pair<ResourceLoadStatisticsDatabaseStore::AddedRecord, Optional<unsigned>>
 {
     ASSERT(!RunLoop::isMain());
 
+    if (auto domainID = cachedDomainID(domain))
+        return { AddedRecord::No, *domainID };
+
     {
         auto scopedStatement = this->scopedStatement(m_domainIDFromStringStatement, domainIDFromStringQuery, "ensureResourceStatisticsForRegistrableDomain"_s);
         if (!scopedStatement
@@ -2004,6 +2114,7 @@ std::pair<ResourceLoadStatisticsDatabaseStore::AddedRecord, Optional<unsigned>>
 
         if (scopedStatement->step() == SQLITE_ROW) {
             unsigned domainID = scopedStatement->getColumnInt(0);
+            cacheDomainID(domain, domainID);
             return { AddedRecord::No, domainID };
         }
     }
@@ -2022,6 +2133,7 @@ std::pair<ResourceLoadStatisticsDatabaseStore::AddedRecord, Optional<unsigned>>
 
 void ResourceLoadStatisticsDatabaseStore::clearDatabaseContents()
 {
+    clearDomainIDCache();
     m_database.clearAllTables();
 
     if (!createSchema()) {
@@ -2036,7 +2148,9 @@ void ResourceLoadStatisticsDatabaseStore::removeDataForDomain(const RegistrableD
     auto domainIDToRemove = domainID(domain);
     if (!domainIDToRemove)
         return;
-    
+
+    removeCachedDomainID(domain);
+
     auto scopedStatement = this->scopedStatement(m_removeAllDataStatement, removeAllDataQuery, "removeDataForDomain"_s);
     if (!scopedStatement
         || scopedStatement->bindInt(1, *domainIDToRemove) != SQLITE_OK
@@ -2421,6 +2535,8 @@ void ResourceLoadStatisticsDatabaseStore::pruneStatisticsIfNeeded()
 
     auto listToPrune = buildList(WTF::IteratorRange<Vector<unsigned>::iterator>(entriesToPrune.begin(), entriesToPrune.end()));
 
+    clearDomainIDCache();
+
     SQLiteStatement pruneCommand(m_database, makeString("DELETE from ObservedDomains WHERE domainID IN (", listToPrune, ")"));
     if (pruneCommand.prepare() != SQLITE_OK
         || pruneCommand.step() != SQLITE_DONE) {
@@ -34,6 +34,7 @@
 #include <WebCore/SQLiteStatementAutoResetScope.h>
 #include <pal/SessionID.h>
 #include <wtf/CompletionHandler.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/StdSet.h>
 #include <wtf/Vector.h>
 #include <wtf/WorkQueue.h>
@@ -170,6 +171,10 @@ private:
     void insertDomainRelationshipList(const String&, const HashSet<RegistrableDomain>&, unsigned);
     bool relationshipExists(WebCore::SQLiteStatementAutoResetScope&, Optional<unsigned> firstDomainID, const RegistrableDomain& secondDomain) const;
     Optional<unsigned> domainID(const RegistrableDomain&) const;
+    Optional<unsigned> cachedDomainID(const RegistrableDomain&) const;
+    void cacheDomainID(const RegistrableDomain&, unsigned) const;
+    void removeCachedDomainID(const RegistrableDomain&);
+    void clearDomainIDCache();
     bool domainExists(const RegistrableDomain&) const;
     void updateLastSeen(const RegistrableDomain&, WallTime);
     void updateDataRecordsRemoved(const RegistrableDomain&, int);
@@ -203,7 +208,7 @@ private:
         unsigned subframeUnderTopFrameDomainsCount;
         unsigned topFrameUniqueRedirectsToCount;
     };
-    HashMap<unsigned, NotVeryPrevalentResources> findNotVeryPrevalentResources();
+    HashMap<unsigned, NotVeryPrevalentResources> findNotVeryPrevalentResourcesPendingClassification();
 
     bool predicateValueForDomain(WebCore::SQLiteStatementAutoResetScope&, const RegistrableDomain&) const;
 
@@ -227,8 +232,8 @@ private:
     bool isDatabaseStore() const final { return true; }
 
     bool createUniqueIndices();
+    bool createClassificationTriggers();
     bool createSchema();
-    String ensureAndMakeDomainList(const HashSet<RegistrableDomain>&);
     Optional<WallTime> mostRecentUserInteractionTime(const DomainData&);
     
     void removeUnattributed(WebCore::PrivateClickMeasurement&);
@@ -242,6 +247,7 @@ private:
     std::unique_ptr<WebCore::SQLiteStatement> m_insertObservedDomainStatement;
     std::unique_ptr<WebCore::SQLiteStatement> m_insertTopLevelDomainStatement;
     mutable std::unique_ptr<WebCore::SQLiteStatement> m_domainIDFromStringStatement;
+    HashMap<String, std::unique_ptr<WebCore::SQLiteStatement>> m_insertDomainRelationshipStatements;
     mutable std::unique_ptr<WebCore::SQLiteStatement> m_topFrameLinkDecorationsFromExistsStatement;
     mutable std::unique_ptr<WebCore::SQLiteStatement> m_topFrameLoadedThirdPartyScriptsExistsStatement;
     mutable std::unique_ptr<WebCore::SQLiteStatement> m_subframeUnderTopFrameDomainExistsStatement;
@@ -289,6 +295,8 @@ private:
     std::unique_ptr<WebCore::SQLiteStatement> m_removeUnattributedStatement;
     
     PAL::SessionID m_sessionID;
+    mutable HashMap<RegistrableDomain, unsigned> m_domainIDCache;
+    mutable ListHashSet<RegistrableDomain> m_domainIDCacheRecency;
     bool m_isNewResourceLoadStatisticsDatabaseFile { false };
     unsigned m_operatingDatesSize { 0 };
     Optional<OperatingDate> m_longWindowOperatingDate;
@@ -139,6 +139,11 @@ void Download::didReceiveData(uint64_t bytesWritten, uint64_t totalBytesWritten,
     send(Messages::DownloadProxy::DidReceiveData(bytesWritten, totalBytesWritten, totalBytesExpectedToWrite));
 }
 
+void Download::didFinishSegment(uint64_t offset, uint64_t bytesReceived, Seconds duration, unsigned retryCount)
+{
+    m_monitor.downloadSegmentFinished(offset, bytesReceived, duration, retryCount);
+}
+
 void Download::didFinish()
 {
     RELEASE_LOG_IF_ALLOWED("didFinish: (id = %" PRIu64 ")", downloadID().toUInt64());
@@ -91,6 +91,13 @@ void DownloadMonitor::downloadReceivedBytes(uint64_t bytesReceived)
     m_timestamps.append({ MonotonicTime::now(), bytesReceived });
 }
 
+void DownloadMonitor::downloadSegmentFinished(uint64_t offset, uint64_t bytesReceived, Seconds duration, unsigned retryCount)
+{
+    // The bytes of the segments are already counted by downloadReceivedBytes(), this only reports how each connection performed.
+    uint64_t bytesPerSecond = duration > 0_s ? bytesReceived / duration.seconds() : 0;
+    RELEASE_LOG_IF_ALLOWED("downloadSegmentFinished: (id = %" PRIu64 ", offset = %" PRIu64 ", bytes = %" PRIu64 ", bytesPerSecond = %" PRIu64 ", retryCount = %u)", m_download.downloadID().toUInt64(), offset, bytesReceived, bytesPerSecond, retryCount);
+}
+
 void DownloadMonitor::applicationWillEnterForeground()
 {
     RELEASE_LOG_IF_ALLOWED("applicationWillEnterForeground (id = %" PRIu64 ")", m_download.downloadID().toUInt64());
@@ -40,6 +40,7 @@ public:
     void applicationDidEnterBackground();
     void applicationWillEnterForeground();
     void downloadReceivedBytes(uint64_t);
+    void downloadSegmentFinished(uint64_t offset, uint64_t bytesReceived, Seconds duration, unsigned retryCount);
     void timerFired();
 
 private:
@@ -0,0 +1,297 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "DownloadSegment.h"
+
+#include "AuthenticationChallengeDisposition.h"
+#include "Logging.h"
+#include "NetworkLoadParameters.h"
+#include "NetworkSession.h"
+#include "WebErrors.h"
+#include <WebCore/HTTPHeaderNames.h>
+#include <WebCore/ParsedContentRange.h>
+#include <WebCore/ResourceError.h>
+#include <WebCore/ResourceResponse.h>
+#include <WebCore/SharedBuffer.h>
+#include <wtf/RunLoop.h>
+#include <wtf/WorkQueue.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+
+namespace WebKit {
+using namespace WebCore;
+
+static const unsigned maximumRetryCount = 3;
+// The load is suspended when this many received bytes are waiting to be written, and resumed once half of them are.
+static const uint64_t maximumBytesPendingWrite = 4 * MB;
+
+static WorkQueue& downloadSegmentWriteQueue()
+{
+    static auto& queue = WorkQueue::create("com.apple.WebKit.DownloadSegment", WorkQueue::Type::Serial, WorkQueue::QOS::Utility).leakRef();
+    return queue;
+}
+
+DownloadSegment::DownloadSegment(Client& client, NetworkSession& session, const ResourceRequest& request, StoredCredentialsPolicy storedCredentialsPolicy, const String& validator, const String& destinationPath, uint64_t offset, uint64_t length)
+    : m_client(client)
+    , m_session(makeWeakPtr(session))
+    , m_request(request)
+    , m_storedCredentialsPolicy(storedCredentialsPolicy)
+    , m_validator(validator)
+    , m_destinationPath(destinationPath)
+    , m_offset(offset)
+    , m_length(length)
+{
+    ASSERT(m_length);
+}
+
+DownloadSegment::~DownloadSegment()
+{
+    cancelDataTask();
+
+    if (FileSystem::isHandleValid(m_fileHandle)) {
+        // Pending writes are done before the file is closed.
+        downloadSegmentWriteQueue().dispatch([fileHandle = m_fileHandle]() mutable {
+            FileSystem::closeFile(fileHandle);
+        });
+    }
+}
+
+void DownloadSegment::start()
+{
+    ASSERT(!m_task);
+
+    // The destination is created by the download and other segments write to it concurrently, so it must not be truncated here.
+    m_fileHandle = FileSystem::openFile(m_destinationPath, FileSystem::FileOpenMode::ReadWrite);
+    if (!FileSystem::isHandleValid(m_fileHandle)) {
+        didFail(downloadNetworkError(m_request.url(), "Failed to open the download destination"_s));
+        return;
+    }
+
+    m_startTime = MonotonicTime::now();
+    startDataTask();
+}
+
+void DownloadSegment::startDataTask()
+{
+    if (!m_session) {
+        didFail(cancelledError(m_request));
+        return;
+    }
+
+    auto request = m_request;
+    request.setHTTPHeaderField(HTTPHeaderName::Range, makeString("bytes=", m_offset + m_bytesReceived, '-', m_offset + m_length - 1));
+    if (!m_validator.isEmpty())
+        request.setHTTPHeaderField(HTTPHeaderName::IfRange, m_validator);
+    // Ranges refer to the bytes of the encoded representation, which must match the one of the other segments.
+    request.setHTTPHeaderField(HTTPHeaderName::AcceptEncoding, "identity"_s);
+
+    NetworkLoadParameters parameters;
+    parameters.request = WTFMove(request);
+    parameters.storedCredentialsPolicy = m_storedCredentialsPolicy;
+    parameters.contentSniffingPolicy = ContentSniffingPolicy::DoNotSniffContent;
+    parameters.contentEncodingSniffingPolicy = ContentEncodingSniffingPolicy::DoNotSniff;
+
+    m_task = NetworkDataTask::create(*m_session, *this, parameters);
+    m_task->resume();
+}
+
+void DownloadSegment::cancelDataTask()
+{
+    if (auto task = std::exchange(m_task, nullptr)) {
+        task->clearClient();
+        task->cancel();
+    }
+}
+
+void DownloadSegment::willPerformHTTPRedirection(ResourceResponse&&, ResourceRequest&& request, RedirectCompletionHandler&& completionHandler)
+{
+    completionHandler(WTFMove(request));
+}
+
+void DownloadSegment::didReceiveChallenge(AuthenticationChallenge&&, NegotiatedLegacyTLS, ChallengeCompletionHandler&& completionHandler)
+{
+    // Credentials used by the download are in the credential storage already. There is no UI to ask for new ones.
+    completionHandler(AuthenticationChallengeDisposition::PerformDefaultHandling, { });
+}
+
+void DownloadSegment::didReceiveResponse(ResourceResponse&& response, NegotiatedLegacyTLS, ResponseCompletionHandler&& completionHandler)
+{
+    auto& contentRange = response.contentRange();
+    bool isExpectedRange = response.httpStatusCode() == 206
+        && contentRange.isValid()
+        && static_cast<uint64_t>(contentRange.firstBytePosition()) == m_offset + m_bytesReceived
+        && static_cast<uint64_t>(contentRange.lastBytePosition()) == m_offset + m_length - 1;
+    auto contentEncoding = response.httpHeaderField(HTTPHeaderName::ContentEncoding);
+    if (!isExpectedRange || (!contentEncoding.isEmpty() && !equalLettersIgnoringASCIICase(contentEncoding, "identity"))) {
+        // The resource changed or the server doesn't honor the range anymore. Retrying won't help.
+        RELEASE_LOG_ERROR(Network, "%p - DownloadSegment::didReceiveResponse: unexpected response (statusCode = %d, offset = %" PRIu64 ")", this, response.httpStatusCode(), m_offset);
+        cancelDataTask();
+        completionHandler(PolicyAction::Ignore);
+        didFail(downloadNetworkError(response.url(), "Unexpected response to a download range request"_s));
+        return;
+    }
+    completionHandler(PolicyAction::Use);
+}
+
+void DownloadSegment::didReceiveData(Ref<SharedBuffer>&& buffer)
+{
+    if (m_didFail)
+        return;
+
+    uint64_t remainingBytes = m_length - m_bytesReceived;
+    uint64_t size = std::min<uint64_t>(buffer->size(), remainingBytes);
+    if (!size)
+        return;
+
+    uint64_t fileOffset = m_offset + m_bytesReceived;
+    m_bytesReceived += size;
+    m_bytesPendingWrite += size;
+    suspendDataTaskIfNeeded();
+
+    downloadSegmentWriteQueue().dispatch([weakThis = makeWeakPtr(*this), fileHandle = m_fileHandle, fileOffset, size, buffer = WTFMove(buffer)]() mutable {
+        bool success = FileSystem::seekFile(fileHandle, fileOffset, FileSystem::FileSeekOrigin::Beginning) != -1
+            && FileSystem::writeToFile(fileHandle, buffer->data(), size) == static_cast<int>(size);
+        RunLoop::main().dispatch([weakThis = WTFMove(weakThis), size, success] {
+            if (weakThis)
+                weakThis->didWriteData(size, success);
+        });
+    });
+}
+
+void DownloadSegment::suspendDataTaskIfNeeded()
+{
+    if (m_task && m_task->state() == NetworkDataTask::State::Running && m_bytesPendingWrite >= maximumBytesPendingWrite)
+        m_task->suspend();
+}
+
+void DownloadSegment::resumeDataTaskIfNeeded()
+{
+    if (m_task && m_task->state() == NetworkDataTask::State::Suspended && m_bytesPendingWrite <= maximumBytesPendingWrite / 2)
+        m_task->resume();
+}
+
+void DownloadSegment::didWriteData(uint64_t bytesWritten, bool success)
+{
+    ASSERT(m_bytesPendingWrite >= bytesWritten);
+    m_bytesPendingWrite -= bytesWritten;
+    if (m_didFail)
+        return;
+
+    if (!success) {
+        cancelDataTask();
+        didFail(downloadNetworkError(m_request.url(), "Failed to write to the download destination"_s));
+        return;
+    }
+
+    m_bytesWritten += bytesWritten;
+    bool isComplete = m_bytesWritten == m_length;
+    if (isComplete)
+        m_endTime = MonotonicTime::now();
+
+    resumeDataTaskIfNeeded();
+
+    m_client.downloadSegmentDidWriteData(*this, bytesWritten);
+    // Nothing can be done after this since the client may destroy the segment.
+}
+
+void DownloadSegment::didCompleteWithError(const ResourceError& error, const NetworkLoadMetrics&)
+{
+    m_task = nullptr;
+    if (m_didFail)
+        return;
+
+    if (!error.isNull()) {
+        retryOrFail(error);
+        return;
+    }
+
+    if (m_bytesReceived < m_length) {
+        retryOrFail(downloadNetworkError(m_request.url(), "Download range response ended early"_s));
+        return;
+    }
+
+    // Report completion once the pending writes are done.
+    downloadSegmentWriteQueue().dispatch([weakThis = makeWeakPtr(*this)]() mutable {
+        RunLoop::main().dispatch([weakThis = WTFMove(weakThis)] {
+            if (weakThis)
+                weakThis->didFinishWriting();
+        });
+    });
+}
+
+void DownloadSegment::didFinishWriting()
+{
+    if (m_didFail)
+        return;
+
+    ASSERT(m_bytesWritten == m_length);
+    m_client.downloadSegmentDidFinish(*this);
+}
+
+void DownloadSegment::retryOrFail(const ResourceError& error)
+{
+    if (error.isCancellation() || m_retryCount >= maximumRetryCount) {
+        didFail(error);
+        return;
+    }
+
+    ++m_retryCount;
+    RELEASE_LOG(Network, "%p - DownloadSegment::retryOrFail: resuming segment (offset = %" PRIu64 ", bytesReceived = %" PRIu64 ", retryCount = %u)", this, m_offset, m_bytesReceived, m_retryCount);
+    startDataTask();
+}
+
+void DownloadSegment::didFail(const ResourceError& error)
+{
+    if (m_didFail)
+        return;
+
+    m_didFail = true;
+
+    // The client destroys all the segments when one of them fails, and this can happen while it is still starting them.
+    RunLoop::main().dispatch([weakThis = makeWeakPtr(*this), error]() mutable {
+        if (weakThis)
+            weakThis->m_client.downloadSegmentDidFail(*weakThis, error);
+    });
+}
+
+void DownloadSegment::wasBlocked()
+{
+    m_task = nullptr;
+    didFail(blockedError(m_request));
+}
+
+void DownloadSegment::cannotShowURL()
+{
+    m_task = nullptr;
+    didFail(cannotShowURLError(m_request));
+}
+
+void DownloadSegment::wasBlockedByRestrictions()
+{
+    m_task = nullptr;
+    didFail(wasBlockedByRestrictionsError(m_request));
+}
+
+} // namespace WebKit
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "NetworkDataTask.h"
+#include <WebCore/ResourceRequest.h>
+#include <WebCore/StoredCredentialsPolicy.h>
+#include <wtf/FileSystem.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/WeakPtr.h>
+
+namespace WebKit {
+
+class NetworkSession;
+
+// Loads the byte range [offset, offset + length) of a download with a Range request and writes it
+// at the same offset of the destination file. The range is requested again from where it stopped
+// when the load fails, up to a few times.
+class DownloadSegment final : public NetworkDataTaskClient, public CanMakeWeakPtr<DownloadSegment> {
+    WTF_MAKE_NONCOPYABLE(DownloadSegment); WTF_MAKE_FAST_ALLOCATED;
+public:
+    class Client {
+    public:
+        virtual ~Client() = default;
+
+        // The segment may be destroyed by these.
+        virtual void downloadSegmentDidWriteData(DownloadSegment&, uint64_t bytesWritten) = 0;
+        virtual void downloadSegmentDidFinish(DownloadSegment&) = 0;
+        virtual void downloadSegmentDidFail(DownloadSegment&, const WebCore::ResourceError&) = 0;
+    };
+
+    // The validator is an entity tag or a last modified date sent as If-Range, so the segments all come from the same representation.
+    DownloadSegment(Client&, NetworkSession&, const WebCore::ResourceRequest&, WebCore::StoredCredentialsPolicy, const String& validator, const String& destinationPath, uint64_t offset, uint64_t length);
+    ~DownloadSegment();
+
+    void start();
+
+    uint64_t offset() const { return m_offset; }
+    uint64_t length() const { return m_length; }
+    uint64_t bytesReceived() const { return m_bytesReceived; }
+    unsigned retryCount() const { return m_retryCount; }
+    Seconds duration() const { return m_endTime - m_startTime; }
+
+private:
+    // NetworkDataTaskClient.
+    void willPerformHTTPRedirection(WebCore::ResourceResponse&&, WebCore::ResourceRequest&&, RedirectCompletionHandler&&) final;
+    void didReceiveChallenge(WebCore::AuthenticationChallenge&&, NegotiatedLegacyTLS, ChallengeCompletionHandler&&) final;
+    void didReceiveResponse(WebCore::ResourceResponse&&, NegotiatedLegacyTLS, ResponseCompletionHandler&&) final;
+    void didReceiveData(Ref<WebCore::SharedBuffer>&&) final;
+    void didCompleteWithError(const WebCore::ResourceError&, const WebCore::NetworkLoadMetrics&) final;
+    void didSendData(uint64_t, uint64_t) final { }
+    void wasBlocked() final;
+    void cannotShowURL() final;
+    void wasBlockedByRestrictions() final;
+
+    void startDataTask();
+    void cancelDataTask();
+    void retryOrFail(const WebCore::ResourceError&);
+    void didFail(const WebCore::ResourceError&);
+    void didWriteData(uint64_t bytesWritten, bool success);
+    void suspendDataTaskIfNeeded();
+    void resumeDataTaskIfNeeded();
+    void didFinishWriting();
+
+    Client& m_client;
+    WeakPtr<NetworkSession> m_session;
+    WebCore::ResourceRequest m_request;
+    WebCore::StoredCredentialsPolicy m_storedCredentialsPolicy;
+    String m_validator;
+    String m_destinationPath;
+    const uint64_t m_offset;
+    const uint64_t m_length;
+
+    RefPtr<NetworkDataTask> m_task;
+    FileSystem::PlatformFileHandle m_fileHandle { FileSystem::invalidPlatformFileHandle };
+    uint64_t m_bytesReceived { 0 };
+    uint64_t m_bytesWritten { 0 };
+    uint64_t m_bytesPendingWrite { 0 };
+    unsigned m_retryCount { 0 };
+    bool m_didFail { false };
+    MonotonicTime m_startTime;
+    MonotonicTime m_endTime;
+};
+
+} // namespace WebKit
@@ -70,6 +70,7 @@
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/SameSiteInfo.h>
 #include <WebCore/SecurityPolicy.h>
+#include <wtf/text/StringBuilder.h>
 
 #if ENABLE(APPLE_PAY_REMOTE_UI)
 #include "WebPaymentCoordinatorProxyMessages.h"
@@ -79,6 +80,10 @@
 #include "LegacyCustomProtocolManager.h"
 #endif
 
+#if USE(SOUP)
+#include "NetworkSessionSoup.h"
+#endif
+
 #undef RELEASE_LOG_IF_ALLOWED
 #define RELEASE_LOG_IF_ALLOWED(channel, fmt, ...) RELEASE_LOG_IF(m_sessionID.isAlwaysOnLoggingAllowed(), channel, "%p - [webProcessIdentifier=%" PRIu64 "] NetworkConnectionToWebProcess::" fmt, this, webProcessIdentifier().toUInt64(), ##__VA_ARGS__)
 
@@ -139,6 +144,9 @@ NetworkConnectionToWebProcess::~NetworkConnectionToWebProcess()
 #if HAVE(COOKIE_CHANGE_LISTENER_API)
     if (auto* networkStorageSession = storageSession())
         networkStorageSession->stopListeningForCookieChangeNotifications(*this, m_hostsWithCookieListeners);
+#elif USE(SOUP)
+    if (auto* session = networkSession())
+        static_cast<NetworkSessionSoup&>(*session).stopListeningForCookieChangeNotifications(*this, m_hostsWithCookieListeners);
 #endif
 
 #if USE(LIBWEBRTC)
@@ -384,6 +392,14 @@ void NetworkConnectionToWebProcess::removeSocketChannel(WebSocketIdentifier iden
     m_networkSocketChannels.remove(identifier);
 }
 
+String NetworkConnectionToWebProcess::webSocketStatisticsDescription() const
+{
+    StringBuilder result;
+    for (auto& channel : m_networkSocketChannels.values())
+        result.append(channel->statisticsDescription());
+    return result.toString();
+}
+
 void NetworkConnectionToWebProcess::cleanupForSuspension(Function<void()>&& completionHandler)
 {
 #if USE(LIBWEBRTC)
@@ -723,6 +739,13 @@ void NetworkConnectionToWebProcess::domCookiesForHost(const String& host, bool s
         m_hostsWithCookieListeners.add(host);
         networkStorageSession->startListeningForCookieChangeNotifications(*this, host);
     }
+#elif USE(SOUP)
+    if (subscribeToCookieChangeNotifications) {
+        ASSERT(!m_hostsWithCookieListeners.contains(host));
+        m_hostsWithCookieListeners.add(host);
+        if (auto* session = networkSession())
+            static_cast<NetworkSessionSoup&>(*session).startListeningForCookieChangeNotifications(*this, host);
+    }
 #else
     UNUSED_PARAM(subscribeToCookieChangeNotifications);
 #endif
@@ -730,15 +753,28 @@ void NetworkConnectionToWebProcess::domCookiesForHost(const String& host, bool s
     completionHandler(networkStorageSession->domCookiesForHost(host));
 }
 
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
+void NetworkConnectionToWebProcess::prefetchDOMCookiesForHost(const String& host, CompletionHandler<void(Optional<Vector<WebCore::Cookie>>&&)>&& completionHandler)
+{
+    bool subscribeToCookieChangeNotifications = true;
+    domCookiesForHost(host, subscribeToCookieChangeNotifications, [completionHandler = WTFMove(completionHandler)](auto& cookies) mutable {
+        completionHandler(Vector<WebCore::Cookie> { cookies });
+    });
+}
+
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
 
 void NetworkConnectionToWebProcess::unsubscribeFromCookieChangeNotifications(const HashSet<String>& hosts)
 {
     bool removed = m_hostsWithCookieListeners.remove(hosts.begin(), hosts.end());
     ASSERT_UNUSED(removed, removed);
 
+#if HAVE(COOKIE_CHANGE_LISTENER_API)
     if (auto* networkStorageSession = storageSession())
         networkStorageSession->stopListeningForCookieChangeNotifications(*this, hosts);
+#else
+    if (auto* session = networkSession())
+        static_cast<NetworkSessionSoup&>(*session).stopListeningForCookieChangeNotifications(*this, hosts);
+#endif
 }
 
 void NetworkConnectionToWebProcess::cookiesAdded(const String& host, const Vector<WebCore::Cookie>& cookies)
@@ -159,6 +159,7 @@ public:
     Vector<RefPtr<WebCore::BlobDataFileReference>> resolveBlobReferences(const NetworkResourceLoadParameters&);
 
     void removeSocketChannel(WebCore::WebSocketIdentifier);
+    String webSocketStatisticsDescription() const;
 
     WebCore::ProcessIdentifier webProcessIdentifier() const { return m_webProcessIdentifier; }
 
@@ -174,6 +175,13 @@ public:
 
     void cookieAcceptPolicyChanged(WebCore::HTTPCookieAcceptPolicy);
 
+#if !HAVE(COOKIE_CHANGE_LISTENER_API) && USE(SOUP)
+    // Called by NetworkSessionSoup.
+    void cookiesAdded(const String& host, const Vector<WebCore::Cookie>&);
+    void cookiesDeleted(const String& host, const Vector<WebCore::Cookie>&);
+    void allCookiesDeleted();
+#endif
+
     void broadcastConsoleMessage(JSC::MessageSource, JSC::MessageLevel, const String& message);
 
 private:
@@ -284,6 +292,7 @@ private:
     uint64_t nextMessageBatchIdentifier(Function<void()>&&);
 
     void domCookiesForHost(const String& host, bool subscribeToCookieChangeNotifications, CompletionHandler<void(const Vector<WebCore::Cookie>&)>&&);
+    void prefetchDOMCookiesForHost(const String& host, CompletionHandler<void(Optional<Vector<WebCore::Cookie>>&&)>&&);
 
 #if HAVE(COOKIE_CHANGE_LISTENER_API)
     void unsubscribeFromCookieChangeNotifications(const HashSet<String>& hosts);
@@ -292,6 +301,8 @@ private:
     void cookiesAdded(const String& host, const Vector<WebCore::Cookie>&) final;
     void cookiesDeleted(const String& host, const Vector<WebCore::Cookie>&) final;
     void allCookiesDeleted() final;
+#elif USE(SOUP)
+    void unsubscribeFromCookieChangeNotifications(const HashSet<String>& hosts);
 #endif
 
     struct ResourceNetworkActivityTracker {
@@ -359,7 +370,7 @@ private:
 #if ENABLE(WEB_RTC)
     NetworkMDNSRegister m_mdnsRegister;
 #endif
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
     HashSet<String> m_hostsWithCookieListeners;
 #endif
 
@@ -91,6 +91,8 @@ public:
     virtual void cancel() = 0;
     virtual void resume() = 0;
     virtual void invalidateAndCancel() = 0;
+    // Stops delivering data until resume() is called. Ports that can't pause a load keep the task running.
+    virtual void suspend() { }
 
     void didReceiveResponse(WebCore::ResourceResponse&&, NegotiatedLegacyTLS, ResponseCompletionHandler&&);
     bool shouldCaptureExtraNetworkLoadMetrics() const;
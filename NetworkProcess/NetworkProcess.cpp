@@ -90,6 +90,7 @@
 #include <wtf/UUID.h>
 #include <wtf/UniqueRef.h>
 #include <wtf/text/AtomString.h>
+#include <wtf/text/StringBuilder.h>
 
 #if ENABLE(SEC_ITEM_SHIM)
 #include "SecItemShim.h"
@@ -98,6 +99,10 @@
 #include "NetworkCache.h"
 #include "NetworkCacheCoders.h"
 
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+#include "NetworkCacheSpeculativeLoadManager.h"
+#endif
+
 #if PLATFORM(COCOA)
 #include "LaunchServicesDatabaseObserver.h"
 #include "NetworkSessionCocoa.h"
@@ -301,8 +306,8 @@ void NetworkProcess::lowMemoryHandler(Critical critical)
 
     WTF::releaseFastMallocFreeMemory();
 
-    forEachNetworkSession([](auto& networkSession) {
-        networkSession.clearPrefetchCache();
+    forEachNetworkSession([critical](auto& networkSession) {
+        networkSession.prefetchCache().handleMemoryPressure(critical == Critical::Yes);
     });
 
 #if ENABLE(SERVICE_WORKER)
@@ -335,6 +340,11 @@ void NetworkProcess::initializeNetworkProcess(NetworkProcessCreationParameters&&
 
     setCacheModel(parameters.cacheModel);
 
+    if (!parameters.sharedNetworkCacheBlobsDirectory.isEmpty()) {
+        SandboxExtension::consumePermanently(parameters.sharedNetworkCacheBlobsDirectoryExtensionHandle);
+        m_sharedNetworkCacheBlobsDirectory = parameters.sharedNetworkCacheBlobsDirectory;
+    }
+
     setPrivateClickMeasurementEnabled(parameters.enablePrivateClickMeasurement);
     setPrivateClickMeasurementDebugMode(parameters.enablePrivateClickMeasurementDebugMode);
 
@@ -1577,6 +1587,12 @@ void NetworkProcess::deleteWebsiteData(PAL::SessionID sessionID, OptionSet<Websi
     bool clearServiceWorkers = websiteDataTypes.contains(WebsiteDataType::DOMCache) || websiteDataTypes.contains(WebsiteDataType::ServiceWorkerRegistrations);
     if (clearServiceWorkers && !sessionID.isEphemeral())
         swServerForSession(sessionID).clearAll([clearTasksHandler] { });
+
+    // The cache-first routes point to CacheStorage caches of registrations that are being removed.
+    if (clearServiceWorkers) {
+        if (auto* networkSession = this->networkSession(sessionID))
+            networkSession->clearServiceWorkerCacheFirstRoutes();
+    }
 #endif
 
 #if ENABLE(RESOURCE_LOAD_STATISTICS)
@@ -1596,6 +1612,19 @@ void NetworkProcess::deleteWebsiteData(PAL::SessionID sessionID, OptionSet<Websi
     }
 #endif
 
+    if (websiteDataTypes.contains(WebsiteDataType::DiskCache)) {
+        if (auto* networkSession = this->networkSession(sessionID)) {
+            networkSession->clearPrefetchCache();
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+            // The subresource origins learned for preconnecting reveal the sites that were visited.
+            if (auto* cache = networkSession->cache()) {
+                if (auto* speculativeLoadManager = cache->speculativeLoadManager())
+                    speculativeLoadManager->clearSubresourceOriginScores();
+            }
+#endif
+        }
+    }
+
     if (websiteDataTypes.contains(WebsiteDataType::DiskCache) && !sessionID.isEphemeral())
         clearDiskCache(modifiedSince, [clearTasksHandler = WTFMove(clearTasksHandler)] { });
 
@@ -1694,8 +1723,29 @@ void NetworkProcess::deleteWebsiteDataForOrigins(PAL::SessionID sessionID, Optio
         for (auto& originData : originDatas)
             server.clear(originData, [clearTasksHandler] { });
     }
+
+    if (clearServiceWorkers) {
+        if (auto* networkSession = this->networkSession(sessionID)) {
+            for (auto& originData : originDatas)
+                networkSession->removeServiceWorkerCacheFirstRoutes(originData);
+        }
+    }
 #endif
 
+    // Prefetched responses are short lived and subresource origins are learned per top-level domain, drop all of
+    // them rather than looking up the origins.
+    if (websiteDataTypes.contains(WebsiteDataType::DiskCache)) {
+        if (auto* networkSession = this->networkSession(sessionID)) {
+            networkSession->clearPrefetchCache();
+#if ENABLE(NETWORK_CACHE_SPECULATIVE_REVALIDATION)
+            if (auto* cache = networkSession->cache()) {
+                if (auto* speculativeLoadManager = cache->speculativeLoadManager())
+                    speculativeLoadManager->clearSubresourceOriginScores();
+            }
+#endif
+        }
+    }
+
     if (websiteDataTypes.contains(WebsiteDataType::DiskCache) && !sessionID.isEphemeral()) {
         forEachNetworkSession([originDatas, &clearTasksHandler](auto& session) {
             clearDiskCacheEntries(session.cache(), originDatas, [clearTasksHandler] { });
@@ -1907,6 +1957,8 @@ void NetworkProcess::deleteAndRestrictWebsiteDataForRegistrableDomains(PAL::Sess
                     continue;
                 callbackAggregator->m_domains.add(RegistrableDomain::uncheckedCreateFromHost(securityOrigin.host));
                 swServerForSession(sessionID).clear(securityOrigin, [callbackAggregator] { });
+                if (auto* networkSession = this->networkSession(sessionID))
+                    networkSession->removeServiceWorkerCacheFirstRoutes(securityOrigin);
             }
         });
     }
@@ -2545,6 +2597,16 @@ void NetworkProcess::dumpPrivateClickMeasurement(PAL::SessionID sessionID, Compl
     completionHandler({ });
 }
 
+void NetworkProcess::dumpWebSocketStatistics(PAL::SessionID sessionID, CompletionHandler<void(String)>&& completionHandler)
+{
+    StringBuilder result;
+    for (auto& connection : m_webProcessConnections.values()) {
+        if (connection->sessionID() == sessionID)
+            result.append(connection->webSocketStatisticsDescription());
+    }
+    completionHandler(result.toString());
+}
+
 void NetworkProcess::clearPrivateClickMeasurement(PAL::SessionID sessionID, CompletionHandler<void()>&& completionHandler)
 {
     if (auto* session = networkSession(sessionID))
@@ -2657,6 +2719,14 @@ void NetworkProcess::resetServiceWorkerFetchTimeoutForTesting(CompletionHandler<
     completionHandler();
 }
 
+#if ENABLE(SERVICE_WORKER)
+void NetworkProcess::setServiceWorkerCacheFirstRoutes(PAL::SessionID sessionID, URL&& scopeURL, String&& cacheName, Vector<String>&& urlPrefixes)
+{
+    if (auto* session = networkSession(sessionID))
+        session->setServiceWorkerCacheFirstRoutes(scopeURL, { WTFMove(cacheName), WTFMove(urlPrefixes) });
+}
+#endif
+
 static constexpr auto delayMax = 100_ms;
 static constexpr auto delayMin = 10_ms;
 Seconds NetworkProcess::randomClosedPortDelay()
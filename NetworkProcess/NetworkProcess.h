@@ -184,6 +184,7 @@ public:
     void resume();
 
     CacheModel cacheModel() const { return m_cacheModel; }
+    const String& sharedNetworkCacheBlobsDirectory() const { return m_sharedNetworkCacheBlobsDirectory; }
 
     // Diagnostic messages logging.
     void logDiagnosticMessage(WebPageProxyIdentifier, const String& message, const String& description, WebCore::ShouldSample);
@@ -338,6 +339,7 @@ public:
 
     void storePrivateClickMeasurement(PAL::SessionID, WebCore::PrivateClickMeasurement&&);
     void dumpPrivateClickMeasurement(PAL::SessionID, CompletionHandler<void(String)>&&);
+    void dumpWebSocketStatistics(PAL::SessionID, CompletionHandler<void(String)>&&);
     void clearPrivateClickMeasurement(PAL::SessionID, CompletionHandler<void()>&&);
     void setPrivateClickMeasurementOverrideTimerForTesting(PAL::SessionID, bool value, CompletionHandler<void()>&&);
     void markAttributedPrivateClickMeasurementsAsExpiredForTesting(PAL::SessionID, CompletionHandler<void()>&&);
@@ -358,6 +360,9 @@ public:
     void setServiceWorkerFetchTimeoutForTesting(Seconds, CompletionHandler<void()>&&);
     void resetServiceWorkerFetchTimeoutForTesting(CompletionHandler<void()>&&);
     Seconds serviceWorkerFetchTimeout() const { return m_serviceWorkerFetchTimeout; }
+#if ENABLE(SERVICE_WORKER)
+    void setServiceWorkerCacheFirstRoutes(PAL::SessionID, URL&& scopeURL, String&& cacheName, Vector<String>&& urlPrefixes);
+#endif
 
     static Seconds randomClosedPortDelay();
 
@@ -531,6 +536,7 @@ private:
 
     bool m_hasSetCacheModel { false };
     CacheModel m_cacheModel { CacheModel::DocumentViewer };
+    String m_sharedNetworkCacheBlobsDirectory;
     bool m_suppressMemoryPressureHandler { false };
     String m_uiProcessBundleIdentifier;
     DownloadManager m_downloadManager;
@@ -50,6 +50,8 @@ void NetworkProcessCreationParameters::encode(IPC::Encoder& encoder) const
     encoder << tempDirectoryExtensionHandle;
 #endif
     encoder << shouldSuppressMemoryPressureHandler;
+    encoder << sharedNetworkCacheBlobsDirectory;
+    encoder << sharedNetworkCacheBlobsDirectoryExtensionHandle;
     encoder << urlSchemesRegisteredForCustomProtocols;
 #if PLATFORM(COCOA)
     encoder << uiProcessBundleIdentifier;
@@ -106,6 +108,14 @@ bool NetworkProcessCreationParameters::decode(IPC::Decoder& decoder, NetworkProc
 #endif
     if (!decoder.decode(result.shouldSuppressMemoryPressureHandler))
         return false;
+    if (!decoder.decode(result.sharedNetworkCacheBlobsDirectory))
+        return false;
+
+    Optional<SandboxExtension::Handle> sharedNetworkCacheBlobsDirectoryExtensionHandle;
+    decoder >> sharedNetworkCacheBlobsDirectoryExtensionHandle;
+    if (!sharedNetworkCacheBlobsDirectoryExtensionHandle)
+        return false;
+    result.sharedNetworkCacheBlobsDirectoryExtensionHandle = WTFMove(*sharedNetworkCacheBlobsDirectoryExtensionHandle);
     if (!decoder.decode(result.urlSchemesRegisteredForCustomProtocols))
         return false;
 #if PLATFORM(COCOA)
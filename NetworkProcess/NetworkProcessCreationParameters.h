@@ -62,6 +62,10 @@ struct NetworkProcessCreationParameters {
 #endif
     bool shouldSuppressMemoryPressureHandler { false };
 
+    // Network caches of all the sessions store their resource bodies here when set, so identical bodies are kept once on disk.
+    String sharedNetworkCacheBlobsDirectory;
+    SandboxExtension::Handle sharedNetworkCacheBlobsDirectoryExtensionHandle;
+
     Vector<String> urlSchemesRegisteredForCustomProtocols;
 
 #if PLATFORM(COCOA)
@@ -587,7 +587,13 @@ void NetworkResourceLoader::didReceiveResponse(ResourceResponse&& receivedRespon
     if (shouldCaptureExtraNetworkLoadMetrics() && m_networkLoadChecker) {
         auto information = m_networkLoadChecker->takeNetworkLoadInformation();
         information.response = m_response;
-        m_connection->addNetworkLoadInformation(identifier(), WTFMove(information));
+        // Asynchronous loads hand the information to the web process ahead of the response so the
+        // inspector doesn't need to ask for it synchronously. Synchronous loads can't, since the web
+        // process is blocked waiting for the reply.
+        if (isSynchronous())
+            m_connection->addNetworkLoadInformation(identifier(), WTFMove(information));
+        else
+            send(Messages::WebResourceLoader::DidReceiveNetworkLoadInformation(information.response, information.transactions));
     }
 
     // For multipart/x-mixed-replace didReceiveResponseAsync gets called multiple times and buffering would require special handling.
@@ -704,8 +710,12 @@ void NetworkResourceLoader::didFinishLoading(const NetworkLoadMetrics& networkLo
 {
     RELEASE_LOG_IF_ALLOWED("didFinishLoading: (numBytesReceived=%zd, hasCacheEntryForValidation=%d)", m_numBytesReceived, !!m_cacheEntryForValidation);
 
-    if (shouldCaptureExtraNetworkLoadMetrics())
-        m_connection->addNetworkLoadInformationMetrics(identifier(), networkLoadMetrics);
+    if (shouldCaptureExtraNetworkLoadMetrics()) {
+        if (isSynchronous())
+            m_connection->addNetworkLoadInformationMetrics(identifier(), networkLoadMetrics);
+        else
+            send(Messages::WebResourceLoader::DidReceiveNetworkLoadInformationMetrics(networkLoadMetrics));
+    }
 
     if (m_cacheEntryForValidation) {
         // 304 Not Modified
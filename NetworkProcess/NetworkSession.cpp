@@ -40,6 +40,7 @@
 #include "WebSocketTask.h"
 #include <WebCore/CookieJar.h>
 #include <WebCore/ResourceRequest.h>
+#include <WebCore/SecurityOriginData.h>
 
 #if PLATFORM(COCOA)
 #include "NetworkSessionCocoa.h"
@@ -382,4 +383,73 @@ void NetworkSession::unregisterNetworkDataTask(NetworkDataTask& task)
     m_dataTaskSet.remove(task);
 }
 
+#if ENABLE(SERVICE_WORKER)
+void NetworkSession::setServiceWorkerCacheFirstRoutes(const URL& scopeURL, ServiceWorkerCacheFirstRoutes&& routes)
+{
+    // A registration may only route requests for its own origin.
+    auto scopeOrigin = WebCore::SecurityOriginData::fromURL(scopeURL);
+    routes.urlPrefixes.removeAllMatching([&](auto& prefix) {
+        URL prefixURL { URL { }, prefix };
+        return !prefixURL.isValid() || WebCore::SecurityOriginData::fromURL(prefixURL) != scopeOrigin;
+    });
+
+    if (routes.cacheName.isEmpty() || routes.urlPrefixes.isEmpty()) {
+        m_serviceWorkerCacheFirstRoutes.remove(scopeURL.string());
+        return;
+    }
+    m_serviceWorkerCacheFirstRoutes.set(scopeURL.string(), WTFMove(routes));
+}
+
+void NetworkSession::removeServiceWorkerCacheFirstRoutes(const URL& scopeURL)
+{
+    m_serviceWorkerCacheFirstRoutes.remove(scopeURL.string());
+}
+
+void NetworkSession::removeServiceWorkerCacheFirstRoutes(const WebCore::SecurityOriginData& origin)
+{
+    m_serviceWorkerCacheFirstRoutes.removeIf([&](auto& entry) {
+        return WebCore::SecurityOriginData::fromURL(URL { URL { }, entry.key }) == origin;
+    });
+}
+
+// A prefix matches whole path segments: "/static" matches "/static" and "/static/app.js", but not "/staticfiles".
+static bool urlMatchesRoutePrefix(const String& url, const String& prefix)
+{
+    if (!url.startsWith(prefix))
+        return false;
+    if (url.length() == prefix.length() || prefix.endsWith('/'))
+        return true;
+    auto nextCharacter = url[prefix.length()];
+    return nextCharacter == '/' || nextCharacter == '?' || nextCharacter == '#';
+}
+
+const String* NetworkSession::serviceWorkerCacheFirstRouteCacheName(const URL& scopeURL, WebCore::ServiceWorkerRegistrationIdentifier registrationIdentifier, WebCore::ServiceWorkerIdentifier workerIdentifier, const WebCore::ResourceRequest& request)
+{
+    auto iterator = m_serviceWorkerCacheFirstRoutes.find(scopeURL.string());
+    if (iterator == m_serviceWorkerCacheFirstRoutes.end())
+        return nullptr;
+
+    // A new worker may store its responses differently, or a new registration for the same scope may belong to someone else.
+    auto& routes = iterator->value;
+    if (!routes.registrationIdentifier) {
+        routes.registrationIdentifier = registrationIdentifier;
+        routes.workerIdentifier = workerIdentifier;
+    } else if (*routes.registrationIdentifier != registrationIdentifier || *routes.workerIdentifier != workerIdentifier) {
+        m_serviceWorkerCacheFirstRoutes.remove(iterator);
+        return nullptr;
+    }
+
+    // Only simple reads can be served from CacheStorage, anything else has to go through the fetch event.
+    if (request.httpMethod() != "GET" || request.hasHTTPHeaderField(WebCore::HTTPHeaderName::Range))
+        return nullptr;
+
+    auto& url = request.url().string();
+    for (auto& prefix : iterator->value.urlPrefixes) {
+        if (urlMatchesRoutePrefix(url, prefix))
+            return &iterator->value.cacheName;
+    }
+    return nullptr;
+}
+#endif
+
 } // namespace WebKit
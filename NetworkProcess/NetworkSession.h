@@ -33,6 +33,7 @@
 #include <WebCore/NetworkStorageSession.h>
 #include <WebCore/PrivateClickMeasurement.h>
 #include <WebCore/RegistrableDomain.h>
+#include <WebCore/ServiceWorkerTypes.h>
 #include <pal/SessionID.h>
 #include <wtf/HashSet.h>
 #include <wtf/Ref.h>
@@ -148,6 +149,20 @@ public:
 #if ENABLE(SERVICE_WORKER)
     void addSoftUpdateLoader(std::unique_ptr<ServiceWorkerSoftUpdateLoader>&& loader) { m_softUpdateLoaders.add(WTFMove(loader)); }
     void removeSoftUpdateLoader(ServiceWorkerSoftUpdateLoader* loader) { m_softUpdateLoaders.remove(loader); }
+
+    // Requests of the registration matching one of these URL prefixes are answered from the named cache without waking up the service worker.
+    // The routes only apply to the worker that is active when they are first used, they are dropped once the registration is updated.
+    struct ServiceWorkerCacheFirstRoutes {
+        String cacheName;
+        Vector<String> urlPrefixes;
+        Optional<WebCore::ServiceWorkerRegistrationIdentifier> registrationIdentifier;
+        Optional<WebCore::ServiceWorkerIdentifier> workerIdentifier;
+    };
+    void setServiceWorkerCacheFirstRoutes(const URL& scopeURL, ServiceWorkerCacheFirstRoutes&&);
+    void removeServiceWorkerCacheFirstRoutes(const URL& scopeURL);
+    void removeServiceWorkerCacheFirstRoutes(const WebCore::SecurityOriginData&);
+    void clearServiceWorkerCacheFirstRoutes() { m_serviceWorkerCacheFirstRoutes.clear(); }
+    const String* serviceWorkerCacheFirstRouteCacheName(const URL& scopeURL, WebCore::ServiceWorkerRegistrationIdentifier, WebCore::ServiceWorkerIdentifier, const WebCore::ResourceRequest&);
 #endif
 
 protected:
@@ -192,6 +207,7 @@ protected:
 
 #if ENABLE(SERVICE_WORKER)
     HashSet<std::unique_ptr<ServiceWorkerSoftUpdateLoader>> m_softUpdateLoaders;
+    HashMap<String, ServiceWorkerCacheFirstRoutes> m_serviceWorkerCacheFirstRoutes;
 #endif
 };
 
@@ -64,6 +64,12 @@ void NetworkSessionCreationParameters::encode(IPC::Encoder& encoder) const
     encoder << persistentCredentialStorageEnabled;
     encoder << ignoreTLSErrors;
     encoder << proxySettings;
+    encoder << segmentedDownloadsEnabled;
+    encoder << webSocketDeflateEnabled;
+    encoder << webSocketDeflateClientMaxWindowBits;
+    encoder << webSocketDeflateServerMaxWindowBits;
+    encoder << webSocketDeflateClientNoContextTakeover;
+    encoder << webSocketDeflateServerNoContextTakeover;
 #endif
 #if USE(CURL)
     encoder << cookiePersistentStorageFile;
@@ -187,6 +193,37 @@ Optional<NetworkSessionCreationParameters> NetworkSessionCreationParameters::dec
     decoder >> proxySettings;
     if (!proxySettings)
         return WTF::nullopt;
+
+    Optional<bool> segmentedDownloadsEnabled;
+    decoder >> segmentedDownloadsEnabled;
+    if (!segmentedDownloadsEnabled)
+        return WTF::nullopt;
+
+    Optional<bool> webSocketDeflateEnabled;
+    decoder >> webSocketDeflateEnabled;
+    if (!webSocketDeflateEnabled)
+        return WTF::nullopt;
+
+    // permessage-deflate window sizes go from 2^8 to 2^15 bytes.
+    Optional<uint8_t> webSocketDeflateClientMaxWindowBits;
+    decoder >> webSocketDeflateClientMaxWindowBits;
+    if (!webSocketDeflateClientMaxWindowBits || *webSocketDeflateClientMaxWindowBits < 8 || *webSocketDeflateClientMaxWindowBits > 15)
+        return WTF::nullopt;
+
+    Optional<uint8_t> webSocketDeflateServerMaxWindowBits;
+    decoder >> webSocketDeflateServerMaxWindowBits;
+    if (!webSocketDeflateServerMaxWindowBits || *webSocketDeflateServerMaxWindowBits < 8 || *webSocketDeflateServerMaxWindowBits > 15)
+        return WTF::nullopt;
+
+    Optional<bool> webSocketDeflateClientNoContextTakeover;
+    decoder >> webSocketDeflateClientNoContextTakeover;
+    if (!webSocketDeflateClientNoContextTakeover)
+        return WTF::nullopt;
+
+    Optional<bool> webSocketDeflateServerNoContextTakeover;
+    decoder >> webSocketDeflateServerNoContextTakeover;
+    if (!webSocketDeflateServerNoContextTakeover)
+        return WTF::nullopt;
 #endif
 
 #if USE(CURL)
@@ -306,6 +343,12 @@ Optional<NetworkSessionCreationParameters> NetworkSessionCreationParameters::dec
         , WTFMove(*persistentCredentialStorageEnabled)
         , WTFMove(*ignoreTLSErrors)
         , WTFMove(*proxySettings)
+        , WTFMove(*segmentedDownloadsEnabled)
+        , WTFMove(*webSocketDeflateEnabled)
+        , WTFMove(*webSocketDeflateClientMaxWindowBits)
+        , WTFMove(*webSocketDeflateServerMaxWindowBits)
+        , WTFMove(*webSocketDeflateClientNoContextTakeover)
+        , WTFMove(*webSocketDeflateServerNoContextTakeover)
 #endif
 #if USE(CURL)
         , WTFMove(*cookiePersistentStorageFile)
@@ -77,6 +77,12 @@ struct NetworkSessionCreationParameters {
     bool persistentCredentialStorageEnabled { true };
     bool ignoreTLSErrors { false };
     WebCore::SoupNetworkProxySettings proxySettings;
+    bool segmentedDownloadsEnabled { false };
+    bool webSocketDeflateEnabled { true };
+    uint8_t webSocketDeflateClientMaxWindowBits { 15 };
+    uint8_t webSocketDeflateServerMaxWindowBits { 15 };
+    bool webSocketDeflateClientNoContextTakeover { false };
+    bool webSocketDeflateServerNoContextTakeover { false };
 #endif
 #if USE(CURL)
     String cookiePersistentStorageFile;
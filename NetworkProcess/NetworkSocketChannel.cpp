@@ -32,6 +32,12 @@
 #include "WebCoreArgumentCoders.h"
 #include "WebSocketChannelMessages.h"
 #include "WebSocketTask.h"
+#include <unicode/utf8.h>
+#include <wtf/CallbackAggregator.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+#include <wtf/text/StringView.h>
+
+#define MESSAGE_CHECK_COMPLETION(assertion, completion) MESSAGE_CHECK_COMPLETION_BASE(assertion, (&m_connectionToWebProcess.connection()), completion)
 
 namespace WebKit {
 using namespace WebCore;
@@ -51,6 +57,9 @@ NetworkSocketChannel::NetworkSocketChannel(NetworkConnectionToWebProcess& connec
     , m_identifier(identifier)
     , m_session(makeWeakPtr(session))
     , m_errorTimer(*this, &NetworkSocketChannel::sendDelayedError)
+    , m_receivedMessagesFlushTimer(*this, &NetworkSocketChannel::flushReceivedMessages)
+    , m_url(request.url())
+    , m_creationTime(MonotonicTime::now())
 {
     if (!m_session)
         return;
@@ -71,14 +80,67 @@ NetworkSocketChannel::~NetworkSocketChannel()
         m_socket->cancel();
 }
 
+CompletionHandler<void()> NetworkSocketChannel::willSendMessage(size_t length, CompletionHandler<void()>&& callback)
+{
+    ++m_statistics.messagesSent;
+    m_statistics.payloadBytesSent += length;
+    m_statistics.pendingSendBytes += length;
+    m_statistics.maximumPendingSendBytes = std::max(m_statistics.maximumPendingSendBytes, m_statistics.pendingSendBytes);
+
+    return [weakThis = makeWeakPtr(*this), length, callback = WTFMove(callback)]() mutable {
+        if (weakThis)
+            weakThis->m_statistics.pendingSendBytes -= length;
+        callback();
+    };
+}
+
+// Text payloads are counted in UTF-8 bytes, as they are on the wire.
+static size_t utf8Length(const String& text)
+{
+    if (text.isAllASCII())
+        return text.length();
+
+    size_t length = 0;
+    for (auto codePoint : StringView(text).codePoints())
+        length += U8_LENGTH(codePoint);
+    return length;
+}
+
+void NetworkSocketChannel::didReceiveMessagePayload(size_t length)
+{
+    ++m_statistics.messagesReceived;
+    m_statistics.payloadBytesReceived += length;
+    if (!m_statistics.timeToFirstMessage && m_connectionTime)
+        m_statistics.timeToFirstMessage = MonotonicTime::now() - m_connectionTime;
+}
+
 void NetworkSocketChannel::sendString(const IPC::DataReference& message, CompletionHandler<void()>&& callback)
 {
-    m_socket->sendString(message, WTFMove(callback));
+    m_socket->sendString(message, willSendMessage(message.size(), WTFMove(callback)));
 }
 
 void NetworkSocketChannel::sendData(const IPC::DataReference& data, CompletionHandler<void()>&& callback)
 {
-    m_socket->sendData(data, WTFMove(callback));
+    m_socket->sendData(data, willSendMessage(data.size(), WTFMove(callback)));
+}
+
+void NetworkSocketChannel::sendMessages(const IPC::DataReference& messages, CompletionHandler<void()>&& callback)
+{
+    // The WebProcess only sends UTF-8 text and binary messages. Validate the whole batch before sending any of them.
+    bool hasOnlyValidTypes = true;
+    bool isValid = WebSocketMessageBatch::forEachMessage(messages, [&](auto type, auto*, size_t) {
+        if (type != WebSocketMessageBatch::Type::UTF8Text && type != WebSocketMessageBatch::Type::Binary)
+            hasOnlyValidTypes = false;
+    });
+    MESSAGE_CHECK_COMPLETION(isValid && hasOnlyValidTypes, callback());
+
+    auto callbackAggregator = CallbackAggregator::create(WTFMove(callback));
+    WebSocketMessageBatch::forEachMessage(messages, [&](auto type, auto* data, size_t length) {
+        if (type == WebSocketMessageBatch::Type::UTF8Text)
+            m_socket->sendString({ data, length }, willSendMessage(length, [callbackAggregator] { }));
+        else
+            m_socket->sendData({ data, length }, willSendMessage(length, [callbackAggregator] { }));
+    });
 }
 
 void NetworkSocketChannel::finishClosingIfPossible()
@@ -100,17 +162,64 @@ void NetworkSocketChannel::close(int32_t code, const String& reason)
 
 void NetworkSocketChannel::didConnect(const String& subprotocol, const String& extensions)
 {
+    m_connectionTime = MonotonicTime::now();
+    m_statistics.handshakeDuration = m_connectionTime - m_creationTime;
+    m_extensions = extensions;
+
     send(Messages::WebSocketChannel::DidConnect { subprotocol, extensions });
 }
 
 void NetworkSocketChannel::didReceiveText(const String& text)
 {
-    send(Messages::WebSocketChannel::DidReceiveText { text });
+    didReceiveMessagePayload(utf8Length(text));
+
+    if (text.length() >= WebSocketMessageBatch::maximumSize) {
+        flushReceivedMessages();
+        ++m_statistics.receivedMessageDeliveries;
+        send(Messages::WebSocketChannel::DidReceiveText { text });
+        return;
+    }
+
+    m_receivedMessages.appendText(text);
+    scheduleReceivedMessagesFlush();
 }
 
 void NetworkSocketChannel::didReceiveBinaryData(const uint8_t* data, size_t length)
 {
-    send(Messages::WebSocketChannel::DidReceiveBinaryData { { data, length } });
+    didReceiveMessagePayload(length);
+
+    if (length >= WebSocketMessageBatch::maximumSize) {
+        flushReceivedMessages();
+        ++m_statistics.receivedMessageDeliveries;
+        send(Messages::WebSocketChannel::DidReceiveBinaryData { { data, length } });
+        return;
+    }
+
+    m_receivedMessages.append(WebSocketMessageBatch::Type::Binary, data, length);
+    scheduleReceivedMessagesFlush();
+}
+
+void NetworkSocketChannel::scheduleReceivedMessagesFlush()
+{
+    // Messages received in the same run loop iteration are delivered together.
+    if (m_receivedMessages.size() >= WebSocketMessageBatch::maximumSize) {
+        flushReceivedMessages();
+        return;
+    }
+
+    if (!m_receivedMessagesFlushTimer.isActive())
+        m_receivedMessagesFlushTimer.startOneShot(0_s);
+}
+
+void NetworkSocketChannel::flushReceivedMessages()
+{
+    m_receivedMessagesFlushTimer.stop();
+    if (m_receivedMessages.isEmpty())
+        return;
+
+    auto messages = m_receivedMessages.take();
+    ++m_statistics.receivedMessageDeliveries;
+    send(Messages::WebSocketChannel::DidReceiveMessages { IPC::DataReference { messages } });
 }
 
 void NetworkSocketChannel::didClose(unsigned short code, const String& reason)
@@ -119,6 +228,7 @@ void NetworkSocketChannel::didClose(unsigned short code, const String& reason)
         m_closeInfo = std::make_pair(code, reason);
         return;
     }
+    flushReceivedMessages();
     send(Messages::WebSocketChannel::DidClose { code, reason });
     finishClosingIfPossible();
 }
@@ -131,6 +241,7 @@ void NetworkSocketChannel::didReceiveMessageError(const String& errorMessage)
 
 void NetworkSocketChannel::sendDelayedError()
 {
+    flushReceivedMessages();
     send(Messages::WebSocketChannel::DidReceiveMessageError { m_errorMessage });
     if (m_closeInfo) {
         send(Messages::WebSocketChannel::DidClose { m_closeInfo->first, m_closeInfo->second });
@@ -149,6 +260,23 @@ void NetworkSocketChannel::didReceiveHandshakeResponse(ResourceResponse&& respon
     send(Messages::WebSocketChannel::DidReceiveHandshakeResponse { response });
 }
 
+static String durationDescription(const Optional<Seconds>& duration)
+{
+    if (!duration)
+        return "-"_s;
+    return makeString(duration->milliseconds(), "ms");
+}
+
+String NetworkSocketChannel::statisticsDescription() const
+{
+    return makeString(m_url.string(), '\n',
+        "  Extensions: ", m_extensions.isEmpty() ? "none"_s : m_extensions, '\n',
+        "  Messages sent: ", m_statistics.messagesSent, " (", m_statistics.payloadBytesSent, " bytes)\n",
+        "  Messages received: ", m_statistics.messagesReceived, " (", m_statistics.payloadBytesReceived, " bytes, ", m_statistics.receivedMessageDeliveries, " deliveries to the web process)\n",
+        "  Pending send bytes: ", m_statistics.pendingSendBytes, " (maximum ", m_statistics.maximumPendingSendBytes, ")\n",
+        "  Handshake duration: ", durationDescription(m_statistics.handshakeDuration), ", time to first message: ", durationDescription(m_statistics.timeToFirstMessage), '\n');
+}
+
 IPC::Connection* NetworkSocketChannel::messageSenderConnection() const
 {
     return &m_connectionToWebProcess.connection();
@@ -160,3 +288,5 @@ NetworkSession* NetworkSocketChannel::session()
 }
 
 } // namespace WebKit
+
+#undef MESSAGE_CHECK_COMPLETION
@@ -28,10 +28,13 @@
 #include "DataReference.h"
 #include "MessageReceiver.h"
 #include "MessageSender.h"
+#include "WebSocketMessageBatch.h"
 #include <WebCore/Timer.h>
 #include <WebCore/WebSocketIdentifier.h>
 #include <pal/SessionID.h>
 #include <wtf/CompletionHandler.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/URL.h>
 #include <wtf/WeakPtr.h>
 
 namespace WebCore {
@@ -50,7 +53,7 @@ class NetworkConnectionToWebProcess;
 class NetworkProcess;
 class NetworkSession;
 
-class NetworkSocketChannel : public IPC::MessageSender, public IPC::MessageReceiver {
+class NetworkSocketChannel : public IPC::MessageSender, public IPC::MessageReceiver, public CanMakeWeakPtr<NetworkSocketChannel> {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     static std::unique_ptr<NetworkSocketChannel> create(NetworkConnectionToWebProcess&, PAL::SessionID, const WebCore::ResourceRequest&, const String& protocol, WebCore::WebSocketIdentifier);
@@ -60,6 +63,22 @@ public:
 
     void didReceiveMessage(IPC::Connection&, IPC::Decoder&);
 
+    // Messages are counted rather than frames, since fragmented messages are reassembled by the network stack.
+    // Payloads are counted before compression, text received is counted in characters.
+    struct Statistics {
+        uint64_t messagesSent { 0 };
+        uint64_t messagesReceived { 0 };
+        uint64_t payloadBytesSent { 0 };
+        uint64_t payloadBytesReceived { 0 };
+        uint64_t receivedMessageDeliveries { 0 };
+        uint64_t pendingSendBytes { 0 };
+        uint64_t maximumPendingSendBytes { 0 };
+        Optional<Seconds> handshakeDuration;
+        Optional<Seconds> timeToFirstMessage;
+    };
+    const Statistics& statistics() const { return m_statistics; }
+    String statisticsDescription() const;
+
     friend class WebSocketTask;
 
 private:
@@ -73,6 +92,7 @@ private:
 
     void sendString(const IPC::DataReference&, CompletionHandler<void()>&&);
     void sendData(const IPC::DataReference&, CompletionHandler<void()>&&);
+    void sendMessages(const IPC::DataReference&, CompletionHandler<void()>&&);
     void close(int32_t code, const String& reason);
     void sendDelayedError();
 
@@ -82,6 +102,10 @@ private:
     uint64_t messageSenderDestinationID() const final { return m_identifier.toUInt64(); }
 
     void finishClosingIfPossible();
+    void scheduleReceivedMessagesFlush();
+    void flushReceivedMessages();
+    CompletionHandler<void()> willSendMessage(size_t length, CompletionHandler<void()>&&);
+    void didReceiveMessagePayload(size_t length);
 
     NetworkConnectionToWebProcess& m_connectionToWebProcess;
     WebCore::WebSocketIdentifier m_identifier;
@@ -93,6 +117,14 @@ private:
     WebCore::Timer m_errorTimer;
     String m_errorMessage;
     Optional<std::pair<unsigned short, String>> m_closeInfo;
+    WebSocketMessageBatch m_receivedMessages;
+    WebCore::Timer m_receivedMessagesFlushTimer;
+
+    URL m_url;
+    String m_extensions;
+    MonotonicTime m_creationTime;
+    MonotonicTime m_connectionTime;
+    Statistics m_statistics;
 };
 
 } // namespace WebKit
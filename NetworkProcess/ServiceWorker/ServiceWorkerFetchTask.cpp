@@ -28,6 +28,7 @@
 
 #if ENABLE(SERVICE_WORKER)
 
+#include "CacheStorageEngine.h"
 #include "Connection.h"
 #include "FormDataReference.h"
 #include "Logging.h"
@@ -40,6 +41,8 @@
 #include "WebSWServerConnection.h"
 #include "WebSWServerToContextConnection.h"
 #include <WebCore/CrossOriginAccessControl.h>
+#include <WebCore/ClientOrigin.h>
+#include <WebCore/RetrieveRecordsOptions.h>
 #include <WebCore/SWServerRegistration.h>
 
 #define RELEASE_LOG_IF_ALLOWED(fmt, ...) RELEASE_LOG_IF(m_loader.sessionID().isAlwaysOnLoggingAllowed(), ServiceWorker, "%p - [fetchIdentifier=%" PRIu64 "] ServiceWorkerFetchTask::" fmt, this, m_fetchIdentifier.toUInt64(), ##__VA_ARGS__)
@@ -119,6 +122,83 @@ void ServiceWorkerFetchTask::startFetch()
     ASSERT_UNUSED(isSent, isSent);
 }
 
+void ServiceWorkerFetchTask::startFromCacheStorage(const ClientOrigin& origin, const String& cacheName, Function<void()>&& didNotFindResponse)
+{
+    RELEASE_LOG_IF_ALLOWED("startFromCacheStorage:");
+    // The fetch timeout only applies to the service worker, it starts again if the request goes to it.
+    m_timeoutTimer.stop();
+    didNotFindResponse = [weakThis = makeWeakPtr(*this), didNotFindResponse = WTFMove(didNotFindResponse)] {
+        if (weakThis && !weakThis->m_isDone)
+            weakThis->m_timeoutTimer.startOneShot(weakThis->m_loader.connectionToWebProcess().networkProcess().serviceWorkerFetchTimeout());
+        didNotFindResponse();
+    };
+
+    auto& networkProcess = m_loader.connectionToWebProcess().networkProcess();
+    CacheStorage::Engine::retrieveCaches(networkProcess, m_loader.sessionID(), ClientOrigin { origin }, 0, [weakThis = makeWeakPtr(*this), cacheName, didNotFindResponse = WTFMove(didNotFindResponse)](auto&& result) mutable {
+        if (!weakThis || weakThis->m_isDone || !result.has_value()) {
+            didNotFindResponse();
+            return;
+        }
+
+        auto index = result.value().infos.findMatching([&](auto& info) {
+            return info.name == cacheName;
+        });
+        if (index == notFound) {
+            didNotFindResponse();
+            return;
+        }
+        weakThis->lookUpCacheStorageRecord(result.value().infos[index].identifier, WTFMove(didNotFindResponse));
+    });
+}
+
+void ServiceWorkerFetchTask::lookUpCacheStorageRecord(uint64_t cacheIdentifier, Function<void()>&& didNotFindResponse)
+{
+    RetrieveRecordsOptions options;
+    options.request = m_currentRequest;
+    options.shouldProvideResponse = true;
+
+    auto& networkProcess = m_loader.connectionToWebProcess().networkProcess();
+    CacheStorage::Engine::retrieveRecords(networkProcess, m_loader.sessionID(), cacheIdentifier, WTFMove(options), [weakThis = makeWeakPtr(*this), didNotFindResponse = WTFMove(didNotFindResponse)](auto&& result) mutable {
+        if (!weakThis || weakThis->m_isDone || !result.has_value() || result.value().isEmpty()) {
+            didNotFindResponse();
+            return;
+        }
+
+        // Opaque responses and non-buffered bodies are left to the service worker, which knows how to vend them. So are
+        // redirected responses, which would have to be checked against the redirect mode of the request.
+        auto& record = result.value().first();
+        auto* body = WTF::get_if<Ref<SharedBuffer>>(record.responseBody);
+        if (!body || record.response.type() == ResourceResponse::Type::Opaque || record.response.type() == ResourceResponse::Type::Opaqueredirect || record.response.isRedirected()) {
+            didNotFindResponse();
+            return;
+        }
+
+        weakThis->didReceiveCacheStorageResponse(WTFMove(record.response), body->copyRef());
+    });
+}
+
+void ServiceWorkerFetchTask::didReceiveCacheStorageResponse(ResourceResponse&& response, Ref<SharedBuffer>&& body)
+{
+    RELEASE_LOG_IF_ALLOWED("didReceiveCacheStorageResponse: Answering fetch from CacheStorage without running the service worker");
+    bool needsContinueDidReceiveResponseMessage = m_loader.isMainResource();
+    didReceiveResponse(WTFMove(response), needsContinueDidReceiveResponseMessage);
+    if (needsContinueDidReceiveResponseMessage) {
+        m_cacheStorageBodyWaitingForContinueDidReceiveResponse = WTFMove(body);
+        return;
+    }
+    sendCacheStorageBody(WTFMove(body));
+}
+
+void ServiceWorkerFetchTask::sendCacheStorageBody(Ref<SharedBuffer>&& body)
+{
+    if (m_isDone)
+        return;
+
+    if (body->size())
+        sendToClient(Messages::WebResourceLoader::DidReceiveData { IPC::SharedBufferDataReference { body.get() }, static_cast<int64_t>(body->size()) });
+    didFinish();
+}
+
 void ServiceWorkerFetchTask::didReceiveRedirectResponse(ResourceResponse&& response)
 {
     if (m_isDone)
@@ -158,6 +238,16 @@ void ServiceWorkerFetchTask::didReceiveData(const IPC::DataReference& data, int6
     sendToClient(Messages::WebResourceLoader::DidReceiveData { data, encodedDataLength });
 }
 
+void ServiceWorkerFetchTask::didReceiveSharedMemoryData(SharedMemory::IPCHandle&& data, int64_t encodedDataLength)
+{
+    if (m_isDone)
+        return;
+
+    ASSERT(!m_timeoutTimer.isActive());
+    // Only the handle goes through this process, the bytes are read directly by the client.
+    sendToClient(Messages::WebResourceLoader::DidReceiveSharedMemoryData { WTFMove(data), encodedDataLength });
+}
+
 void ServiceWorkerFetchTask::didReceiveFormData(const IPC::FormDataReference& formData)
 {
     if (m_isDone)
@@ -220,6 +310,10 @@ void ServiceWorkerFetchTask::cancelFromClient()
 void ServiceWorkerFetchTask::continueDidReceiveFetchResponse()
 {
     RELEASE_LOG_IF_ALLOWED("continueDidReceiveFetchResponse:");
+    if (auto body = WTFMove(m_cacheStorageBodyWaitingForContinueDidReceiveResponse)) {
+        sendCacheStorageBody(body.releaseNonNull());
+        return;
+    }
     sendToServiceWorker(Messages::WebSWContextManagerConnection::ContinueDidReceiveFetchResponse { m_serverConnectionIdentifier, m_serviceWorkerIdentifier, m_fetchIdentifier });
 }
 
@@ -28,18 +28,22 @@
 #if ENABLE(SERVICE_WORKER)
 
 #include "DataReference.h"
+#include "SharedMemory.h"
 #include <WebCore/FetchIdentifier.h>
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/ServiceWorkerClientIdentifier.h>
 #include <WebCore/ServiceWorkerTypes.h>
 #include <WebCore/Timer.h>
 #include <pal/SessionID.h>
+#include <wtf/Function.h>
 #include <wtf/WeakPtr.h>
 
 namespace WebCore {
 class ResourceError;
 class ResourceRequest;
 class ResourceResponse;
+class SharedBuffer;
+struct ClientOrigin;
 }
 
 namespace IPC {
@@ -61,6 +65,7 @@ public:
     ~ServiceWorkerFetchTask();
 
     void start(WebSWServerToContextConnection&);
+    void startFromCacheStorage(const WebCore::ClientOrigin&, const String& cacheName, Function<void()>&& didNotFindResponse);
     void cancelFromClient();
     void didReceiveMessage(IPC::Connection&, IPC::Decoder&);
 
@@ -79,12 +84,16 @@ private:
     void didReceiveRedirectResponse(WebCore::ResourceResponse&&);
     void didReceiveResponse(WebCore::ResourceResponse&&, bool needsContinueDidReceiveResponseMessage);
     void didReceiveData(const IPC::DataReference&, int64_t encodedDataLength);
+    void didReceiveSharedMemoryData(SharedMemory::IPCHandle&&, int64_t encodedDataLength);
     void didReceiveFormData(const IPC::FormDataReference&);
     void didFinish();
     void didFail(const WebCore::ResourceError&);
     void didNotHandle();
 
     void startFetch();
+    void lookUpCacheStorageRecord(uint64_t cacheIdentifier, Function<void()>&& didNotFindResponse);
+    void didReceiveCacheStorageResponse(WebCore::ResourceResponse&&, Ref<WebCore::SharedBuffer>&&);
+    void sendCacheStorageBody(Ref<WebCore::SharedBuffer>&&);
 
     void timeoutTimerFired();
     void softUpdateIfNeeded();
@@ -104,6 +113,7 @@ private:
     bool m_isDone { false };
     WebCore::ServiceWorkerRegistrationIdentifier m_serviceWorkerRegistrationIdentifier;
     bool m_shouldSoftUpdate { false };
+    RefPtr<WebCore::SharedBuffer> m_cacheStorageBodyWaitingForContinueDidReceiveResponse;
 };
 
 }
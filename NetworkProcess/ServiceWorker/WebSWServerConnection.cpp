@@ -35,6 +35,7 @@
 #include "NetworkProcess.h"
 #include "NetworkProcessProxyMessages.h"
 #include "NetworkResourceLoader.h"
+#include "NetworkSession.h"
 #include "WebCoreArgumentCoders.h"
 #include "WebProcess.h"
 #include "WebProcessMessages.h"
@@ -96,6 +97,10 @@ void WebSWServerConnection::resolveRegistrationJobInClient(ServiceWorkerJobIdent
 void WebSWServerConnection::resolveUnregistrationJobInClient(ServiceWorkerJobIdentifier jobIdentifier, const ServiceWorkerRegistrationKey& registrationKey, bool unregistrationResult)
 {
     ASSERT(m_unregisterJobs.contains(jobIdentifier));
+    if (unregistrationResult) {
+        if (auto* session = m_networkProcess->networkSession(sessionID()))
+            session->removeServiceWorkerCacheFirstRoutes(registrationKey.scope());
+    }
     if (auto completionHandler = m_unregisterJobs.take(jobIdentifier))
         completionHandler(unregistrationResult);
 }
@@ -197,6 +202,22 @@ std::unique_ptr<ServiceWorkerFetchTask> WebSWServerConnection::createFetchTask(N
     }
 
     auto task = makeUnique<ServiceWorkerFetchTask>(*this, loader, ResourceRequest { request }, identifier(), worker->identifier(), *serviceWorkerRegistrationIdentifier, shouldSoftUpdate);
+    auto* session = loader.connectionToWebProcess().networkSession();
+    if (auto* cacheName = session && registration ? session->serviceWorkerCacheFirstRouteCacheName(registration->key().scope(), registration->identifier(), worker->identifier(), request) : nullptr) {
+        task->startFromCacheStorage(worker->origin(), *cacheName, [weakThis = makeWeakPtr(this), this, task = makeWeakPtr(*task)] {
+            if (!task)
+                return;
+
+            auto* worker = weakThis ? server().workerByID(task->serviceWorkerIdentifier()) : nullptr;
+            if (!worker) {
+                task->cannotHandle();
+                return;
+            }
+            startFetch(*task, *worker);
+        });
+        return task;
+    }
+
     startFetch(*task, *worker);
     return task;
 }
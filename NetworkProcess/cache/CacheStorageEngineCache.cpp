@@ -158,6 +158,108 @@ static TraversalResult isolatedCopy(TraversalResult&& result)
     return TraversalResult { result.cacheIdentifier, WTFMove(isolatedRecords), WTFMove(result.failedRecords) };
 }
 
+static const uint32_t recordsIndexVersion = 1;
+
+static Data encodeRecordsIndex(const HashMap<String, Vector<RecordInformation>>& records)
+{
+    WTF::Persistence::Encoder encoder;
+    encoder << recordsIndexVersion;
+
+    uint64_t count = 0;
+    for (auto& sameURLRecords : records.values())
+        count += sameURLRecords.size();
+    encoder << count;
+
+    for (auto& sameURLRecords : records.values()) {
+        for (auto& record : sameURLRecords) {
+            record.key.encode(encoder);
+            encoder << record.insertionTime;
+            encoder << record.size;
+            encoder << record.url.string();
+            encoder << record.hasVaryStar;
+            encoder << static_cast<uint64_t>(record.varyHeaders.size());
+            for (auto& header : record.varyHeaders) {
+                encoder << header.key;
+                encoder << header.value;
+            }
+        }
+    }
+
+    encoder.encodeChecksum();
+    return Data { encoder.buffer(), encoder.bufferSize() };
+}
+
+static Optional<HashMap<String, Vector<RecordInformation>>> decodeRecordsIndex(const Data& data)
+{
+    if (data.isNull())
+        return WTF::nullopt;
+
+    WTF::Persistence::Decoder decoder(data.data(), data.size());
+    Optional<uint32_t> version;
+    decoder >> version;
+    if (!version || *version != recordsIndexVersion)
+        return WTF::nullopt;
+
+    Optional<uint64_t> count;
+    decoder >> count;
+    if (!count)
+        return WTF::nullopt;
+
+    HashMap<String, Vector<RecordInformation>> records;
+    for (uint64_t index = 0; index < *count; ++index) {
+        auto key = Key::decode(decoder);
+        if (!key)
+            return WTF::nullopt;
+
+        Optional<double> insertionTime;
+        decoder >> insertionTime;
+        if (!insertionTime)
+            return WTF::nullopt;
+
+        Optional<uint64_t> size;
+        decoder >> size;
+        if (!size)
+            return WTF::nullopt;
+
+        Optional<String> url;
+        decoder >> url;
+        if (!url)
+            return WTF::nullopt;
+
+        Optional<bool> hasVaryStar;
+        decoder >> hasVaryStar;
+        if (!hasVaryStar)
+            return WTF::nullopt;
+
+        Optional<uint64_t> varyHeadersCount;
+        decoder >> varyHeadersCount;
+        if (!varyHeadersCount)
+            return WTF::nullopt;
+
+        HashMap<String, String> varyHeaders;
+        for (uint64_t headerIndex = 0; headerIndex < *varyHeadersCount; ++headerIndex) {
+            Optional<String> name;
+            decoder >> name;
+            if (!name)
+                return WTF::nullopt;
+            Optional<String> value;
+            decoder >> value;
+            if (!value)
+                return WTF::nullopt;
+            varyHeaders.set(WTFMove(*name), WTFMove(*value));
+        }
+
+        RecordInformation recordInformation { WTFMove(*key), *insertionTime, 0, 0, *size, URL { URL { }, *url }, *hasVaryStar, WTFMove(varyHeaders) };
+        auto& sameURLRecords = records.ensure(computeKeyURL(recordInformation.url), [] { return Vector<RecordInformation> { }; }).iterator->value;
+        sameURLRecords.append(WTFMove(recordInformation));
+    }
+
+    if (!decoder.verifyChecksum())
+        return WTF::nullopt;
+
+    return records;
+}
+
 void Cache::open(CompletionCallback&& callback)
 {
     if (m_state == State::Open) {
@@ -169,6 +271,28 @@ void Cache::open(CompletionCallback&& callback)
         return;
     }
     m_state = State::Opening;
+    m_caches.readRecordsIndex(*this, [caches = makeRef(m_caches), identifier = m_identifier, callback = WTFMove(callback)](const Data& data) mutable {
+        auto* cache = caches->find(identifier);
+        if (!cache) {
+            callback(Error::Internal);
+            return;
+        }
+
+        auto records = decodeRecordsIndex(data);
+        if (!records) {
+            cache->readRecordsList(WTFMove(callback));
+            return;
+        }
+
+        // The index only describes the cache as it was when last closed, it is rewritten at the next closing.
+        caches->removeRecordsIndex(*cache);
+        cache->m_records = WTFMove(*records);
+        cache->finishOpening(WTFMove(callback), WTF::nullopt);
+    });
+}
+
+void Cache::readRecordsList(CompletionCallback&& callback)
+{
     TraversalResult traversalResult { m_identifier, { }, { } };
     m_caches.readRecordsList(*this, [caches = makeRef(m_caches), callback = WTFMove(callback), traversalResult = WTFMove(traversalResult)](const auto* storageRecord, const auto&) mutable {
         if (!storageRecord) {
@@ -204,6 +328,13 @@ void Cache::open(CompletionCallback&& callback)
     });
 }
 
+void Cache::writeRecordsIndex()
+{
+    if (m_state != State::Open)
+        return;
+    m_caches.writeRecordsIndex(*this, encodeRecordsIndex(m_records));
+}
+
 void Cache::finishOpening(CompletionCallback&& callback, Optional<Error>&& error)
 {
     Vector<std::reference_wrapper<RecordInformation>> records;
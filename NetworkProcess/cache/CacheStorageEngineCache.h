@@ -80,6 +80,7 @@ public:
 
     void dispose();
     void clearMemoryRepresentation();
+    void writeRecordsIndex();
 
     static Optional<WebCore::DOMCacheEngine::Record> decode(const NetworkCache::Storage::Record&);
     static NetworkCache::Storage::Record encode(const RecordInformation&, const WebCore::DOMCacheEngine::Record&);
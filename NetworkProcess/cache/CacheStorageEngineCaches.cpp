@@ -51,6 +51,11 @@ static inline String cachesOriginFilename(const String& cachesRootPath)
     return FileSystem::pathByAppendingComponent(cachesRootPath, "origin"_s);
 }
 
+static inline String recordsIndexFilename(const String& cachesRootPath, const String& cacheUniqueName)
+{
+    return FileSystem::pathByAppendingComponent(cachesRootPath, makeString(cacheUniqueName, ".index"));
+}
+
 String Caches::cachesSizeFilename(const String& cachesRootsPath)
 {
     return FileSystem::pathByAppendingComponent(cachesRootsPath, "estimatedsize"_s);
@@ -255,8 +260,13 @@ void Caches::clear(CompletionHandler<void()>&& completionHandler)
     for (auto& callback : pendingCallbacks)
         callback(Error::Internal);
 
-    if (m_engine)
+    if (m_engine) {
         m_engine->removeFile(cachesListFilename(m_rootPath));
+        for (auto& cache : m_caches)
+            removeRecordsIndex(cache);
+        for (auto& cache : m_removedCaches)
+            removeRecordsIndex(cache);
+    }
     if (m_storage) {
         m_storage->clear(String { }, -WallTime::infinity(), [protectedThis = makeRef(*this), completionHandler = WTFMove(completionHandler)]() mutable {
             ASSERT(RunLoop::isMain());
@@ -377,6 +387,7 @@ void Caches::dispose(Cache& cache)
     if (position != notFound) {
         if (m_storage)
             m_storage->remove(cache.keys(), [] { });
+        removeRecordsIndex(cache);
 
         m_removedCaches.remove(position);
         return;
@@ -387,6 +398,8 @@ void Caches::dispose(Cache& cache)
     if (!shouldPersist())
         return;
 
+    // Persist the record list so that reopening the cache does not need to traverse and decode every record.
+    cache.writeRecordsIndex();
     cache.clearMemoryRepresentation();
 
     if (!hasActiveCache())
@@ -517,6 +530,43 @@ void Caches::readRecordsList(Cache& cache, NetworkCache::Storage::TraverseHandle
     });
 }
 
+void Caches::readRecordsIndex(const Cache& cache, CompletionHandler<void(const NetworkCache::Data&)>&& callback)
+{
+    if (!m_engine || !shouldPersist()) {
+        callback({ });
+        return;
+    }
+
+    // A missing index is reported as empty data by readFile(), without checking for the file on the main thread.
+    m_engine->readFile(recordsIndexFilename(m_rootPath, cache.uniqueName()), [callback = WTFMove(callback)](const Data& data, int error) mutable {
+        if (error) {
+            RELEASE_LOG_ERROR(CacheStorage, "Caches::readRecordsIndex failed reading index with error %d", error);
+            callback({ });
+            return;
+        }
+        callback(data);
+    });
+}
+
+void Caches::writeRecordsIndex(const Cache& cache, NetworkCache::Data&& data)
+{
+    if (!m_engine || !shouldPersist())
+        return;
+
+    m_engine->writeFile(recordsIndexFilename(m_rootPath, cache.uniqueName()), WTFMove(data), [](Optional<Error>&& error) {
+        if (error)
+            RELEASE_LOG_ERROR(CacheStorage, "Caches::writeRecordsIndex failed writing index with error %d", static_cast<int>(*error));
+    });
+}
+
+void Caches::removeRecordsIndex(const Cache& cache)
+{
+    if (!m_engine || !shouldPersist())
+        return;
+
+    m_engine->removeFile(recordsIndexFilename(m_rootPath, cache.uniqueName()));
+}
+
 void Caches::requestSpace(uint64_t spaceRequired, WebCore::DOMCacheEngine::CompletionCallback&& callback)
 {
     if (!m_engine) {
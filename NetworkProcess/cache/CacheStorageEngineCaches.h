@@ -63,6 +63,9 @@ public:
     void appendRepresentation(StringBuilder&) const;
 
     void readRecordsList(Cache&, NetworkCache::Storage::TraverseHandler&&);
+    void readRecordsIndex(const Cache&, CompletionHandler<void(const NetworkCache::Data&)>&&);
+    void writeRecordsIndex(const Cache&, NetworkCache::Data&&);
+    void removeRecordsIndex(const Cache&);
     void readRecord(const NetworkCache::Key&, WTF::Function<void(Expected<WebCore::DOMCacheEngine::Record, WebCore::DOMCacheEngine::Error>&&)>&&);
 
     void requestSpace(uint64_t spaceRequired, WebCore::DOMCacheEngine::CompletionCallback&&);
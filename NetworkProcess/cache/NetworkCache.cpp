@@ -82,7 +82,7 @@ RefPtr<Cache> Cache::open(NetworkProcess& networkProcess, const String& cachePat
         return nullptr;
 
     auto capacity = computeCapacity(networkProcess.cacheModel(), cachePath);
-    auto storage = Storage::open(cachePath, options.contains(CacheOption::TestingMode) ? Storage::Mode::AvoidRandomness : Storage::Mode::Normal, capacity);
+    auto storage = Storage::open(cachePath, options.contains(CacheOption::TestingMode) ? Storage::Mode::AvoidRandomness : Storage::Mode::Normal, capacity, networkProcess.sharedNetworkCacheBlobsDirectory());
 
     LOG(NetworkCache, "(NetworkProcess) opened cache storage, success %d", !!storage);
 
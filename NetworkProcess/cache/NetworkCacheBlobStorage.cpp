@@ -30,6 +30,7 @@
 #include "NetworkCacheFileSystem.h"
 #include <fcntl.h>
 #include <wtf/FileSystem.h>
+#include <wtf/Lock.h>
 #include <wtf/RunLoop.h>
 #include <wtf/SHA1.h>
 
@@ -41,9 +42,14 @@
 namespace WebKit {
 namespace NetworkCache {
 
-BlobStorage::BlobStorage(const String& blobDirectoryPath, Salt salt)
+// All the caches using a shared blob directory live in this process. Adding a blob and deleting the unreferenced
+// ones must not interleave, otherwise a cache could lose a blob it just created or linked to.
+static Lock sharedBlobDirectoryLock;
+
+BlobStorage::BlobStorage(const String& blobDirectoryPath, Salt salt, Sharing sharing)
     : m_blobDirectoryPath(blobDirectoryPath)
     , m_salt(salt)
+    , m_sharing(sharing)
 {
 }
 
@@ -59,23 +65,32 @@ void BlobStorage::synchronize()
     auto blobDirectoryPath = blobDirectoryPathIsolatedCopy();
     FileSystem::makeAllDirectories(blobDirectoryPath);
 
-    m_approximateSize = 0;
+    size_t approximateSize = 0;
+    size_t approximateBytesSaved = 0;
     auto blobDirectory = blobDirectoryPath;
-    traverseDirectory(blobDirectory, [this, &blobDirectory](const String& name, DirectoryEntryType type) {
+    traverseDirectory(blobDirectory, [&](const String& name, DirectoryEntryType type) {
         if (type != DirectoryEntryType::File)
             return;
         auto path = FileSystem::pathByAppendingComponent(blobDirectory, name);
         auto filePath = FileSystem::fileSystemRepresentation(path);
+        auto locker = holdLockIf(sharedBlobDirectoryLock, isShared());
         struct stat stat;
-        ::stat(filePath.data(), &stat);
+        if (::stat(filePath.data(), &stat) < 0)
+            return;
         // No clients left for this blob.
-        if (stat.st_nlink == 1)
+        if (stat.st_nlink == 1) {
             unlink(filePath.data());
-        else
-            m_approximateSize += stat.st_size;
+            return;
+        }
+        size_t clientCount = stat.st_nlink - 1;
+        approximateBytesSaved += stat.st_size * (clientCount - 1);
+        approximateSize += stat.st_size;
     });
+    if (!isShared())
+        m_approximateSize = approximateSize;
+    m_approximateBytesSaved = approximateBytesSaved;
 
-    LOG(NetworkCacheStorage, "(NetworkProcess) blob synchronization completed approximateSize=%zu", approximateSize());
+    LOG(NetworkCacheStorage, "(NetworkProcess) blob synchronization completed approximateSize=%zu approximateBytesSaved=%zu shared=%d", this->approximateSize(), this->approximateBytesSaved(), isShared());
 }
 
 String BlobStorage::blobPathForHash(const SHA1::Digest& hash) const
@@ -96,6 +111,8 @@ BlobStorage::Blob BlobStorage::add(const String& path, const Data& data)
     
     FileSystem::deleteFile(path);
 
+    auto locker = holdLockIf(sharedBlobDirectoryLock, isShared());
+
     bool blobExists = FileSystem::fileExists(blobPath);
     if (blobExists) {
         FileSystem::makeSafeToUseMemoryMapForPath(blobPath);
@@ -103,6 +120,8 @@ BlobStorage::Blob BlobStorage::add(const String& path, const Data& data)
         if (bytesEqual(existingData, data)) {
             if (!FileSystem::hardLink(blobPath, path))
                 WTFLogAlways("Failed to create hard link from %s to %s", blobPath.utf8().data(), path.utf8().data());
+            else
+                m_approximateBytesSaved += existingData.size();
             return { existingData, hash };
         }
         FileSystem::deleteFile(blobPath);
@@ -149,5 +168,18 @@ unsigned BlobStorage::shareCount(const String& path)
     return stat.st_nlink - 1;
 }
 
+size_t BlobStorage::approximateShareOfSize(const String& path)
+{
+    ASSERT(!RunLoop::isMain());
+
+    auto linkPath = FileSystem::fileSystemRepresentation(path);
+    struct stat stat;
+    if (::stat(linkPath.data(), &stat) < 0)
+        return 0;
+    // A link whose blob was already removed from the blob directory is the only client left.
+    size_t clientCount = std::max<size_t>(stat.st_nlink - 1, 1);
+    return stat.st_size / clientCount;
+}
+
 }
 }
@@ -34,10 +34,13 @@ namespace WebKit {
 namespace NetworkCache {
 
 // BlobStorage deduplicates the data using SHA1 hash computed over the blob bytes.
+// A shared blob directory may be used by several caches. Each client holds a hard link to the blob so the
+// link count works as a reference count across all of them.
 class BlobStorage {
     WTF_MAKE_NONCOPYABLE(BlobStorage);
 public:
-    BlobStorage(const String& blobDirectoryPath, Salt);
+    enum class Sharing : bool { Private, Shared };
+    BlobStorage(const String& blobDirectoryPath, Salt, Sharing = Sharing::Private);
 
     struct Blob {
         Data data;
@@ -51,10 +54,19 @@ public:
     void remove(const String& path);
 
     unsigned shareCount(const String& path);
+    // The size of the blob linked at the path, divided evenly between the clients linking to it.
+    size_t approximateShareOfSize(const String& path);
 
+    // With shared storage this is the share of the bytes of the blobs this client links to.
     size_t approximateSize() const { return m_approximateSize; }
+    // Bytes not written to disk thanks to deduplication. With shared storage this covers all the clients.
+    size_t approximateBytesSaved() const { return m_approximateBytesSaved; }
+    bool isShared() const { return m_sharing == Sharing::Shared; }
 
+    // With shared storage the directory holds the blobs of all the clients, so the size is computed
+    // from this client's own links instead, and set with setApproximateSize().
     void synchronize();
+    void setApproximateSize(size_t size) { m_approximateSize = size; }
 
 private:
     String blobDirectoryPathIsolatedCopy() const;
@@ -62,8 +74,10 @@ private:
 
     const String m_blobDirectoryPath;
     const Salt m_salt;
+    const Sharing m_sharing;
 
     std::atomic<size_t> m_approximateSize { 0 };
+    std::atomic<size_t> m_approximateBytesSaved { 0 };
 };
 
 }
@@ -112,6 +112,12 @@ Data adoptAndMapFile(FileSystem::PlatformFileHandle, size_t offset, size_t);
 Data mapFile(const char* path);
 Data mapFile(const String& path);
 
+#if USE(SOUP)
+// These return a null Data if the data doesn't get any smaller or can't be decompressed.
+Data compress(const Data&);
+Data decompress(const Data&, size_t decompressedSize);
+#endif
+
 using Salt = std::array<uint8_t, 8>;
 
 Optional<Salt> readOrMakeSalt(const String& path);
@@ -37,6 +37,9 @@
 #include <gio/gfiledescriptorbased.h>
 #endif
 
+#include <gio/gio.h>
+#include <wtf/glib/GUniquePtr.h>
+
 namespace WebKit {
 namespace NetworkCache {
 
@@ -142,5 +145,50 @@ RefPtr<SharedMemory> Data::tryCreateSharedMemory() const
     return SharedMemory::wrapMap(const_cast<char*>(m_buffer->data), m_buffer->length, fd);
 }
 
+static Data convert(GConverter* converter, const Data& data, size_t outputCapacity)
+{
+    if (data.isEmpty() || !outputCapacity)
+        return { };
+
+    uint8_t* output = static_cast<uint8_t*>(fastMalloc(outputCapacity));
+    size_t inputOffset = 0;
+    size_t outputOffset = 0;
+    while (true) {
+        gsize bytesRead = 0;
+        gsize bytesWritten = 0;
+        GUniqueOutPtr<GError> error;
+        auto result = g_converter_convert(converter, data.data() + inputOffset, data.size() - inputOffset, output + outputOffset, outputCapacity - outputOffset,
+            G_CONVERTER_INPUT_AT_END, &bytesRead, &bytesWritten, &error.outPtr());
+        inputOffset += bytesRead;
+        outputOffset += bytesWritten;
+        if (result == G_CONVERTER_FINISHED)
+            break;
+        // G_IO_ERROR_NO_SPACE means the output doesn't fit in outputCapacity.
+        if (result == G_CONVERTER_ERROR || (!bytesRead && !bytesWritten)) {
+            fastFree(output);
+            return { };
+        }
+    }
+
+    GRefPtr<SoupBuffer> buffer = adoptGRef(soup_buffer_new_with_owner(output, outputOffset, output, fastFree));
+    return { WTFMove(buffer) };
+}
+
+Data compress(const Data& data)
+{
+    GRefPtr<GZlibCompressor> compressor = adoptGRef(g_zlib_compressor_new(G_ZLIB_COMPRESSOR_FORMAT_RAW, -1));
+    // Compressed data is only useful if it is smaller than the original.
+    return convert(G_CONVERTER(compressor.get()), data, data.size() - 1);
+}
+
+Data decompress(const Data& data, size_t decompressedSize)
+{
+    GRefPtr<GZlibDecompressor> decompressor = adoptGRef(g_zlib_decompressor_new(G_ZLIB_COMPRESSOR_FORMAT_RAW));
+    auto decompressedData = convert(G_CONVERTER(decompressor.get()), data, decompressedSize);
+    if (decompressedData.size() != decompressedSize)
+        return { };
+    return decompressedData;
+}
+
 } // namespace NetworkCache
 } // namespace WebKit
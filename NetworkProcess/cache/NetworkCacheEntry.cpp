@@ -80,6 +80,16 @@ Entry::Entry(const Storage::Record& storageEntry)
     ASSERT(m_key.type() == "Resource");
 }
 
+static bool isCompressibleMIMEType(const String& mimeType)
+{
+    // Images and media are already compressed.
+    return startsWithLettersIgnoringASCIICase(mimeType, "text/")
+        || mimeType.endsWithIgnoringASCIICase("javascript")
+        || mimeType.endsWithIgnoringASCIICase("json")
+        || mimeType.endsWithIgnoringASCIICase("xml")
+        || equalLettersIgnoringASCIICase(mimeType, "application/wasm");
+}
+
 Storage::Record Entry::encodeAsStorageRecord() const
 {
     WTF::Persistence::Encoder encoder;
@@ -104,7 +114,7 @@ Storage::Record Entry::encodeAsStorageRecord() const
     if (m_buffer)
         body = { reinterpret_cast<const uint8_t*>(m_buffer->data()), m_buffer->size() };
 
-    return { m_key, m_timeStamp, header, body, { } };
+    return { m_key, m_timeStamp, header, body, { }, isCompressibleMIMEType(m_response.mimeType()) };
 }
 
 std::unique_ptr<Entry> Entry::decodeStorageRecord(const Storage::Record& storageEntry)
@@ -126,5 +126,22 @@ void updateFileModificationTimeIfNeeded(const String& path)
 #endif
 }
 
+bool isOnSameVolume(const String& path, const String& otherPath)
+{
+#if !OS(WINDOWS)
+    struct stat fileInfo;
+    if (stat(FileSystem::fileSystemRepresentation(path).data(), &fileInfo))
+        return false;
+    struct stat otherFileInfo;
+    if (stat(FileSystem::fileSystemRepresentation(otherPath).data(), &otherFileInfo))
+        return false;
+    return fileInfo.st_dev == otherFileInfo.st_dev;
+#else
+    UNUSED_PARAM(path);
+    UNUSED_PARAM(otherPath);
+    return false;
+#endif
+}
+
 }
 }
@@ -42,5 +42,8 @@ struct FileTimes {
 FileTimes fileTimes(const String& path);
 void updateFileModificationTimeIfNeeded(const String& path);
 
+// Hard links can only be created between paths on the same volume.
+bool isOnSameVolume(const String& path, const String& otherPath);
+
 }
 }
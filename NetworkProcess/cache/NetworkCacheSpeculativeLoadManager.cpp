@@ -212,6 +212,17 @@ public:
 
     void addPostMainResourceResponseTask(Function<void()>&& task) { m_postMainResourceResponseTasks.append(WTFMove(task)); }
 
+    const HashSet<String>& predictedOrigins() const { return m_predictedOrigins; }
+    void setPredictedOrigins(HashSet<String>&& origins) { m_predictedOrigins = WTFMove(origins); }
+
+    HashSet<String> subresourceOrigins() const
+    {
+        HashSet<String> origins;
+        for (auto& subresourceLoad : m_subresourceLoads)
+            origins.add(subresourceLoad->request.url().protocolHostAndPort());
+        return origins;
+    }
+
 private:
     PendingFrameLoad(Storage& storage, const Key& mainResourceKey, WTF::Function<void()>&& loadCompletionHandler)
         : m_storage(storage)
@@ -252,6 +263,7 @@ private:
     PAL::HysteresisActivity m_loadHysteresisActivity;
     std::unique_ptr<SubresourcesEntry> m_existingEntry;
     Vector<Function<void()>> m_postMainResourceResponseTasks;
+    HashSet<String> m_predictedOrigins;
     bool m_didFinishLoad { false };
     bool m_didRetrieveExistingEntry { false };
     bool m_didReceiveMainResourceResponse { false };
@@ -360,12 +372,21 @@ void SpeculativeLoadManager::registerLoad(const GlobalFrameID& frameID, const Re
         ASSERT(!m_pendingFrameLoads.contains(frameID));
 
         // Start tracking loads in this frame.
-        auto pendingFrameLoad = PendingFrameLoad::create(m_storage, resourceKey, [this, frameID] {
+        auto pendingFrameLoad = PendingFrameLoad::create(m_storage, resourceKey, [this, frameID, domain = RegistrableDomain { request.url() }, mainResourceOrigin = request.url().protocolHostAndPort()] {
+            if (auto* pendingFrameLoad = m_pendingFrameLoads.get(frameID)) {
+                // The main resource load connects to its own origin, so it is never worth predicting.
+                auto loadedOrigins = pendingFrameLoad->subresourceOrigins();
+                loadedOrigins.remove(mainResourceOrigin);
+                learnSubresourceOrigins(domain, pendingFrameLoad->predictedOrigins(), loadedOrigins);
+            }
             bool wasRemoved = m_pendingFrameLoads.remove(frameID);
             ASSERT_UNUSED(wasRemoved, wasRemoved);
         });
         m_pendingFrameLoads.add(frameID, pendingFrameLoad.copyRef());
 
+        // Warm up connections to the origins this domain usually loads from, without waiting for the subresources entry.
+        pendingFrameLoad->setPredictedOrigins(preconnectToPredictedOrigins(frameID, request, isNavigatingToAppBoundDomain));
+
         // Retrieve the subresources entry if it exists to start speculative revalidation and to update it.
         retrieveSubresourcesEntry(resourceKey, [this, weakThis = makeWeakPtr(*this), frameID, pendingFrameLoad = WTFMove(pendingFrameLoad), isNavigatingToAppBoundDomain](std::unique_ptr<SubresourcesEntry> entry) {
             if (!weakThis)
@@ -450,7 +471,7 @@ bool SpeculativeLoadManager::satisfyPendingRequests(const Key& key, Entry* entry
     return true;
 }
 
-void SpeculativeLoadManager::preconnectForSubresource(const SubresourceInfo& subresourceInfo, Entry* entry, const GlobalFrameID& frameID, Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain)
+void SpeculativeLoadManager::startPreconnect(ResourceRequest&& request, const GlobalFrameID& frameID, Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain)
 {
 #if ENABLE(SERVER_PRECONNECT)
     auto* networkSession = m_cache.networkProcess().networkSession(m_cache.sessionID());
@@ -465,16 +486,124 @@ void SpeculativeLoadManager::preconnectForSubresource(const SubresourceInfo& sub
     parameters.contentSniffingPolicy = ContentSniffingPolicy::DoNotSniffContent;
     parameters.contentEncodingSniffingPolicy = ContentEncodingSniffingPolicy::Sniff;
     parameters.shouldPreconnectOnly = PreconnectOnly::Yes;
-    parameters.request = constructRevalidationRequest(subresourceInfo.key(), subresourceInfo, entry);
+    parameters.request = WTFMove(request);
     parameters.isNavigatingToAppBoundDomain = isNavigatingToAppBoundDomain;
     (new PreconnectTask(*networkSession, WTFMove(parameters), [](const WebCore::ResourceError&) { }))->start();
 #else
-    UNUSED_PARAM(subresourceInfo);
-    UNUSED_PARAM(entry);
+    UNUSED_PARAM(request);
     UNUSED_PARAM(frameID);
+    UNUSED_PARAM(isNavigatingToAppBoundDomain);
 #endif
 }
 
+void SpeculativeLoadManager::preconnectForSubresource(const SubresourceInfo& subresourceInfo, Entry* entry, const GlobalFrameID& frameID, Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain)
+{
+    startPreconnect(constructRevalidationRequest(subresourceInfo.key(), subresourceInfo, entry), frameID, isNavigatingToAppBoundDomain);
+}
+
+static const unsigned maximumSubresourceOriginScore = 4;
+static const size_t maximumSubresourceOriginsPerDomain = 16;
+static const size_t maximumPreconnectsPerLoad = 6;
+static const size_t maximumDomainsWithSubresourceOrigins = 512;
+
+HashSet<String> SpeculativeLoadManager::preconnectToPredictedOrigins(const GlobalFrameID& frameID, const ResourceRequest& mainResourceRequest, Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain)
+{
+    auto iterator = m_subresourceOriginScores.find(RegistrableDomain { mainResourceRequest.url() });
+    if (iterator == m_subresourceOriginScores.end())
+        return { };
+
+    // The connection to the main resource origin is already being established by the main resource load.
+    auto mainResourceOrigin = mainResourceRequest.url().protocolHostAndPort();
+
+    Vector<std::pair<String, unsigned>> candidates;
+    for (auto& [origin, score] : iterator->value) {
+        if (origin != mainResourceOrigin)
+            candidates.append({ origin, score });
+    }
+    std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) {
+        return a.second > b.second;
+    });
+    if (candidates.size() > maximumPreconnectsPerLoad)
+        candidates.shrink(maximumPreconnectsPerLoad);
+
+    RegistrableDomain firstPartyDomain { mainResourceRequest.firstPartyForCookies() };
+
+    HashSet<String> predictedOrigins;
+    for (auto& candidate : candidates) {
+        URL url { URL { }, candidate.first };
+        if (!url.isValid())
+            continue;
+
+        LOG(NetworkCacheSpeculativePreloading, "(NetworkProcess) Preconnecting to predicted origin '%s' (score=%u)", candidate.first.utf8().data(), candidate.second);
+        ResourceRequest request { url };
+        request.setFirstPartyForCookies(mainResourceRequest.firstPartyForCookies());
+        request.setIsSameSite(firstPartyDomain.matches(url));
+        request.setIsTopSite(false);
+        startPreconnect(WTFMove(request), frameID, isNavigatingToAppBoundDomain);
+        predictedOrigins.add(candidate.first);
+    }
+    return predictedOrigins;
+}
+
+void SpeculativeLoadManager::clearSubresourceOriginScores()
+{
+    m_subresourceOriginScores.clear();
+    m_subresourceOriginScoresRecency.clear();
+}
+
+void SpeculativeLoadManager::learnSubresourceOrigins(const RegistrableDomain& domain, const HashSet<String>& predictedOrigins, const HashSet<String>& loadedOrigins)
+{
+    if (domain.isEmpty())
+        return;
+
+    size_t usedPredictedOriginCount = 0;
+    for (auto& origin : predictedOrigins) {
+        if (loadedOrigins.contains(origin))
+            ++usedPredictedOriginCount;
+    }
+    m_preconnectPredictionStatistics.predictedOriginCount += predictedOrigins.size();
+    m_preconnectPredictionStatistics.usedPredictedOriginCount += usedPredictedOriginCount;
+    m_preconnectPredictionStatistics.loadedOriginCount += loadedOrigins.size();
+    RELEASE_LOG(NetworkCacheSpeculativePreloading, "%p - SpeculativeLoadManager::learnSubresourceOrigins: predicted=%zu, used=%zu, loaded=%zu (cumulative precision=%" PRIu64 "/%" PRIu64 ", recall=%" PRIu64 "/%" PRIu64 ")", this, predictedOrigins.size(), usedPredictedOriginCount, loadedOrigins.size(), m_preconnectPredictionStatistics.usedPredictedOriginCount, m_preconnectPredictionStatistics.predictedOriginCount, m_preconnectPredictionStatistics.usedPredictedOriginCount, m_preconnectPredictionStatistics.loadedOriginCount);
+
+    auto& scores = m_subresourceOriginScores.ensure(domain, [] {
+        return HashMap<String, unsigned> { };
+    }).iterator->value;
+
+    // Origins that were predicted but not used lose credit, so that stale third parties stop being warmed up.
+    for (auto& origin : predictedOrigins) {
+        if (loadedOrigins.contains(origin))
+            continue;
+        auto iterator = scores.find(origin);
+        if (iterator != scores.end() && !--iterator->value)
+            scores.remove(iterator);
+    }
+
+    for (auto& origin : loadedOrigins) {
+        auto addResult = scores.add(origin, 0);
+        addResult.iterator->value = std::min(addResult.iterator->value + 1, maximumSubresourceOriginScore);
+    }
+
+    while (scores.size() > maximumSubresourceOriginsPerDomain) {
+        auto lowest = scores.begin();
+        for (auto iterator = scores.begin(); iterator != scores.end(); ++iterator) {
+            if (iterator->value < lowest->value)
+                lowest = iterator;
+        }
+        scores.remove(lowest);
+    }
+
+    if (scores.isEmpty()) {
+        m_subresourceOriginScores.remove(domain);
+        m_subresourceOriginScoresRecency.remove(domain);
+        return;
+    }
+
+    m_subresourceOriginScoresRecency.appendOrMoveToLast(domain);
+    if (m_subresourceOriginScoresRecency.size() > maximumDomainsWithSubresourceOrigins)
+        m_subresourceOriginScores.remove(m_subresourceOriginScoresRecency.takeFirst());
+}
+
 void SpeculativeLoadManager::revalidateSubresource(const SubresourceInfo& subresourceInfo, std::unique_ptr<Entry> entry, const GlobalFrameID& frameID, Optional<NavigatingToAppBoundDomain> isNavigatingToAppBoundDomain)
 {
     ASSERT(!entry || entry->needsValidation());
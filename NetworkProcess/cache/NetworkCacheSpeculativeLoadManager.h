@@ -30,8 +30,11 @@
 
 #include "NetworkCache.h"
 #include "NetworkCacheStorage.h"
+#include <WebCore/RegistrableDomain.h>
 #include <WebCore/ResourceRequest.h>
 #include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/Vector.h>
 #include <wtf/WeakPtr.h>
 
@@ -58,6 +61,8 @@ public:
     bool canRetrieve(const Key& storageKey, const WebCore::ResourceRequest&, const GlobalFrameID&) const;
     void retrieve(const Key& storageKey, RetrieveCompletionHandler&&);
 
+    void clearSubresourceOriginScores();
+
 private:
     class PreloadedEntry;
 
@@ -67,6 +72,9 @@ private:
     void retrieveEntryFromStorage(const SubresourceInfo&, RetrieveCompletionHandler&&);
     void revalidateSubresource(const SubresourceInfo&, std::unique_ptr<Entry>, const GlobalFrameID&, Optional<NavigatingToAppBoundDomain>);
     void preconnectForSubresource(const SubresourceInfo&, Entry*, const GlobalFrameID&, Optional<NavigatingToAppBoundDomain>);
+    void startPreconnect(WebCore::ResourceRequest&&, const GlobalFrameID&, Optional<NavigatingToAppBoundDomain>);
+    HashSet<String> preconnectToPredictedOrigins(const GlobalFrameID&, const WebCore::ResourceRequest& mainResourceRequest, Optional<NavigatingToAppBoundDomain>);
+    void learnSubresourceOrigins(const WebCore::RegistrableDomain&, const HashSet<String>& predictedOrigins, const HashSet<String>& loadedOrigins);
     bool satisfyPendingRequests(const Key&, Entry*);
     void retrieveSubresourcesEntry(const Key& storageKey, WTF::Function<void (std::unique_ptr<SubresourcesEntry>)>&&);
     void startSpeculativeRevalidation(const GlobalFrameID&, SubresourcesEntry&, Optional<NavigatingToAppBoundDomain>);
@@ -87,6 +95,17 @@ private:
 
     class ExpiringEntry;
     HashMap<Key, std::unique_ptr<ExpiringEntry>> m_notPreloadedEntries; // For logging.
+
+    // Scores of the subresource origins seen under each top-level domain, used to warm up connections on navigation.
+    HashMap<WebCore::RegistrableDomain, HashMap<String, unsigned>> m_subresourceOriginScores;
+    ListHashSet<WebCore::RegistrableDomain> m_subresourceOriginScoresRecency;
+
+    struct PreconnectPredictionStatistics {
+        uint64_t predictedOriginCount { 0 };
+        uint64_t usedPredictedOriginCount { 0 };
+        uint64_t loadedOriginCount { 0 };
+    };
+    PreconnectPredictionStatistics m_preconnectPredictionStatistics;
 };
 
 } // namespace NetworkCache
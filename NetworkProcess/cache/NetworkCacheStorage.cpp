@@ -54,6 +54,11 @@ static inline size_t maximumInlineBodySize()
     return WTF::pageSize();
 }
 
+#if USE(SOUP)
+// Larger bodies are kept uncompressed in blobs so they can be memory mapped and shared.
+static const size_t maximumCompressedBodySize = 128 * KB;
+#endif
+
 static double computeRecordWorth(FileTimes);
 
 struct Storage::ReadOperation {
@@ -179,7 +184,7 @@ static String makeSaltFilePath(const String& baseDirectoryPath)
     return FileSystem::pathByAppendingComponent(makeVersionedDirectoryPath(baseDirectoryPath), saltFileName);
 }
 
-RefPtr<Storage> Storage::open(const String& baseCachePath, Mode mode, size_t capacity)
+RefPtr<Storage> Storage::open(const String& baseCachePath, Mode mode, size_t capacity, const String& sharedBlobsPath)
 {
     ASSERT(RunLoop::isMain());
     ASSERT(!baseCachePath.isNull());
@@ -193,7 +198,17 @@ RefPtr<Storage> Storage::open(const String& baseCachePath, Mode mode, size_t cap
     if (!salt)
         return nullptr;
 
-    return adoptRef(new Storage(cachePath, mode, *salt, capacity));
+    if (!sharedBlobsPath.isEmpty()) {
+        auto blobsPath = makeCachePath(sharedBlobsPath);
+        if (FileSystem::makeAllDirectories(makeVersionedDirectoryPath(blobsPath)) && isOnSameVolume(makeVersionedDirectoryPath(cachePath), makeVersionedDirectoryPath(blobsPath))) {
+            // Blob hashes must be comparable between all the clients so the shared directory has a salt of its own.
+            if (auto blobSalt = readOrMakeSalt(makeSaltFilePath(blobsPath)))
+                return adoptRef(new Storage(cachePath, mode, *salt, capacity, blobsPath, *blobSalt, BlobStorage::Sharing::Shared));
+        }
+        LOG(NetworkCacheStorage, "(NetworkProcess) unable to use shared blob storage at %s", sharedBlobsPath.utf8().data());
+    }
+
+    return adoptRef(new Storage(cachePath, mode, *salt, capacity, cachePath, *salt, BlobStorage::Sharing::Private));
 }
 
 using RecordFileTraverseFunction = Function<void (const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath)>;
@@ -243,8 +258,9 @@ static void deleteEmptyRecordsDirectories(const String& recordsPath)
     });
 }
 
-Storage::Storage(const String& baseDirectoryPath, Mode mode, Salt salt, size_t capacity)
+Storage::Storage(const String& baseDirectoryPath, Mode mode, Salt salt, size_t capacity, const String& blobsBasePath, Salt blobSalt, BlobStorage::Sharing blobSharing)
     : m_basePath(baseDirectoryPath)
+    , m_sharedBlobsBasePath(blobSharing == BlobStorage::Sharing::Shared ? blobsBasePath : String())
     , m_recordsPath(makeRecordsDirectoryPath(baseDirectoryPath))
     , m_mode(mode)
     , m_salt(salt)
@@ -254,7 +270,7 @@ Storage::Storage(const String& baseDirectoryPath, Mode mode, Salt salt, size_t c
     , m_ioQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage", WorkQueue::Type::Concurrent))
     , m_backgroundIOQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage.background", WorkQueue::Type::Concurrent, WorkQueue::QOS::Background))
     , m_serialBackgroundIOQueue(WorkQueue::create("com.apple.WebKit.Cache.Storage.serialBackground", WorkQueue::Type::Serial, WorkQueue::QOS::Background))
-    , m_blobStorage(makeBlobDirectoryPath(baseDirectoryPath), m_salt)
+    , m_blobStorage(makeBlobDirectoryPath(blobsBasePath), blobSalt, blobSharing)
 {
     ASSERT(RunLoop::isMain());
 
@@ -318,6 +334,7 @@ void Storage::synchronize()
         size_t recordsSize = 0;
         unsigned recordCount = 0;
         unsigned blobCount = 0;
+        size_t sharedBlobsSize = 0;
 
         String anyType;
         traverseRecordsFiles(recordsPathIsolatedCopy(), anyType, [&](const String& fileName, const String& hashString, const String& type, bool isBlob, const String& recordDirectoryPath) {
@@ -332,6 +349,9 @@ void Storage::synchronize()
             if (isBlob) {
                 ++blobCount;
                 blobFilter->add(hash);
+                // Only count the blobs this cache links to, the shared directory also holds the other caches' blobs.
+                if (m_blobStorage.isShared())
+                    sharedBlobsSize += m_blobStorage.approximateShareOfSize(filePath);
                 return;
             }
 
@@ -343,10 +363,12 @@ void Storage::synchronize()
         recordsSize = estimateRecordsSize(recordCount, blobCount);
 
         m_blobStorage.synchronize();
+        if (m_blobStorage.isShared())
+            m_blobStorage.setApproximateSize(sharedBlobsSize);
 
         deleteEmptyRecordsDirectories(recordsPathIsolatedCopy());
 
-        LOG(NetworkCacheStorage, "(NetworkProcess) cache synchronization completed size=%zu recordCount=%u", recordsSize, recordCount);
+        LOG(NetworkCacheStorage, "(NetworkProcess) cache synchronization completed size=%zu recordCount=%u blobBytesSaved=%zu", recordsSize, recordCount, m_blobStorage.approximateBytesSaved());
 
         RunLoop::main().dispatch([this, protectedThis = WTFMove(protectedThis), recordFilter = WTFMove(recordFilter), blobFilter = WTFMove(blobFilter), recordsSize]() mutable {
             for (auto& recordFilterKey : m_recordFilterHashesAddedDuringSynchronization)
@@ -428,6 +450,8 @@ struct RecordMetaData {
     SHA1::Digest bodyHash;
     uint64_t bodySize { 0 };
     bool isBodyInline { false };
+    bool isBodyCompressed { false };
+    uint64_t compressedBodySize { 0 };
 
     // Not encoded as a field. Header starts immediately after meta data.
     uint64_t headerOffset { 0 };
@@ -487,6 +511,24 @@ static WARN_UNUSED_RETURN bool decodeRecordMetaData(RecordMetaData& metaData, co
             return false;
         metaData.isBodyInline = WTFMove(*isBodyInline);
 
+#if USE(SOUP)
+        Optional<bool> isBodyCompressed;
+        decoder >> isBodyCompressed;
+        if (!isBodyCompressed)
+            return false;
+        metaData.isBodyCompressed = WTFMove(*isBodyCompressed);
+
+        Optional<uint64_t> compressedBodySize;
+        decoder >> compressedBodySize;
+        if (!compressedBodySize)
+            return false;
+        metaData.compressedBodySize = WTFMove(*compressedBodySize);
+
+        // Only inline bodies up to maximumCompressedBodySize are compressed. Don't trust a corrupted record to size the decompression buffer.
+        if (metaData.isBodyCompressed && (!metaData.isBodyInline || metaData.bodySize > maximumCompressedBodySize || metaData.compressedBodySize > metaData.bodySize))
+            return false;
+#endif
+
         if (!decoder.verifyChecksum())
             return false;
 
@@ -536,9 +578,19 @@ void Storage::readRecord(ReadOperation& readOperation, const Data& recordData)
     Data bodyData;
     if (metaData.isBodyInline) {
         size_t bodyOffset = metaData.headerOffset + headerData.size();
-        if (bodyOffset + metaData.bodySize != recordData.size())
+        size_t storedBodySize = metaData.isBodyCompressed ? metaData.compressedBodySize : metaData.bodySize;
+        if (bodyOffset + storedBodySize != recordData.size())
             return;
-        bodyData = recordData.subrange(bodyOffset, metaData.bodySize);
+        bodyData = recordData.subrange(bodyOffset, storedBodySize);
+#if USE(SOUP)
+        if (metaData.isBodyCompressed) {
+            bodyData = decompress(bodyData, metaData.bodySize);
+            if (bodyData.isNull()) {
+                LOG(NetworkCacheStorage, "(NetworkProcess) body decompression failure");
+                return;
+            }
+        }
+#endif
         if (metaData.bodyHash != computeSHA1(bodyData, m_salt))
             return;
     }
@@ -565,6 +617,10 @@ static Data encodeRecordMetaData(const RecordMetaData& metaData)
     encoder << metaData.bodyHash;
     encoder << metaData.bodySize;
     encoder << metaData.isBodyInline;
+#if USE(SOUP)
+    encoder << metaData.isBodyCompressed;
+    encoder << metaData.compressedBodySize;
+#endif
 
     encoder.encodeChecksum();
 
@@ -596,9 +652,10 @@ Optional<BlobStorage::Blob> Storage::storeBodyAsBlob(WriteOperation& writeOperat
     return blob;
 }
 
-Data Storage::encodeRecord(const Record& record, Optional<BlobStorage::Blob> blob)
+Data Storage::encodeRecord(const Record& record, Optional<BlobStorage::Blob> blob, const Data& compressedBody)
 {
     ASSERT(!blob || bytesEqual(blob.value().data, record.body));
+    ASSERT(!blob || compressedBody.isNull());
 
     RecordMetaData metaData(record.key);
     metaData.timeStamp = record.timeStamp;
@@ -607,10 +664,14 @@ Data Storage::encodeRecord(const Record& record, Optional<BlobStorage::Blob> blo
     metaData.bodyHash = blob ? blob.value().hash : computeSHA1(record.body, m_salt);
     metaData.bodySize = record.body.size();
     metaData.isBodyInline = !blob;
+    metaData.isBodyCompressed = !compressedBody.isNull();
+    metaData.compressedBodySize = compressedBody.size();
 
     auto encodedMetaData = encodeRecordMetaData(metaData);
     auto headerData = concatenate(encodedMetaData, record.header);
 
+    if (metaData.isBodyCompressed)
+        return concatenate(headerData, compressedBody);
     if (metaData.isBodyInline)
         return concatenate(headerData, record.body);
 
@@ -841,6 +902,35 @@ bool Storage::shouldStoreBodyAsBlob(const Data& bodyData)
     return bodyData.size() > maximumInlineBodySize();
 }
 
+Data Storage::compressBodyIfNeeded(const Record& record)
+{
+    ASSERT(!RunLoop::isMain());
+
+#if USE(SOUP)
+    if (!record.isBodyCompressible || record.body.size() > maximumCompressedBodySize)
+        return { };
+
+    // Small bodies don't save a meaningful amount of disk space.
+    static const size_t minimumCompressedBodySize = 1 * KB;
+    if (record.body.size() < minimumCompressedBodySize)
+        return { };
+
+    auto compressedBody = compress(record.body);
+    if (compressedBody.isNull())
+        return { };
+
+    // Not worth the decompression cost on retrieve.
+    if (compressedBody.size() > record.body.size() - record.body.size() / 4)
+        return { };
+
+    LOG(NetworkCacheStorage, "(NetworkProcess) compressed body size=%zu compressedSize=%zu", record.body.size(), compressedBody.size());
+    return compressedBody;
+#else
+    UNUSED_PARAM(record);
+    return { };
+#endif
+}
+
 void Storage::dispatchWriteOperation(std::unique_ptr<WriteOperation> writeOperationPtr)
 {
     ASSERT(RunLoop::isMain());
@@ -859,10 +949,11 @@ void Storage::dispatchWriteOperation(std::unique_ptr<WriteOperation> writeOperat
 
         ++writeOperation.activeCount;
 
-        bool shouldStoreAsBlob = shouldStoreBodyAsBlob(writeOperation.record.body);
+        auto compressedBody = compressBodyIfNeeded(writeOperation.record);
+        bool shouldStoreAsBlob = compressedBody.isNull() && shouldStoreBodyAsBlob(writeOperation.record.body);
         auto blob = shouldStoreAsBlob ? storeBodyAsBlob(writeOperation) : WTF::nullopt;
 
-        auto recordData = encodeRecord(writeOperation.record, blob);
+        auto recordData = encodeRecord(writeOperation.record, blob, compressedBody);
 
         auto channel = IOChannel::open(recordPath, IOChannel::Type::Create);
         size_t recordSize = recordData.size();
@@ -1164,27 +1255,34 @@ void Storage::shrink()
     });
 }
 
-void Storage::deleteOldVersions()
+static void deleteOldVersionDirectories(const String& cachePath)
 {
-    backgroundIOQueue().dispatch([cachePath = basePathIsolatedCopy()] () mutable {
-        traverseDirectory(cachePath, [&cachePath](const String& subdirName, DirectoryEntryType type) {
-            if (type != DirectoryEntryType::Directory)
-                return;
-            if (!subdirName.startsWith(versionDirectoryPrefix))
-                return;
-            auto versionString = subdirName.substring(strlen(versionDirectoryPrefix));
-            bool success;
-            unsigned directoryVersion = versionString.toUIntStrict(&success);
-            if (!success)
-                return;
-            if (directoryVersion >= version)
-                return;
+    traverseDirectory(cachePath, [&cachePath](const String& subdirName, DirectoryEntryType type) {
+        if (type != DirectoryEntryType::Directory)
+            return;
+        if (!subdirName.startsWith(versionDirectoryPrefix))
+            return;
+        auto versionString = subdirName.substring(strlen(versionDirectoryPrefix));
+        bool success;
+        unsigned directoryVersion = versionString.toUIntStrict(&success);
+        if (!success)
+            return;
+        if (directoryVersion >= Storage::version)
+            return;
 
-            auto oldVersionPath = FileSystem::pathByAppendingComponent(cachePath, subdirName);
-            LOG(NetworkCacheStorage, "(NetworkProcess) deleting old cache version, path %s", oldVersionPath.utf8().data());
+        auto oldVersionPath = FileSystem::pathByAppendingComponent(cachePath, subdirName);
+        LOG(NetworkCacheStorage, "(NetworkProcess) deleting old cache version, path %s", oldVersionPath.utf8().data());
 
-            deleteDirectoryRecursively(oldVersionPath);
-        });
+        deleteDirectoryRecursively(oldVersionPath);
+    });
+}
+
+void Storage::deleteOldVersions()
+{
+    backgroundIOQueue().dispatch([cachePath = basePathIsolatedCopy(), sharedBlobsPath = m_sharedBlobsBasePath.isolatedCopy()] () mutable {
+        deleteOldVersionDirectories(cachePath);
+        if (!sharedBlobsPath.isNull())
+            deleteOldVersionDirectories(sharedBlobsPath);
     });
 }
 
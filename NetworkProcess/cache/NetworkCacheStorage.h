@@ -48,7 +48,8 @@ class IOChannel;
 class Storage : public ThreadSafeRefCounted<Storage, WTF::DestructionThread::Main> {
 public:
     enum class Mode { Normal, AvoidRandomness };
-    static RefPtr<Storage> open(const String& cachePath, Mode, size_t capacity);
+    // Blobs are stored in sharedBlobsPath when it is given, and deduplicated against all caches using it.
+    static RefPtr<Storage> open(const String& cachePath, Mode, size_t capacity, const String& sharedBlobsPath = { });
 
     struct Record {
         Key key;
@@ -56,6 +57,8 @@ public:
         Data header;
         Data body;
         Optional<SHA1::Digest> bodyHash;
+        // Compressible bodies may be stored compressed instead of as a blob.
+        bool isBodyCompressible { false };
 
         WTF_MAKE_FAST_ALLOCATED;
     };
@@ -105,9 +108,15 @@ public:
     void setCapacity(size_t);
     size_t capacity() const { return m_capacity; }
     size_t approximateSize() const;
+    size_t approximateBlobBytesSaved() const { return m_blobStorage.approximateBytesSaved(); }
 
     // Incrementing this number will delete all existing cache content for everyone. Do you really need to do it?
+#if USE(SOUP)
+    // Version 17 added compressed inline bodies.
+    static const unsigned version = 17;
+#else
     static const unsigned version = 16;
+#endif
 
     String basePathIsolatedCopy() const;
     String versionPath() const;
@@ -120,7 +129,7 @@ public:
     void writeWithoutWaiting() { m_initialWriteDelay = 0_s; };
 
 private:
-    Storage(const String& directoryPath, Mode, Salt, size_t capacity);
+    Storage(const String& directoryPath, Mode, Salt, size_t capacity, const String& blobsBasePath, Salt blobSalt, BlobStorage::Sharing);
 
     String recordDirectoryPathForKey(const Key&) const;
     String recordPathForKey(const Key&) const;
@@ -143,8 +152,9 @@ private:
     void finishWriteOperation(WriteOperation&, int error = 0);
 
     bool shouldStoreBodyAsBlob(const Data& bodyData);
+    Data compressBodyIfNeeded(const Record&);
     Optional<BlobStorage::Blob> storeBodyAsBlob(WriteOperation&);
-    Data encodeRecord(const Record&, Optional<BlobStorage::Blob>);
+    Data encodeRecord(const Record&, Optional<BlobStorage::Blob>, const Data& compressedBody);
     void readRecord(ReadOperation&, const Data&);
 
     void updateFileModificationTime(const String& path);
@@ -161,6 +171,8 @@ private:
     void deleteFiles(const Key&);
 
     const String m_basePath;
+    // Null unless the blobs are in a shared directory.
+    const String m_sharedBlobsBasePath;
     const String m_recordsPath;
     
     const Mode m_mode;
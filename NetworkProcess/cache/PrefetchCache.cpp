@@ -26,6 +26,7 @@
 #include "config.h"
 #include "PrefetchCache.h"
 
+#include "Logging.h"
 #include <WebCore/HTTPHeaderNames.h>
 
 namespace WebKit {
@@ -47,14 +48,33 @@ PrefetchCache::PrefetchCache()
 
 PrefetchCache::~PrefetchCache()
 {
+    logStatistics();
 }
 
+// Prefetched bodies only wait for the navigation that follows, so they are kept in a bounded amount of memory.
+static const size_t maximumSize = 8 * MB;
+static const Seconds expirationTimeout { 5_s };
+
 void PrefetchCache::clear()
 {
     m_expirationTimer.stop();
     m_sessionExpirationList.clear();
-    if (m_sessionPrefetches)
+    if (m_sessionPrefetches) {
+        for (auto& entry : m_sessionPrefetches->values()) {
+            ++m_statistics.wastedCount;
+            m_statistics.wastedBytes += entry->size();
+        }
         m_sessionPrefetches->clear();
+    }
+    m_size = 0;
+
+    logStatistics();
+}
+
+void PrefetchCache::logStatistics() const
+{
+    if (m_statistics.storedCount)
+        RELEASE_LOG(Network, "%p - PrefetchCache::logStatistics: (stored=%" PRIu64 ", hits=%" PRIu64 ", wasted=%" PRIu64 ", hitBytes=%" PRIu64 ", wastedBytes=%" PRIu64 ")", this, m_statistics.storedCount, m_statistics.hitCount, m_statistics.wastedCount, m_statistics.hitBytes, m_statistics.wastedBytes);
 }
 
 std::unique_ptr<PrefetchCache::Entry> PrefetchCache::take(const URL& url)
@@ -67,33 +87,88 @@ std::unique_ptr<PrefetchCache::Entry> PrefetchCache::take(const URL& url)
     });
     auto entry = resources->take(url);
     ASSERT(!entry || !entry->response.httpHeaderField(WebCore::HTTPHeaderName::Vary).contains("Cookie"));
+    if (entry) {
+        ASSERT(m_size >= entry->size());
+        m_size -= entry->size();
+        ++m_statistics.hitCount;
+        m_statistics.hitBytes += entry->size();
+    }
     return entry;
 }
 
-static const Seconds expirationTimeout { 5_s };
-
-void PrefetchCache::store(const URL& requestUrl, WebCore::ResourceResponse&& response, RefPtr<WebCore::SharedBuffer>&& buffer)
+void PrefetchCache::addEntry(const URL& requestUrl, std::unique_ptr<Entry>&& entry)
 {
     if (!m_sessionPrefetches)
         m_sessionPrefetches = makeUnique<PrefetchEntriesMap>();
-    auto addResult = m_sessionPrefetches->add(requestUrl, makeUnique<PrefetchCache::Entry>(WTFMove(response), WTFMove(buffer)));
-    // Limit prefetches for same url to 1.
-    if (!addResult.isNewEntry)
-        return;
+
+    auto size = entry->size();
+    shrinkTo(maximumSize - size);
+
+    m_size += size;
+    ++m_statistics.storedCount;
+    m_sessionPrefetches->add(requestUrl, WTFMove(entry));
     m_sessionExpirationList.append(std::make_tuple(requestUrl, WallTime::now()));
     if (!m_expirationTimer.isActive())
         m_expirationTimer.startOneShot(expirationTimeout);
 }
 
+void PrefetchCache::store(const URL& requestUrl, WebCore::ResourceResponse&& response, RefPtr<WebCore::SharedBuffer>&& buffer)
+{
+    // Limit prefetches for same url to 1.
+    if (m_sessionPrefetches && m_sessionPrefetches->contains(requestUrl))
+        return;
+
+    if (buffer && buffer->size() > maximumSize) {
+        ++m_statistics.wastedCount;
+        m_statistics.wastedBytes += buffer->size();
+        return;
+    }
+
+    addEntry(requestUrl, makeUnique<PrefetchCache::Entry>(WTFMove(response), WTFMove(buffer)));
+}
+
 void PrefetchCache::storeRedirect(const URL& requestUrl, WebCore::ResourceResponse&& redirectResponse, WebCore::ResourceRequest&& redirectRequest)
 {
-    if (!m_sessionPrefetches)
-        m_sessionPrefetches = makeUnique<PrefetchEntriesMap>();
     redirectRequest.clearPurpose();
-    m_sessionPrefetches->set(requestUrl, makeUnique<PrefetchCache::Entry>(WTFMove(redirectResponse), WTFMove(redirectRequest)));
-    m_sessionExpirationList.append(std::make_tuple(requestUrl, WallTime::now()));
-    if (!m_expirationTimer.isActive())
-        m_expirationTimer.startOneShot(expirationTimeout);
+    removeWastedEntry(requestUrl);
+    m_sessionExpirationList.removeAllMatching([&requestUrl] (const auto& tuple) {
+        return std::get<0>(tuple) == requestUrl;
+    });
+    addEntry(requestUrl, makeUnique<PrefetchCache::Entry>(WTFMove(redirectResponse), WTFMove(redirectRequest)));
+}
+
+void PrefetchCache::removeWastedEntry(const URL& requestUrl)
+{
+    if (!m_sessionPrefetches)
+        return;
+
+    auto entry = m_sessionPrefetches->take(requestUrl);
+    if (!entry)
+        return;
+
+    ASSERT(m_size >= entry->size());
+    m_size -= entry->size();
+    ++m_statistics.wastedCount;
+    m_statistics.wastedBytes += entry->size();
+}
+
+void PrefetchCache::shrinkTo(size_t targetSize)
+{
+    // Entries are consumed at most once, so the expiration list is also least-recently-used first.
+    while (m_size > targetSize && !m_sessionExpirationList.isEmpty())
+        removeWastedEntry(std::get<0>(m_sessionExpirationList.takeFirst()));
+
+    if (m_sessionExpirationList.isEmpty())
+        m_expirationTimer.stop();
+}
+
+void PrefetchCache::handleMemoryPressure(bool isCritical)
+{
+    if (isCritical) {
+        clear();
+        return;
+    }
+    shrinkTo(m_size / 2);
 }
 
 void PrefetchCache::clearExpiredEntries()
@@ -101,12 +176,11 @@ void PrefetchCache::clearExpiredEntries()
     auto timeout = WallTime::now();
     while (!m_sessionExpirationList.isEmpty()) {
         auto [requestUrl, timestamp] = m_sessionExpirationList.first();
-        auto* resources = m_sessionPrefetches.get();
-        ASSERT(resources);
-        ASSERT(resources->contains(requestUrl));
+        ASSERT(m_sessionPrefetches);
+        ASSERT(m_sessionPrefetches->contains(requestUrl));
         auto elapsed = timeout - timestamp;
         if (elapsed > expirationTimeout) {
-            resources->remove(requestUrl);
+            removeWastedEntry(requestUrl);
             m_sessionExpirationList.removeFirst();
         } else {
             m_expirationTimer.startOneShot(expirationTimeout - elapsed);
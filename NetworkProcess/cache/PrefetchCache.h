@@ -51,6 +51,7 @@ public:
         Entry(WebCore::ResourceResponse&&, WebCore::ResourceRequest&&);
 
         Ref<WebCore::SharedBuffer> releaseBuffer() { return buffer.releaseNonNull(); }
+        size_t size() const { return buffer ? buffer->size() : 0; }
 
         WebCore::ResourceResponse response;
         RefPtr<WebCore::SharedBuffer> buffer;
@@ -61,8 +62,14 @@ public:
     void store(const URL&, WebCore::ResourceResponse&&, RefPtr<WebCore::SharedBuffer>&&);
     void storeRedirect(const URL&, WebCore::ResourceResponse&&, WebCore::ResourceRequest&&);
 
+    void handleMemoryPressure(bool isCritical);
+
 private:
     void clearExpiredEntries();
+    void logStatistics() const;
+    void addEntry(const URL&, std::unique_ptr<Entry>&&);
+    void removeWastedEntry(const URL&);
+    void shrinkTo(size_t);
 
     using PrefetchEntriesMap = HashMap<URL, std::unique_ptr<Entry>>;
     std::unique_ptr<PrefetchEntriesMap> m_sessionPrefetches;
@@ -71,6 +78,16 @@ private:
     SessionPrefetchExpirationList m_sessionExpirationList;
 
     WebCore::Timer m_expirationTimer;
+    size_t m_size { 0 };
+
+    struct Statistics {
+        uint64_t storedCount { 0 };
+        uint64_t hitCount { 0 };
+        uint64_t wastedCount { 0 };
+        uint64_t hitBytes { 0 };
+        uint64_t wastedBytes { 0 };
+    };
+    Statistics m_statistics;
 };
 
 } // namespace WebKit
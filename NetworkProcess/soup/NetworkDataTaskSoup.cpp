@@ -50,6 +50,8 @@ namespace WebKit {
 using namespace WebCore;
 
 static const size_t gDefaultReadBufferSize = 8192;
+static const unsigned gMaximumDownloadSegmentCount = 4;
+static const uint64_t gMinimumDownloadSegmentSize = 4 * MB;
 
 NetworkDataTaskSoup::NetworkDataTaskSoup(NetworkSession& session, NetworkDataTaskClient& client, const ResourceRequest& requestWithCredentials, FrameIdentifier frameID, PageIdentifier pageID, StoredCredentialsPolicy storedCredentialsPolicy, ContentSniffingPolicy shouldContentSniff, WebCore::ContentEncodingSniffingPolicy, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     : NetworkDataTask(session, client, requestWithCredentials, storedCredentialsPolicy, shouldClearReferrerOnHTTPSToHTTPRedirect, dataTaskIsForMainFrameNavigation)
@@ -253,8 +255,20 @@ void NetworkDataTaskSoup::resume()
     }
 }
 
+void NetworkDataTaskSoup::suspend()
+{
+    if (m_state != State::Running)
+        return;
+
+    // The result of the operation in progress is kept in m_pendingResult until the task is resumed.
+    m_state = State::Suspended;
+    stopTimeout();
+}
+
 void NetworkDataTaskSoup::cancel()
 {
+    cancelDownloadSegments();
+
     if (m_state == State::Canceling || m_state == State::Completed)
         return;
 
@@ -945,7 +959,13 @@ void NetworkDataTaskSoup::download()
         didFailDownload(downloadDestinationError(m_response, error->message));
         return;
     }
-    m_downloadOutputStream = adoptGRef(G_OUTPUT_STREAM(outputStream.leakRef()));
+
+    // Segments write to the intermediate file at their own offsets, so it is only created here.
+    bool useDownloadSegments = shouldUseDownloadSegments();
+    if (useDownloadSegments)
+        g_output_stream_close(G_OUTPUT_STREAM(outputStream.get()), nullptr, nullptr);
+    else
+        m_downloadOutputStream = adoptGRef(G_OUTPUT_STREAM(outputStream.leakRef()));
 
     auto& downloadManager = m_session->networkProcess().downloadManager();
     auto download = makeUnique<Download>(downloadManager, m_pendingDownloadID, *this, *m_session, suggestedFilename());
@@ -954,9 +974,104 @@ void NetworkDataTaskSoup::download()
     downloadPtr->didCreateDestination(m_pendingDownloadLocation);
 
     ASSERT(!m_client);
+    if (useDownloadSegments) {
+        startDownloadSegments(FileSystem::stringFromFileSystemRepresentation(intermediatePath.get()));
+        return;
+    }
     read();
 }
 
+bool NetworkDataTaskSoup::shouldUseDownloadSegments() const
+{
+    if (!static_cast<NetworkSessionSoup&>(*m_session).segmentedDownloadsEnabled())
+        return false;
+
+    if (m_currentRequest.httpMethod() != "GET" || m_currentRequest.hasHTTPHeaderField(HTTPHeaderName::Range) || m_response.httpStatusCode() != 200)
+        return false;
+
+    if (!equalLettersIgnoringASCIICase(m_response.httpHeaderField(HTTPHeaderName::AcceptRanges), "bytes"))
+        return false;
+
+    // Ranges would apply to the encoded bytes, but the body we write is decoded.
+    auto contentEncoding = m_response.httpHeaderField(HTTPHeaderName::ContentEncoding);
+    if (!contentEncoding.isEmpty() && !equalLettersIgnoringASCIICase(contentEncoding, "identity"))
+        return false;
+
+    // A validator is needed to make sure all the segments come from the same version of the resource.
+    auto entityTag = m_response.httpHeaderField(HTTPHeaderName::ETag);
+    if ((entityTag.isEmpty() || entityTag.startsWith("W/")) && m_response.httpHeaderField(HTTPHeaderName::LastModified).isEmpty())
+        return false;
+
+    return m_response.expectedContentLength() >= static_cast<long long>(2 * gMinimumDownloadSegmentSize);
+}
+
+void NetworkDataTaskSoup::startDownloadSegments(const String& path)
+{
+    ASSERT(m_downloadSegments.isEmpty());
+
+    // The body of the initial response is not read. Each segment makes its own range request.
+    stopTimeout();
+    if (m_inputStream) {
+        g_input_stream_close(m_inputStream.get(), nullptr, nullptr);
+        m_inputStream = nullptr;
+    }
+    if (m_soupMessage) {
+        g_signal_handlers_disconnect_matched(m_soupMessage.get(), G_SIGNAL_MATCH_DATA, 0, 0, nullptr, nullptr, this);
+        soup_session_cancel_message(static_cast<NetworkSessionSoup&>(*m_session).soupSession(), m_soupMessage.get(), SOUP_STATUS_CANCELLED);
+        m_soupMessage = nullptr;
+    }
+
+    auto entityTag = m_response.httpHeaderField(HTTPHeaderName::ETag);
+    auto validator = !entityTag.isEmpty() && !entityTag.startsWith("W/") ? entityTag : m_response.httpHeaderField(HTTPHeaderName::LastModified);
+
+    uint64_t contentLength = m_response.expectedContentLength();
+    uint64_t segmentCount = std::min<uint64_t>(gMaximumDownloadSegmentCount, contentLength / gMinimumDownloadSegmentSize);
+    uint64_t segmentLength = contentLength / segmentCount;
+
+    ResourceRequest request = m_currentRequest;
+    request.setURL(m_response.url());
+    for (uint64_t i = 0; i < segmentCount; ++i) {
+        uint64_t offset = i * segmentLength;
+        uint64_t length = i == segmentCount - 1 ? contentLength - offset : segmentLength;
+        m_downloadSegments.append(makeUnique<DownloadSegment>(*this, *m_session, request, m_storedCredentialsPolicy, validator, path, offset, length));
+    }
+
+    for (auto& segment : m_downloadSegments)
+        segment->start();
+}
+
+void NetworkDataTaskSoup::cancelDownloadSegments()
+{
+    m_downloadSegments.clear();
+    m_finishedDownloadSegmentCount = 0;
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidWriteData(DownloadSegment&, uint64_t bytesWritten)
+{
+    auto* download = m_session->networkProcess().downloadManager().download(m_pendingDownloadID);
+    ASSERT(download);
+    download->didReceiveData(bytesWritten, 0, 0);
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidFinish(DownloadSegment& segment)
+{
+    auto* download = m_session->networkProcess().downloadManager().download(m_pendingDownloadID);
+    ASSERT(download);
+    download->didFinishSegment(segment.offset(), segment.bytesReceived(), segment.duration(), segment.retryCount());
+
+    if (++m_finishedDownloadSegmentCount < m_downloadSegments.size())
+        return;
+
+    cancelDownloadSegments();
+    didFinishDownload();
+}
+
+void NetworkDataTaskSoup::downloadSegmentDidFail(DownloadSegment&, const ResourceError& error)
+{
+    RefPtr<NetworkDataTaskSoup> protectedThis(this);
+    didFailDownload(downloadNetworkError(error.failingURL(), error.localizedDescription()));
+}
+
 void NetworkDataTaskSoup::writeDownloadCallback(GOutputStream* outputStream, GAsyncResult* result, NetworkDataTaskSoup* task)
 {
     RefPtr<NetworkDataTaskSoup> protectedThis = adoptRef(task);
@@ -994,9 +1109,10 @@ void NetworkDataTaskSoup::didWriteDownload(gsize bytesWritten)
 void NetworkDataTaskSoup::didFinishDownload()
 {
     ASSERT(!m_response.isNull());
-    ASSERT(m_downloadOutputStream);
-    g_output_stream_close(m_downloadOutputStream.get(), nullptr, nullptr);
-    m_downloadOutputStream = nullptr;
+    if (m_downloadOutputStream) {
+        g_output_stream_close(m_downloadOutputStream.get(), nullptr, nullptr);
+        m_downloadOutputStream = nullptr;
+    }
 
     ASSERT(m_downloadDestinationFile);
     ASSERT(m_downloadIntermediateFile);
@@ -1020,6 +1136,7 @@ void NetworkDataTaskSoup::didFinishDownload()
 
 void NetworkDataTaskSoup::didFailDownload(const ResourceError& error)
 {
+    cancelDownloadSegments();
     clearRequest();
     cleanDownloadFiles();
     if (m_client)
@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include "DownloadSegment.h"
 #include "NetworkDataTask.h"
 #include <WebCore/FrameIdentifier.h>
 #include <WebCore/NetworkLoadMetrics.h>
@@ -36,7 +37,7 @@
 
 namespace WebKit {
 
-class NetworkDataTaskSoup final : public NetworkDataTask {
+class NetworkDataTaskSoup final : public NetworkDataTask, public DownloadSegment::Client {
 public:
     static Ref<NetworkDataTask> create(NetworkSession& session, NetworkDataTaskClient& client, const WebCore::ResourceRequest& request, WebCore::FrameIdentifier frameID, WebCore::PageIdentifier pageID, WebCore::StoredCredentialsPolicy storedCredentialsPolicy, WebCore::ContentSniffingPolicy shouldContentSniff, WebCore::ContentEncodingSniffingPolicy shouldContentEncodingSniff, bool shouldClearReferrerOnHTTPSToHTTPRedirect, bool dataTaskIsForMainFrameNavigation)
     {
@@ -51,6 +52,7 @@ private:
     void cancel() override;
     void resume() override;
     void invalidateAndCancel() override;
+    void suspend() override;
     NetworkDataTask::State state() const override;
 
     void setPendingDownloadLocation(const String&, SandboxExtension::Handle&&, bool /*allowOverwrite*/) override;
@@ -107,6 +109,15 @@ private:
     void didFinishDownload();
     void cleanDownloadFiles();
 
+    bool shouldUseDownloadSegments() const;
+    void startDownloadSegments(const String& path);
+    void cancelDownloadSegments();
+
+    // DownloadSegment::Client.
+    void downloadSegmentDidWriteData(DownloadSegment&, uint64_t bytesWritten) final;
+    void downloadSegmentDidFinish(DownloadSegment&) final;
+    void downloadSegmentDidFail(DownloadSegment&, const WebCore::ResourceError&) final;
+
     void didFail(const WebCore::ResourceError&);
 
     static void networkEventCallback(SoupMessage*, GSocketClientEvent, GIOStream*, NetworkDataTaskSoup*);
@@ -147,6 +158,8 @@ private:
     GRefPtr<GFile> m_downloadIntermediateFile;
     GRefPtr<GOutputStream> m_downloadOutputStream;
     bool m_allowOverwriteDownload { false };
+    Vector<std::unique_ptr<DownloadSegment>> m_downloadSegments;
+    unsigned m_finishedDownloadSegmentCount { 0 };
     WebCore::NetworkLoadMetrics m_networkLoadMetrics;
     MonotonicTime m_startTime;
     bool m_isBlockingCookies { false };
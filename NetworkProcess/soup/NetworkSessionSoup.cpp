@@ -26,10 +26,12 @@
 #include "config.h"
 #include "NetworkSessionSoup.h"
 
+#include "NetworkConnectionToWebProcess.h"
 #include "NetworkProcess.h"
 #include "NetworkSessionCreationParameters.h"
 #include "WebCookieManager.h"
 #include "WebSocketTaskSoup.h"
+#include <WebCore/Cookie.h>
 #include <WebCore/DeprecatedGlobalSettings.h>
 #include <WebCore/NetworkStorageSession.h>
 #include <WebCore/ResourceRequest.h>
@@ -43,6 +45,8 @@ NetworkSessionSoup::NetworkSessionSoup(NetworkProcess& networkProcess, NetworkSe
     : NetworkSession(networkProcess, parameters)
     , m_networkSession(makeUnique<SoupNetworkSession>(m_sessionID))
     , m_persistentCredentialStorageEnabled(parameters.persistentCredentialStorageEnabled)
+    , m_segmentedDownloadsEnabled(parameters.segmentedDownloadsEnabled)
+    , m_webSocketDeflateSettings({ parameters.webSocketDeflateEnabled, parameters.webSocketDeflateClientMaxWindowBits, parameters.webSocketDeflateServerMaxWindowBits, parameters.webSocketDeflateClientNoContextTakeover, parameters.webSocketDeflateServerNoContextTakeover })
 {
     auto* storageSession = networkStorageSession();
     ASSERT(storageSession);
@@ -67,6 +71,8 @@ NetworkSessionSoup::NetworkSessionSoup(NetworkProcess& networkProcess, NetworkSe
 
 NetworkSessionSoup::~NetworkSessionSoup()
 {
+    setCookieJarForChangeNotifications(nullptr);
+
     if (auto* storageSession = networkProcess().storageSession(m_sessionID))
         storageSession->setCookieObserverHandler(nullptr);
 }
@@ -94,6 +100,87 @@ void NetworkSessionSoup::setCookiePersistentStorage(const String& storagePath, S
     storageSession->setCookieStorage(WTFMove(jar));
 
     m_networkSession->setCookieJar(storageSession->cookieStorage());
+
+    if (m_cookieJarForChangeNotifications) {
+        setCookieJarForChangeNotifications(storageSession->cookieStorage());
+
+        // The cookies cached by the observers come from the previous jar.
+        HashSet<NetworkConnectionToWebProcess*> observers;
+        for (auto& hostObservers : m_cookieChangeObservers.values())
+            observers.add(hostObservers.begin(), hostObservers.end());
+        for (auto* observer : observers)
+            observer->allCookiesDeleted();
+    }
+}
+
+void NetworkSessionSoup::startListeningForCookieChangeNotifications(NetworkConnectionToWebProcess& observer, const String& host)
+{
+    auto& observers = m_cookieChangeObservers.ensure(host, [] {
+        return HashSet<NetworkConnectionToWebProcess*> { };
+    }).iterator->value;
+    ASSERT(!observers.contains(&observer));
+    observers.add(&observer);
+
+    if (!m_cookieJarForChangeNotifications) {
+        if (auto* storageSession = networkStorageSession())
+            setCookieJarForChangeNotifications(storageSession->cookieStorage());
+    }
+}
+
+void NetworkSessionSoup::stopListeningForCookieChangeNotifications(NetworkConnectionToWebProcess& observer, const HashSet<String>& hosts)
+{
+    for (auto& host : hosts) {
+        auto it = m_cookieChangeObservers.find(host);
+        if (it == m_cookieChangeObservers.end())
+            continue;
+
+        it->value.remove(&observer);
+        if (it->value.isEmpty())
+            m_cookieChangeObservers.remove(it);
+    }
+
+    if (m_cookieChangeObservers.isEmpty())
+        setCookieJarForChangeNotifications(nullptr);
+}
+
+void NetworkSessionSoup::setCookieJarForChangeNotifications(SoupCookieJar* jar)
+{
+    if (m_cookieJarForChangeNotifications == jar)
+        return;
+
+    if (m_cookieJarForChangeNotifications)
+        g_signal_handlers_disconnect_by_data(m_cookieJarForChangeNotifications.get(), this);
+    m_cookieJarForChangeNotifications = jar;
+    if (m_cookieJarForChangeNotifications)
+        g_signal_connect(m_cookieJarForChangeNotifications.get(), "changed", G_CALLBACK(cookieJarChangedCallback), this);
+}
+
+void NetworkSessionSoup::cookieJarChangedCallback(SoupCookieJar*, SoupCookie* oldCookie, SoupCookie* newCookie, NetworkSessionSoup* session)
+{
+    session->cookieJarChanged(oldCookie, newCookie);
+}
+
+static inline bool isCookieVisibleToHost(SoupCookie* cookie, const char* host)
+{
+    return cookie && !soup_cookie_get_http_only(cookie) && soup_cookie_domain_matches(cookie, host);
+}
+
+void NetworkSessionSoup::cookieJarChanged(SoupCookie* oldCookie, SoupCookie* newCookie)
+{
+    // A replaced cookie has both an old and a new value, it's reported as deleted and then added again.
+    for (auto& entry : m_cookieChangeObservers) {
+        auto host = entry.key.utf8();
+        if (isCookieVisibleToHost(oldCookie, host.data())) {
+            Vector<Cookie> cookies { Cookie(oldCookie) };
+            for (auto* observer : entry.value)
+                observer->cookiesDeleted(entry.key, cookies);
+        }
+        if (isCookieVisibleToHost(newCookie, host.data())) {
+            Vector<Cookie> cookies { Cookie(newCookie) };
+            for (auto* observer : entry.value)
+                observer->cookiesAdded(entry.key, cookies);
+        }
+    }
 }
 
 void NetworkSessionSoup::clearCredentials()
@@ -131,7 +218,7 @@ std::unique_ptr<WebSocketTask> NetworkSessionSoup::createWebSocketTask(NetworkSo
     request.updateSoupMessage(soupMessage.get(), blobRegistry());
     if (request.url().protocolIs("wss"))
         g_signal_connect(soupMessage.get(), "network-event", G_CALLBACK(webSocketMessageNetworkEventCallback), this);
-    return makeUnique<WebSocketTask>(channel, soupSession(), soupMessage.get(), protocol);
+    return makeUnique<WebSocketTask>(channel, soupSession(), soupMessage.get(), protocol, m_webSocketDeflateSettings);
 }
 
 void NetworkSessionSoup::setIgnoreTLSErrors(bool ignoreTLSErrors)
@@ -27,6 +27,10 @@
 
 #include "NetworkSession.h"
 #include "SoupCookiePersistentStorageType.h"
+#include <WebCore/GRefPtrSoup.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/text/StringHash.h>
 
 typedef struct _SoupSession SoupSession;
 
@@ -37,10 +41,21 @@ struct SoupNetworkProxySettings;
 
 namespace WebKit {
 
+class NetworkConnectionToWebProcess;
 class NetworkSocketChannel;
 class WebSocketTask;
 struct NetworkSessionCreationParameters;
 
+struct WebSocketDeflateSettings {
+    bool enabled { true };
+    uint8_t clientMaxWindowBits { 15 };
+    uint8_t serverMaxWindowBits { 15 };
+    bool clientNoContextTakeover { false };
+    bool serverNoContextTakeover { false };
+
+    bool isDefault() const { return clientMaxWindowBits == 15 && serverMaxWindowBits == 15 && !clientNoContextTakeover && !serverNoContextTakeover; }
+};
+
 class NetworkSessionSoup final : public NetworkSession {
 public:
     static std::unique_ptr<NetworkSession> create(NetworkProcess& networkProcess, NetworkSessionCreationParameters&& parameters)
@@ -61,12 +76,28 @@ public:
     void setIgnoreTLSErrors(bool);
     void setProxySettings(WebCore::SoupNetworkProxySettings&&);
 
+    bool segmentedDownloadsEnabled() const { return m_segmentedDownloadsEnabled; }
+    const WebSocketDeflateSettings& webSocketDeflateSettings() const { return m_webSocketDeflateSettings; }
+
+    // Observers are notified of the non HttpOnly cookies added to or deleted from the cookie jar that domain match the host.
+    void startListeningForCookieChangeNotifications(NetworkConnectionToWebProcess&, const String& host);
+    void stopListeningForCookieChangeNotifications(NetworkConnectionToWebProcess&, const HashSet<String>& hosts);
+
 private:
     std::unique_ptr<WebSocketTask> createWebSocketTask(NetworkSocketChannel&, const WebCore::ResourceRequest&, const String& protocol) final;
     void clearCredentials() final;
 
+    static void cookieJarChangedCallback(SoupCookieJar*, SoupCookie* oldCookie, SoupCookie* newCookie, NetworkSessionSoup*);
+    void cookieJarChanged(SoupCookie* oldCookie, SoupCookie* newCookie);
+    void setCookieJarForChangeNotifications(SoupCookieJar*);
+
     std::unique_ptr<WebCore::SoupNetworkSession> m_networkSession;
     bool m_persistentCredentialStorageEnabled { true };
+    bool m_segmentedDownloadsEnabled { false };
+    WebSocketDeflateSettings m_webSocketDeflateSettings;
+
+    HashMap<String, HashSet<NetworkConnectionToWebProcess*>> m_cookieChangeObservers;
+    GRefPtr<SoupCookieJar> m_cookieJarForChangeNotifications;
 };
 
 } // namespace WebKit
@@ -27,6 +27,7 @@
 #include "WebSocketTaskSoup.h"
 
 #include "NetworkProcess.h"
+#include "NetworkSessionSoup.h"
 #include "NetworkSocketChannel.h"
 #include <WebCore/HTTPParsers.h>
 #include <WebCore/ResourceRequest.h>
@@ -38,7 +39,30 @@
 
 namespace WebKit {
 
-WebSocketTask::WebSocketTask(NetworkSocketChannel& channel, SoupSession* session, SoupMessage* msg, const String& protocol)
+#if SOUP_CHECK_VERSION(2, 67, 90)
+static CString deflateExtensionOffer(const WebSocketDeflateSettings& settings)
+{
+    StringBuilder offer;
+    offer.appendLiteral("permessage-deflate");
+    if (settings.clientNoContextTakeover)
+        offer.appendLiteral("; client_no_context_takeover");
+    if (settings.serverNoContextTakeover)
+        offer.appendLiteral("; server_no_context_takeover");
+    if (settings.serverMaxWindowBits < 15) {
+        offer.appendLiteral("; server_max_window_bits=");
+        offer.appendNumber(settings.serverMaxWindowBits);
+    }
+    // Without a value, this lets the server limit the window used to compress the messages we send.
+    offer.appendLiteral("; client_max_window_bits");
+    if (settings.clientMaxWindowBits < 15) {
+        offer.append('=');
+        offer.appendNumber(settings.clientMaxWindowBits);
+    }
+    return offer.toString().utf8();
+}
+#endif
+
+WebSocketTask::WebSocketTask(NetworkSocketChannel& channel, SoupSession* session, SoupMessage* msg, const String& protocol, const WebSocketDeflateSettings& deflateSettings)
     : m_channel(channel)
     , m_handshakeMessage(msg)
     , m_cancellable(adoptGRef(g_cancellable_new()))
@@ -58,6 +82,13 @@ WebSocketTask::WebSocketTask(NetworkSocketChannel& channel, SoupSession* session
     // See https://bugs.webkit.org/show_bug.cgi?id=203404
     soup_message_set_flags(msg, static_cast<SoupMessageFlags>(soup_message_get_flags(msg) | SOUP_MESSAGE_NEW_CONNECTION));
 
+#if SOUP_CHECK_VERSION(2, 67, 90)
+    if (!deflateSettings.enabled)
+        soup_message_disable_feature(msg, SOUP_TYPE_WEBSOCKET_EXTENSION_MANAGER);
+#else
+    UNUSED_PARAM(deflateSettings);
+#endif
+
     soup_session_websocket_connect_async(session, msg, nullptr, protocols.get(), m_cancellable.get(),
         [] (GObject* session, GAsyncResult* result, gpointer userData) {
             GUniqueOutPtr<GError> error;
@@ -79,6 +110,14 @@ WebSocketTask::WebSocketTask(NetworkSocketChannel& channel, SoupSession* session
                 task->didFail(String::fromUTF8(error->message));
         }, this);
 
+#if SOUP_CHECK_VERSION(2, 67, 90)
+    // The handshake request was prepared with the default offer of the extension manager, which doesn't let us
+    // choose the deflate parameters. It's only sent later, so the offer can still be replaced. The parameters
+    // accepted by the server are parsed by the soup deflate extension.
+    if (deflateSettings.enabled && !deflateSettings.isDefault())
+        soup_message_headers_replace(msg->request_headers, "Sec-WebSocket-Extensions", deflateExtensionOffer(deflateSettings).data());
+#endif
+
     g_signal_connect(msg, "starting", G_CALLBACK(+[](SoupMessage* msg, WebSocketTask* task) {
         WebCore::ResourceRequest request;
         request.updateFromSoupMessage(msg);
@@ -32,11 +32,12 @@
 
 namespace WebKit {
 class NetworkSocketChannel;
+struct WebSocketDeflateSettings;
 
 class WebSocketTask {
     WTF_MAKE_FAST_ALLOCATED;
 public:
-    WebSocketTask(NetworkSocketChannel&, SoupSession*, SoupMessage*, const String& protocol);
+    WebSocketTask(NetworkSocketChannel&, SoupSession*, SoupMessage*, const String& protocol, const WebSocketDeflateSettings&);
     ~WebSocketTask();
 
     void sendString(const IPC::DataReference&, CompletionHandler<void()>&&);
@@ -70,6 +70,7 @@ list(APPEND WebKit_SOURCES
 
     Shared/CoordinatedGraphics/threadedcompositor/CompositingRunLoop.cpp
     Shared/CoordinatedGraphics/threadedcompositor/ThreadedCompositor.cpp
+    Shared/CoordinatedGraphics/threadedcompositor/ThreadedCompositorFrameTimeline.cpp
     Shared/CoordinatedGraphics/threadedcompositor/ThreadedDisplayRefreshMonitor.cpp
 
     Shared/Plugins/Netscape/NetscapePluginModuleNone.cpp
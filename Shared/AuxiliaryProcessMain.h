@@ -31,6 +31,11 @@
 #include "WebKit2Initialize.h"
 #include <wtf/RunLoop.h>
 
+#if OS(LINUX)
+#include "AuxiliaryProcessForkServer.h"
+#include <string.h>
+#endif
+
 namespace WebKit {
 
 class AuxiliaryProcessMainBase {
@@ -39,6 +44,11 @@ public:
     virtual bool parseCommandLine(int argc, char** argv);
     virtual void platformFinalize() { }
 
+#if OS(LINUX)
+    // Returns true in the forked processes, with their initialization parameters set, and false in the fork server once it's no longer needed.
+    bool runForkServer(int controlSocket);
+#endif
+
     AuxiliaryProcessInitializationParameters&& takeInitializationParameters() { return WTFMove(m_parameters); }
 
 protected:
@@ -56,10 +66,22 @@ int AuxiliaryProcessMain(int argc, char** argv)
 {
     AuxiliaryProcessMainType auxiliaryMain;
 
+    bool isForkedProcess = false;
+#if OS(LINUX)
+    if (argc == 3 && !strcmp(argv[1], forkServerSwitch)) {
+        // The forked processes only skip loading and linking the executable and loading the ICU data: anything
+        // else initialized before forking would be shared by all of them, including threads, connections and
+        // random number seeds.
+        if (!auxiliaryMain.runForkServer(atoi(argv[2])))
+            return EXIT_SUCCESS;
+        isForkedProcess = true;
+    }
+#endif
+
     if (!auxiliaryMain.platformInitialize())
         return EXIT_FAILURE;
 
-    if (!auxiliaryMain.parseCommandLine(argc, argv))
+    if (!isForkedProcess && !auxiliaryMain.parseCommandLine(argc, argv))
         return EXIT_FAILURE;
 
     InitializeWebKit2();
@@ -37,12 +37,25 @@
 #include <WebCore/TextureMapperLayer.h>
 #include <wtf/Atomics.h>
 
+#if USE(LIBEPOXY)
+#include <epoxy/gl.h>
+#elif USE(OPENGL_ES)
+#include <GLES2/gl2.h>
+#else
+#include <GL/gl.h>
+#endif
+
 namespace WebKit {
 using namespace WebCore;
 
+// Edge distance antialiasing can touch pixels just outside of the layer bounds.
+static constexpr float antialiasingMargin = 1;
+
 CoordinatedGraphicsScene::CoordinatedGraphicsScene(CoordinatedGraphicsSceneClient* client)
     : m_client(client)
 {
+    // The FPS counter is painted on top of the whole viewport every frame.
+    m_damage.isEnabled = !getenv("WEBKIT_SHOW_FPS");
 }
 
 CoordinatedGraphicsScene::~CoordinatedGraphicsScene() = default;
@@ -60,17 +73,39 @@ void CoordinatedGraphicsScene::applyStateChanges(const Vector<CoordinatedGraphic
         commitSceneState(state.nicosia);
 }
 
-void CoordinatedGraphicsScene::paintToCurrentGLContext(const TransformationMatrix& matrix, const FloatRect& clipRect, TextureMapper::PaintFlags PaintFlags)
+static void clearRect(const IntRect& rect, const FloatRect& viewportRect, TextureMapper::PaintFlags paintFlags)
+{
+    // Scissor coordinates have a bottom-left origin, unless the scene is painted mirrored.
+    int y = paintFlags & TextureMapper::PaintingMirrored ? rect.y() : static_cast<int>(viewportRect.maxY()) - rect.maxY();
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(rect.x(), y, rect.width(), rect.height());
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
+}
+
+void CoordinatedGraphicsScene::paintToCurrentGLContext(const TransformationMatrix& matrix, const FloatRect& clipRect, unsigned bufferAge, TextureMapper::PaintFlags PaintFlags)
 {
     updateSceneState();
 
     TextureMapperLayer* currentRootLayer = rootLayer();
-    if (!currentRootLayer)
+    if (!currentRootLayer) {
+        clearRect(enclosingIntRect(clipRect), clipRect, PaintFlags);
         return;
+    }
 
     bool sceneHasRunningAnimations = currentRootLayer->applyAnimationsRecursively(MonotonicTime::now());
+
+    FloatRect frameDamage = computeFrameDamage(matrix, clipRect, sceneHasRunningAnimations);
+    IntRect repaintRect = enclosingIntRect(repaintRectForBufferAge(frameDamage, clipRect, bufferAge));
+    repaintRect.intersect(enclosingIntRect(clipRect));
+    if (repaintRect.isEmpty())
+        return;
+
+    clearRect(repaintRect, clipRect, PaintFlags);
+
     m_textureMapper->beginPainting(PaintFlags);
-    m_textureMapper->beginClip(TransformationMatrix(), FloatRoundedRect(clipRect));
+    m_textureMapper->beginClip(TransformationMatrix(), FloatRoundedRect(repaintRect));
 
     if (currentRootLayer->transform() != matrix)
         currentRootLayer->setTransform(matrix);
@@ -84,6 +119,126 @@ void CoordinatedGraphicsScene::paintToCurrentGLContext(const TransformationMatri
         updateViewport();
 }
 
+FloatRect CoordinatedGraphicsScene::computeFrameDamage(const TransformationMatrix& matrix, const FloatRect& clipRect, bool sceneHasRunningAnimations)
+{
+    // Animations are applied directly to the TextureMapperLayer tree, so the committed layer
+    // state doesn't tell where animated layers were painted, neither in this frame nor in the
+    // one right after the animations end.
+    bool needsFullRepaint = !m_damage.isEnabled || m_damage.needsFullRepaint
+        || sceneHasRunningAnimations || m_damage.previousFrameHadRunningAnimations
+        || matrix != m_damage.viewportTransform || clipRect != m_damage.viewportRect;
+
+    FloatRect damage;
+    HashMap<Nicosia::PlatformLayer::LayerID, FloatRect> layerRects;
+    if (m_nicosia.state.rootLayer)
+        accumulateLayerDamage(*m_nicosia.state.rootLayer, matrix.to2dTransform(), false, damage, layerRects, needsFullRepaint);
+
+    // Layers that went away leave damage behind where they were last painted.
+    for (auto& entry : m_damage.layerRects) {
+        if (!layerRects.contains(entry.key))
+            damage.unite(entry.value);
+    }
+    m_damage.contentsScales.removeIf([&layerRects](auto& entry) {
+        return !layerRects.contains(entry.key);
+    });
+
+    m_damage.layerRects = WTFMove(layerRects);
+    m_damage.damagedLayers.clear();
+    m_damage.damagedLayerRects.clear();
+    m_damage.needsFullRepaint = false;
+    m_damage.previousFrameHadRunningAnimations = sceneHasRunningAnimations;
+    m_damage.viewportTransform = matrix;
+    m_damage.viewportRect = clipRect;
+
+    if (needsFullRepaint)
+        return clipRect;
+
+    damage.intersect(clipRect);
+    return damage;
+}
+
+void CoordinatedGraphicsScene::accumulateLayerDamage(Nicosia::CompositionLayer& compositionLayer, const TransformationMatrix& parentTransform, bool ancestorIsDamaged, FloatRect& damage, HashMap<Nicosia::PlatformLayer::LayerID, FloatRect>& layerRects, bool& needsFullRepaint)
+{
+    TransformationMatrix transform;
+    TransformationMatrix childrenTransform;
+    FloatRect layerRect;
+    bool isDamaged = ancestorIsDamaged || m_damage.damagedLayers.contains(compositionLayer.id());
+    Vector<RefPtr<Nicosia::CompositionLayer>> children;
+
+    compositionLayer.accessCommitted(
+        [&](const Nicosia::CompositionLayer::LayerState& layerState)
+        {
+            // This mirrors the way TextureMapperLayer computes its combined transforms.
+            float originX = layerState.anchorPoint.x() * layerState.size.width();
+            float originY = layerState.anchorPoint.y() * layerState.size.height();
+
+            transform = parentTransform;
+            transform.translate3d(originX + layerState.position.x() - layerState.boundsOrigin.x(), originY + layerState.position.y() - layerState.boundsOrigin.y(), layerState.anchorPoint.z());
+            transform.multiply(layerState.transform);
+
+            childrenTransform = layerState.flags.preserves3D ? transform : transform.to2dTransform();
+            childrenTransform.multiply(layerState.childrenTransform);
+            childrenTransform.translate3d(-originX, -originY, -layerState.anchorPoint.z());
+
+            transform.translate3d(-originX, -originY, -layerState.anchorPoint.z());
+
+            // Filters, reflections and backdrops read or paint outside of the layer bounds, and
+            // the bounds of a layer with a 3D transform can't be reliably mapped to the viewport.
+            if (!layerState.filters.isEmpty() || layerState.replica || layerState.backdropLayer || !transform.isAffine())
+                needsFullRepaint = true;
+
+            FloatRect localRect { { }, layerState.size };
+            localRect.unite(layerState.contentsRect);
+            layerRect = transform.mapRect(localRect);
+            layerRect.inflate(antialiasingMargin);
+
+            if (layerState.mask && m_damage.damagedLayers.contains(layerState.mask->id()))
+                isDamaged = true;
+
+            children = layerState.children;
+        });
+
+    auto previousLayerRect = m_damage.layerRects.get(compositionLayer.id());
+    if (isDamaged || layerRect != previousLayerRect) {
+        damage.unite(previousLayerRect);
+        damage.unite(layerRect);
+    } else {
+        auto it = m_damage.damagedLayerRects.find(compositionLayer.id());
+        if (it != m_damage.damagedLayerRects.end()) {
+            for (auto& rect : it->value) {
+                auto mappedRect = transform.mapRect(rect);
+                mappedRect.inflate(antialiasingMargin);
+                damage.unite(mappedRect);
+            }
+        }
+    }
+    layerRects.add(compositionLayer.id(), layerRect);
+
+    for (auto& child : children)
+        accumulateLayerDamage(*child, childrenTransform, isDamaged, damage, layerRects, needsFullRepaint);
+}
+
+FloatRect CoordinatedGraphicsScene::repaintRectForBufferAge(const FloatRect& frameDamage, const FloatRect& clipRect, unsigned bufferAge)
+{
+    m_damage.history.prepend(frameDamage);
+    if (m_damage.history.size() > maximumBufferAge)
+        m_damage.history.removeLast();
+
+    // Without a known buffer age the contents of the back buffer are undefined.
+    if (!bufferAge || bufferAge > m_damage.history.size())
+        return clipRect;
+
+    // A buffer last presented N frames ago is missing the damage of the last N frames, this one included.
+    FloatRect repaintRect;
+    unsigned frameCount = 0;
+    for (auto& damage : m_damage.history) {
+        if (frameCount++ == bufferAge)
+            break;
+        repaintRect.unite(damage);
+    }
+    return repaintRect;
+}
+
 void CoordinatedGraphicsScene::updateViewport()
 {
     if (m_client)
@@ -231,9 +386,11 @@ void CoordinatedGraphicsScene::updateSceneState()
         Vector<ImageBacking> imageBacking;
     } layersByBacking;
 
+    auto& damage = m_damage;
+
     // Access the scene state and perform state update for each layer.
     m_nicosia.scene->accessState(
-        [this, &layersByBacking](Nicosia::Scene::State& state)
+        [this, &layersByBacking, &damage](Nicosia::Scene::State& state)
         {
             // FIXME: try to minimize the amount of work in case the Scene::State object
             // didn't change (i.e. no layer flush was done), but don't forget to properly
@@ -270,9 +427,19 @@ void CoordinatedGraphicsScene::updateSceneState()
             for (auto& compositionLayer : m_nicosia.state.layers) {
                 auto& layer = texmapLayer(*compositionLayer);
                 compositionLayer->commitState(
-                    [&layer, &layersByBacking]
+                    [&layer, &layersByBacking, &damage]
                     (const Nicosia::CompositionLayer::LayerState& layerState)
                     {
+                        auto& delta = layerState.delta;
+                        if (delta.filtersChanged || delta.backdropFiltersChanged || delta.backdropFiltersRectChanged || delta.replicaChanged)
+                            damage.needsFullRepaint = true;
+                        if (delta.positionChanged || delta.anchorPointChanged || delta.sizeChanged || delta.boundsOriginChanged
+                            || delta.transformChanged || delta.childrenTransformChanged || delta.contentsRectChanged
+                            || delta.contentsTilingChanged || delta.contentsClippingRectChanged || delta.opacityChanged
+                            || delta.solidColorChanged || delta.animationsChanged || delta.childrenChanged || delta.maskChanged
+                            || delta.flagsChanged || delta.repaintCounterChanged || delta.debugBorderChanged || delta.contentLayerChanged)
+                            damage.damagedLayers.add(layer.id());
+
                         if (layerState.delta.positionChanged)
                             layer.setPosition(layerState.position);
                         if (layerState.delta.anchorPointChanged)
@@ -369,6 +536,23 @@ void CoordinatedGraphicsScene::updateSceneState()
 
     {
         for (auto& entry : layersByBacking.backingStore) {
+            auto layerID = entry.layer.get().id();
+            for (auto& tile : entry.update.tilesToCreate)
+                m_damage.contentsScales.set(layerID, tile.scale);
+
+            // Updated tiles only damage their own area, unless the scale of the tiles isn't known.
+            float contentsScale = m_damage.contentsScales.get(layerID);
+            if (!entry.update.tilesToRemove.isEmpty() || !contentsScale)
+                m_damage.damagedLayers.add(layerID);
+            else if (!entry.update.tilesToUpdate.isEmpty()) {
+                auto& damagedRects = m_damage.damagedLayerRects.ensure(layerID, [] { return Vector<FloatRect> { }; }).iterator->value;
+                for (auto& tile : entry.update.tilesToUpdate) {
+                    FloatRect tileRect { tile.tileRect };
+                    tileRect.scale(1 / contentsScale);
+                    damagedRects.append(tileRect);
+                }
+            }
+
             auto& compositionState = entry.backingStore.get().compositionState();
             updateBackingStore(entry.layer.get(), compositionState, entry.update);
 
@@ -381,6 +565,9 @@ void CoordinatedGraphicsScene::updateSceneState()
 
     {
         for (auto& entry : layersByBacking.contentLayer) {
+            // Content layers may present a new buffer with every frame.
+            m_damage.damagedLayers.add(entry.layer.get().id());
+
             auto& proxy = entry.proxy.get();
             if (entry.needsActivation)
                 proxy.activateOnCompositingThread(this, &entry.layer.get());
@@ -392,6 +579,9 @@ void CoordinatedGraphicsScene::updateSceneState()
 
     {
         for (auto& entry : layersByBacking.imageBacking) {
+            if (entry.update.buffer || !entry.update.isVisible)
+                m_damage.damagedLayers.add(entry.layer.get().id());
+
             auto& compositionState = entry.imageBacking.get().compositionState();
             updateImageBacking(entry.layer.get(), compositionState, entry.update);
 
@@ -442,6 +632,11 @@ void CoordinatedGraphicsScene::purgeGLResources()
     m_rootLayer = nullptr;
     m_rootLayerID = 0;
     m_textureMapper = nullptr;
+
+    m_damage.needsFullRepaint = true;
+    m_damage.layerRects.clear();
+    m_damage.contentsScales.clear();
+    m_damage.history.clear();
 }
 
 void CoordinatedGraphicsScene::detach()
@@ -23,6 +23,7 @@
 #if USE(COORDINATED_GRAPHICS)
 
 #include <WebCore/CoordinatedGraphicsState.h>
+#include <WebCore/FloatRect.h>
 #include <WebCore/GraphicsContext.h>
 #include <WebCore/GraphicsLayer.h>
 #include <WebCore/IntRect.h>
@@ -34,7 +35,10 @@
 #include <WebCore/TextureMapperLayer.h>
 #include <WebCore/TextureMapperPlatformLayerProxy.h>
 #include <WebCore/Timer.h>
+#include <WebCore/TransformationMatrix.h>
+#include <wtf/Deque.h>
 #include <wtf/Function.h>
+#include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
 #include <wtf/Lock.h>
 #include <wtf/RunLoop.h>
@@ -64,7 +68,8 @@ public:
     virtual ~CoordinatedGraphicsScene();
 
     void applyStateChanges(const Vector<WebCore::CoordinatedGraphicsState>&);
-    void paintToCurrentGLContext(const WebCore::TransformationMatrix&, const WebCore::FloatRect&, WebCore::TextureMapper::PaintFlags = 0);
+    // bufferAge is the number of frames since the back buffer was last presented, or 0 if its contents are undefined.
+    void paintToCurrentGLContext(const WebCore::TransformationMatrix&, const WebCore::FloatRect&, unsigned bufferAge, WebCore::TextureMapper::PaintFlags = 0);
     void detach();
 
     // The painting thread must lock the main thread to use below two methods, because two methods access members that the main thread manages. See m_client.
@@ -72,7 +77,12 @@ public:
     void purgeGLResources();
 
     bool isActive() const { return m_isActive; }
-    void setActive(bool active) { m_isActive = active; }
+    void setActive(bool active)
+    {
+        if (active && !m_isActive)
+            m_damage.needsFullRepaint = true;
+        m_isActive = active;
+    }
 
 private:
     void commitSceneState(const WebCore::CoordinatedGraphicsState::NicosiaState&);
@@ -86,6 +96,10 @@ private:
 
     void onNewBufferAvailable() override;
 
+    WebCore::FloatRect computeFrameDamage(const WebCore::TransformationMatrix&, const WebCore::FloatRect& clipRect, bool sceneHasRunningAnimations);
+    void accumulateLayerDamage(Nicosia::CompositionLayer&, const WebCore::TransformationMatrix& parentTransform, bool ancestorIsDamaged, WebCore::FloatRect& damage, HashMap<Nicosia::PlatformLayer::LayerID, WebCore::FloatRect>& layerRects, bool& needsFullRepaint);
+    WebCore::FloatRect repaintRectForBufferAge(const WebCore::FloatRect& frameDamage, const WebCore::FloatRect& clipRect, unsigned bufferAge);
+
     struct {
         RefPtr<Nicosia::Scene> scene;
         Nicosia::Scene::State state;
@@ -102,6 +116,23 @@ private:
     Nicosia::PlatformLayer::LayerID m_rootLayerID { 0 };
 
     WebCore::TextureMapperFPSCounter m_fpsCounter;
+
+    static constexpr unsigned maximumBufferAge = 3;
+
+    // Damage is gathered from the layer state changes while updating the scene, and
+    // then mapped to viewport coordinates so that only the damaged area is repainted.
+    struct {
+        bool isEnabled { true };
+        bool needsFullRepaint { true };
+        bool previousFrameHadRunningAnimations { false };
+        HashSet<Nicosia::PlatformLayer::LayerID> damagedLayers;
+        HashMap<Nicosia::PlatformLayer::LayerID, Vector<WebCore::FloatRect>> damagedLayerRects;
+        HashMap<Nicosia::PlatformLayer::LayerID, float> contentsScales;
+        HashMap<Nicosia::PlatformLayer::LayerID, WebCore::FloatRect> layerRects;
+        Deque<WebCore::FloatRect, maximumBufferAge> history;
+        WebCore::TransformationMatrix viewportTransform;
+        WebCore::FloatRect viewportRect;
+    } m_damage;
 };
 
 } // namespace WebKit
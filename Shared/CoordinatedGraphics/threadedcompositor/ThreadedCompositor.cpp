@@ -44,6 +44,15 @@
 #include <GL/gl.h>
 #endif
 
+#if USE(EGL)
+#if USE(LIBEPOXY)
+#include <epoxy/egl.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+#endif
+
 namespace WebKit {
 using namespace WebCore;
 
@@ -170,6 +179,31 @@ void ThreadedCompositor::forceRepaint()
 #endif
 }
 
+unsigned ThreadedCompositor::bufferAge()
+{
+#if USE(EGL)
+    // The context might not be an EGL one (e.g. GLX), in which case there's no current EGL surface.
+    EGLDisplay display = eglGetCurrentDisplay();
+    EGLSurface surface = eglGetCurrentSurface(EGL_DRAW);
+    if (display == EGL_NO_DISPLAY || surface == EGL_NO_SURFACE)
+        return 0;
+
+    if (!m_supportsBufferAge) {
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+        m_supportsBufferAge = extensions && strstr(extensions, "EGL_EXT_buffer_age");
+    }
+    if (!*m_supportsBufferAge)
+        return 0;
+
+    EGLint age = 0;
+    if (!eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, &age) || age < 0)
+        return 0;
+    return age;
+#else
+    return 0;
+#endif
+}
+
 void ThreadedCompositor::renderLayerTree()
 {
     if (!m_scene || !m_scene->isActive())
@@ -216,18 +250,21 @@ void ThreadedCompositor::renderLayerTree()
     if (needsResize)
         m_client.resize(viewportSize);
 
+    m_frameTimeline.willRenderFrame(states.size());
     m_client.willRenderFrame();
 
     if (needsResize)
         glViewport(0, 0, viewportSize.width(), viewportSize.height());
 
-    glClearColor(0, 0, 0, 0);
-    glClear(GL_COLOR_BUFFER_BIT);
-
     m_scene->applyStateChanges(states);
-    m_scene->paintToCurrentGLContext(viewportTransform, FloatRect { FloatPoint { }, viewportSize }, m_paintFlags);
+    m_frameTimeline.didApplyStateChanges();
+
+    // The scene only repaints the area that changed since the back buffer was last presented.
+    m_scene->paintToCurrentGLContext(viewportTransform, FloatRect { FloatPoint { }, viewportSize }, needsResize ? 0 : bufferAge(), m_paintFlags);
+    m_frameTimeline.didPaint();
 
     m_context->swapBuffers();
+    m_frameTimeline.didSwapBuffers();
 
     if (m_scene->isActive())
         m_client.didRenderFrame();
@@ -282,6 +319,7 @@ RefPtr<WebCore::DisplayRefreshMonitor> ThreadedCompositor::displayRefreshMonitor
 void ThreadedCompositor::frameComplete()
 {
     ASSERT(!RunLoop::isMain());
+    m_frameTimeline.didCompleteFrame();
     sceneUpdateFinished();
 }
 
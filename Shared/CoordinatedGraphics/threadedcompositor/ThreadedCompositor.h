@@ -29,6 +29,7 @@
 
 #include "CompositingRunLoop.h"
 #include "CoordinatedGraphicsScene.h"
+#include "ThreadedCompositorFrameTimeline.h"
 #include "ThreadedDisplayRefreshMonitor.h"
 #include <WebCore/CoordinatedGraphicsState.h>
 #include <WebCore/GLContext.h>
@@ -37,6 +38,7 @@
 #include <wtf/Atomics.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/Optional.h>
 #include <wtf/ThreadSafeRefCounted.h>
 
 namespace WebKit {
@@ -76,6 +78,8 @@ public:
 
     void frameComplete();
 
+    const ThreadedCompositorFrameTimeline& frameTimeline() const { return m_frameTimeline; }
+
     void suspend();
     void resume();
 
@@ -89,6 +93,7 @@ private:
     void sceneUpdateFinished();
 
     void createGLContext();
+    unsigned bufferAge();
 
     Client& m_client;
     RefPtr<CoordinatedGraphicsScene> m_scene;
@@ -97,6 +102,7 @@ private:
     uint64_t m_nativeSurfaceHandle;
     WebCore::TextureMapper::PaintFlags m_paintFlags { 0 };
     unsigned m_suspendedCount { 0 };
+    Optional<bool> m_supportsBufferAge;
 
     std::unique_ptr<CompositingRunLoop> m_compositingRunLoop;
 
@@ -112,6 +118,7 @@ private:
     } m_attributes;
 
     Ref<ThreadedDisplayRefreshMonitor> m_displayRefreshMonitor;
+    ThreadedCompositorFrameTimeline m_frameTimeline;
 };
 
 } // namespace WebKit
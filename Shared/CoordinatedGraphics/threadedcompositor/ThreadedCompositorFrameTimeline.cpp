@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ThreadedCompositorFrameTimeline.h"
+
+#if USE(COORDINATED_GRAPHICS)
+
+#include <wtf/JSONValues.h>
+#include <wtf/ProcessID.h>
+
+namespace WebKit {
+
+// The compositor is driven by the display's frame callbacks, which we assume to run at 60Hz.
+static constexpr Seconds expectedFrameInterval { 16.667_ms };
+
+void ThreadedCompositorFrameTimeline::willRenderFrame(unsigned stateChangeCount)
+{
+    LockHolder locker(m_lock);
+
+    Frame frame;
+    frame.frameID = m_nextFrameID++;
+    frame.stateChangeCount = stateChangeCount;
+    frame.renderStart = MonotonicTime::now();
+
+    if (m_frames.size() < capacity)
+        m_frames.append(WTFMove(frame));
+    else
+        m_frames[m_nextIndex] = WTFMove(frame);
+
+    m_currentIndex = m_nextIndex;
+    m_nextIndex = (m_nextIndex + 1) % capacity;
+}
+
+auto ThreadedCompositorFrameTimeline::currentFrame() -> Frame*
+{
+    ASSERT(m_lock.isHeld());
+    if (!m_currentIndex)
+        return nullptr;
+    return &m_frames[*m_currentIndex];
+}
+
+void ThreadedCompositorFrameTimeline::didApplyStateChanges()
+{
+    LockHolder locker(m_lock);
+    if (auto* frame = currentFrame())
+        frame->applyStateChangesEnd = MonotonicTime::now();
+}
+
+void ThreadedCompositorFrameTimeline::didPaint()
+{
+    LockHolder locker(m_lock);
+    if (auto* frame = currentFrame())
+        frame->paintEnd = MonotonicTime::now();
+}
+
+void ThreadedCompositorFrameTimeline::didSwapBuffers()
+{
+    LockHolder locker(m_lock);
+    if (auto* frame = currentFrame())
+        frame->swapBuffersEnd = MonotonicTime::now();
+}
+
+void ThreadedCompositorFrameTimeline::didCompleteFrame()
+{
+    LockHolder locker(m_lock);
+    auto* frame = currentFrame();
+    if (!frame || frame->frameComplete)
+        return;
+
+    frame->frameComplete = MonotonicTime::now();
+
+    // A frame that took longer than two refresh intervals to be presented could not have made the next vsync.
+    if (frame->frameComplete - frame->renderStart > expectedFrameInterval * 2) {
+        frame->missedVSync = true;
+        m_missedVSyncCount++;
+    }
+}
+
+auto ThreadedCompositorFrameTimeline::frames() const -> Vector<Frame>
+{
+    LockHolder locker(m_lock);
+
+    // Return the frames oldest first.
+    Vector<Frame> frames;
+    frames.reserveInitialCapacity(m_frames.size());
+    size_t startIndex = m_frames.size() < capacity ? 0 : m_nextIndex;
+    for (size_t i = 0; i < m_frames.size(); ++i)
+        frames.uncheckedAppend(m_frames[(startIndex + i) % m_frames.size()]);
+    return frames;
+}
+
+uint64_t ThreadedCompositorFrameTimeline::missedVSyncCount() const
+{
+    LockHolder locker(m_lock);
+    return m_missedVSyncCount;
+}
+
+static void appendTraceEvent(JSON::Array& events, const char* name, MonotonicTime start, MonotonicTime end, uint64_t frameID)
+{
+    if (!start || !end || end < start)
+        return;
+
+    auto event = JSON::Object::create();
+    event->setString("name"_s, name);
+    event->setString("cat"_s, "compositor"_s);
+    event->setString("ph"_s, "X"_s);
+    event->setDouble("ts"_s, start.secondsSinceEpoch().microseconds());
+    event->setDouble("dur"_s, (end - start).microseconds());
+    event->setInteger("pid"_s, getCurrentProcessID());
+    event->setInteger("tid"_s, 0);
+
+    auto args = JSON::Object::create();
+    args->setDouble("frameID"_s, frameID);
+    event->setObject("args"_s, WTFMove(args));
+
+    events.pushObject(WTFMove(event));
+}
+
+String ThreadedCompositorFrameTimeline::toTraceEventJSON() const
+{
+    auto events = JSON::Array::create();
+    for (auto& frame : frames()) {
+        appendTraceEvent(events.get(), "Frame", frame.renderStart, frame.frameComplete ? frame.frameComplete : frame.swapBuffersEnd, frame.frameID);
+        appendTraceEvent(events.get(), "ApplyStateChanges", frame.renderStart, frame.applyStateChangesEnd, frame.frameID);
+        appendTraceEvent(events.get(), "Paint", frame.applyStateChangesEnd, frame.paintEnd, frame.frameID);
+        appendTraceEvent(events.get(), "SwapBuffers", frame.paintEnd, frame.swapBuffersEnd, frame.frameID);
+        appendTraceEvent(events.get(), "WaitForFrameComplete", frame.swapBuffersEnd, frame.frameComplete, frame.frameID);
+
+        if (frame.missedVSync) {
+            auto event = JSON::Object::create();
+            event->setString("name"_s, "MissedVSync"_s);
+            event->setString("cat"_s, "compositor"_s);
+            event->setString("ph"_s, "i"_s);
+            event->setString("s"_s, "t"_s);
+            event->setDouble("ts"_s, frame.frameComplete.secondsSinceEpoch().microseconds());
+            event->setInteger("pid"_s, getCurrentProcessID());
+            event->setInteger("tid"_s, 0);
+            events->pushObject(WTFMove(event));
+        }
+    }
+
+    auto trace = JSON::Object::create();
+    trace->setArray("traceEvents"_s, WTFMove(events));
+    trace->setString("displayTimeUnit"_s, "ms"_s);
+    return trace->toJSONString();
+}
+
+} // namespace WebKit
+
+#endif // USE(COORDINATED_GRAPHICS)
@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if USE(COORDINATED_GRAPHICS)
+
+#include <wtf/FastMalloc.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Optional.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebKit {
+
+// Records per-stage timestamps of the most recent composited frames in a fixed-size ring
+// buffer. Frames are recorded on the compositing thread and may be read from any thread.
+class ThreadedCompositorFrameTimeline {
+    WTF_MAKE_NONCOPYABLE(ThreadedCompositorFrameTimeline);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static constexpr size_t capacity = 600;
+
+    struct Frame {
+        uint64_t frameID { 0 };
+        unsigned stateChangeCount { 0 };
+        MonotonicTime renderStart;
+        MonotonicTime applyStateChangesEnd;
+        MonotonicTime paintEnd;
+        MonotonicTime swapBuffersEnd;
+        MonotonicTime frameComplete;
+        bool missedVSync { false };
+    };
+
+    ThreadedCompositorFrameTimeline() = default;
+
+    void willRenderFrame(unsigned stateChangeCount);
+    void didApplyStateChanges();
+    void didPaint();
+    void didSwapBuffers();
+    void didCompleteFrame();
+
+    Vector<Frame> frames() const;
+    uint64_t missedVSyncCount() const;
+
+    // Serializes the recorded frames in the Trace Event Format understood by chrome://tracing and Perfetto.
+    String toTraceEventJSON() const;
+
+private:
+    Frame* currentFrame();
+
+    mutable Lock m_lock;
+    Vector<Frame> m_frames;
+    size_t m_nextIndex { 0 };
+    Optional<size_t> m_currentIndex;
+    uint64_t m_nextFrameID { 1 };
+    uint64_t m_missedVSyncCount { 0 };
+};
+
+} // namespace WebKit
+
+#endif // USE(COORDINATED_GRAPHICS)
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <wtf/Seconds.h>
+
+namespace WebKit {
+
+// Counts latency samples in power-of-two millisecond buckets: [0, 1), [1, 2), [2, 4) ... [1024, infinity).
+class LatencyHistogram {
+public:
+    static constexpr size_t bucketCount = 12;
+
+    void add(Seconds latency)
+    {
+        if (latency < 0_s)
+            latency = 0_s;
+
+        m_buckets[bucketIndex(latency)]++;
+        m_count++;
+        m_total += latency;
+        if (latency > m_maximum)
+            m_maximum = latency;
+    }
+
+    uint64_t count() const { return m_count; }
+    Seconds maximum() const { return m_maximum; }
+    Seconds mean() const { return m_count ? m_total / m_count : 0_s; }
+    const std::array<uint64_t, bucketCount>& buckets() const { return m_buckets; }
+
+    static Seconds bucketUpperBound(size_t index)
+    {
+        if (index + 1 >= bucketCount)
+            return Seconds::infinity();
+        return Seconds::fromMilliseconds(1 << index);
+    }
+
+    // Returns the upper bound of the bucket containing the given percentile, in [0, 1].
+    Seconds percentile(double fraction) const
+    {
+        if (!m_count)
+            return 0_s;
+
+        uint64_t threshold = std::max<uint64_t>(1, std::ceil(fraction * m_count));
+        uint64_t accumulated = 0;
+        for (size_t i = 0; i < bucketCount; ++i) {
+            accumulated += m_buckets[i];
+            if (accumulated >= threshold)
+                return std::min(bucketUpperBound(i), m_maximum);
+        }
+        return m_maximum;
+    }
+
+    void clear() { *this = { }; }
+
+private:
+    static size_t bucketIndex(Seconds latency)
+    {
+        size_t index = 0;
+        while (index + 1 < bucketCount && latency >= bucketUpperBound(index))
+            ++index;
+        return index;
+    }
+
+    std::array<uint64_t, bucketCount> m_buckets { };
+    uint64_t m_count { 0 };
+    Seconds m_total;
+    Seconds m_maximum;
+};
+
+} // namespace WebKit
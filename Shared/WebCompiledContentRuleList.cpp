@@ -28,20 +28,41 @@
 
 #if ENABLE(CONTENT_EXTENSIONS)
 
+#include <wtf/MainThread.h>
+#include <wtf/NeverDestroyed.h>
+
 namespace WebKit {
 
+static Vector<WebCompiledContentRuleList*>& liveCompiledContentRuleLists()
+{
+    static NeverDestroyed<Vector<WebCompiledContentRuleList*>> lists;
+    return lists;
+}
+
 Ref<WebCompiledContentRuleList> WebCompiledContentRuleList::create(WebCompiledContentRuleListData&& data)
 {
+    ASSERT(isMainThread());
+
+    // The same list is sent once per user content controller using it. Reusing the list that is already
+    // mapped keeps one mapping of its bytecode per process. The new mapping is released with the data.
+    for (auto* contentRuleList : liveCompiledContentRuleLists()) {
+        if (contentRuleList->m_data.contentHash == data.contentHash)
+            return makeRef(*contentRuleList);
+    }
+
     return adoptRef(*new WebCompiledContentRuleList(WTFMove(data)));
 }
 
 WebCompiledContentRuleList::WebCompiledContentRuleList(WebCompiledContentRuleListData&& data)
     : m_data(WTFMove(data))
 {
+    liveCompiledContentRuleLists().append(this);
 }
 
 WebCompiledContentRuleList::~WebCompiledContentRuleList()
 {
+    ASSERT(isMainThread());
+    liveCompiledContentRuleLists().removeFirst(this);
 }
 
 bool WebCompiledContentRuleList::conditionsApplyOnlyToDomain() const
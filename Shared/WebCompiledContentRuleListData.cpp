@@ -47,6 +47,7 @@ void WebCompiledContentRuleListData::encode(IPC::Encoder& encoder) const
 #endif
     encoder << SharedMemory::IPCHandle { WTFMove(handle), dataSize };
 
+    encoder << contentHash;
     encoder << conditionsApplyOnlyToDomainOffset;
     encoder << actionsOffset;
     encoder << actionsSize;
@@ -65,6 +66,11 @@ Optional<WebCompiledContentRuleListData> WebCompiledContentRuleListData::decode(
         return WTF::nullopt;
     RefPtr<SharedMemory> data = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
 
+    Optional<SHA1::Digest> contentHash;
+    decoder >> contentHash;
+    if (!contentHash)
+        return WTF::nullopt;
+
     Optional<unsigned> conditionsApplyOnlyToDomainOffset;
     decoder >> conditionsApplyOnlyToDomainOffset;
     if (!conditionsApplyOnlyToDomainOffset)
@@ -112,6 +118,7 @@ Optional<WebCompiledContentRuleListData> WebCompiledContentRuleListData::decode(
 
     return {{
         WTFMove(data),
+        WTFMove(*contentHash),
         WTFMove(*conditionsApplyOnlyToDomainOffset),
         WTFMove(*actionsOffset),
         WTFMove(*actionsSize),
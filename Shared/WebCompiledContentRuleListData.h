@@ -30,6 +30,7 @@
 #include "SharedMemory.h"
 #include <WebCore/SharedBuffer.h>
 #include <wtf/RefPtr.h>
+#include <wtf/SHA1.h>
 #include <wtf/Variant.h>
 
 namespace IPC {
@@ -41,8 +42,9 @@ namespace WebKit {
 
 class WebCompiledContentRuleListData {
 public:
-    WebCompiledContentRuleListData(RefPtr<SharedMemory>&& data, unsigned conditionsApplyOnlyToDomainOffset, unsigned actionsOffset, unsigned actionsSize, unsigned filtersWithoutConditionsBytecodeOffset, unsigned filtersWithoutConditionsBytecodeSize, unsigned filtersWithConditionsBytecodeOffset, unsigned filtersWithConditionsBytecodeSize, unsigned topURLFiltersBytecodeOffset, unsigned topURLFiltersBytecodeSize)
+    WebCompiledContentRuleListData(RefPtr<SharedMemory>&& data, const SHA1::Digest& contentHash, unsigned conditionsApplyOnlyToDomainOffset, unsigned actionsOffset, unsigned actionsSize, unsigned filtersWithoutConditionsBytecodeOffset, unsigned filtersWithoutConditionsBytecodeSize, unsigned filtersWithConditionsBytecodeOffset, unsigned filtersWithConditionsBytecodeSize, unsigned topURLFiltersBytecodeOffset, unsigned topURLFiltersBytecodeSize)
         : data(WTFMove(data))
+        , contentHash(contentHash)
         , conditionsApplyOnlyToDomainOffset(conditionsApplyOnlyToDomainOffset)
         , actionsOffset(actionsOffset)
         , actionsSize(actionsSize)
@@ -59,6 +61,8 @@ public:
     static Optional<WebCompiledContentRuleListData> decode(IPC::Decoder&);
 
     RefPtr<SharedMemory> data;
+    // Hash of the whole compiled file. Lists with the same hash have the same bytecode.
+    SHA1::Digest contentHash;
     unsigned conditionsApplyOnlyToDomainOffset { 0 };
     unsigned actionsOffset { 0 };
     unsigned actionsSize { 0 };
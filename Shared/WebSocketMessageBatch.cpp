@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WebSocketMessageBatch.h"
+
+namespace WebKit {
+
+static constexpr size_t headerSize = sizeof(uint8_t) + sizeof(uint32_t);
+
+void WebSocketMessageBatch::append(Type type, const uint8_t* data, size_t length)
+{
+    RELEASE_ASSERT(length <= std::numeric_limits<uint32_t>::max());
+
+    uint32_t length32 = length;
+    m_data.reserveCapacity(m_data.size() + headerSize + length);
+    m_data.append(static_cast<uint8_t>(type));
+    m_data.append(reinterpret_cast<const uint8_t*>(&length32), sizeof(length32));
+    m_data.append(data, length);
+    m_payloadSize += length;
+}
+
+void WebSocketMessageBatch::appendText(const String& text)
+{
+    // The characters are copied as they are, converting them to UTF-8 here and back on the other side would be wasteful.
+    if (text.is8Bit())
+        append(Type::Latin1Text, text.characters8(), text.length());
+    else
+        append(Type::UTF16Text, reinterpret_cast<const uint8_t*>(text.characters16()), text.length() * sizeof(UChar));
+}
+
+Vector<uint8_t> WebSocketMessageBatch::take()
+{
+    m_payloadSize = 0;
+    return std::exchange(m_data, { });
+}
+
+bool WebSocketMessageBatch::forEachMessage(const IPC::DataReference& batch, const Function<void(Type, const uint8_t* data, size_t length)>& function)
+{
+    size_t offset = 0;
+    while (offset < batch.size()) {
+        if (batch.size() - offset < headerSize)
+            return false;
+
+        auto type = static_cast<Type>(batch.data()[offset]);
+        if (type > Type::UTF16Text)
+            return false;
+
+        uint32_t length;
+        memcpy(&length, batch.data() + offset + sizeof(uint8_t), sizeof(length));
+        offset += headerSize;
+        if (batch.size() - offset < length)
+            return false;
+        if (type == Type::UTF16Text && length % sizeof(UChar))
+            return false;
+
+        function(type, batch.data() + offset, length);
+        offset += length;
+    }
+    return true;
+}
+
+String WebSocketMessageBatch::text(Type type, const uint8_t* data, size_t length)
+{
+    switch (type) {
+    case Type::UTF8Text:
+        return String::fromUTF8(data, length);
+    case Type::Latin1Text:
+        return String(data, length);
+    case Type::UTF16Text: {
+        // The payload is not necessarily aligned for UChar.
+        UChar* characters;
+        auto text = String::createUninitialized(length / sizeof(UChar), characters);
+        memcpy(characters, data, length);
+        return text;
+    }
+    case Type::Binary:
+        break;
+    }
+    ASSERT_NOT_REACHED();
+    return { };
+}
+
+} // namespace WebKit
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2020 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include "DataReference.h"
+#include <wtf/Function.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace WebKit {
+
+// Frames WebSocket messages in a single buffer so that many small messages cross the process
+// boundary in one IPC message. Each message is a type byte and a 32-bit length followed by its payload.
+class WebSocketMessageBatch {
+public:
+    enum class Type : uint8_t {
+        Binary,
+        UTF8Text,
+        Latin1Text,
+        UTF16Text,
+    };
+
+    // Batches are delivered once they reach this size, larger messages are not batched.
+    static constexpr size_t maximumSize = 64 * KB;
+
+    bool isEmpty() const { return m_data.isEmpty(); }
+    size_t size() const { return m_data.size(); }
+    size_t payloadSize() const { return m_payloadSize; }
+
+    void append(Type, const uint8_t* data, size_t length);
+    void appendText(const String&);
+    Vector<uint8_t> take();
+
+    // Returns false if the batch is malformed, in which case the messages after the malformed one are not visited.
+    static bool forEachMessage(const IPC::DataReference&, const Function<void(Type, const uint8_t* data, size_t length)>&);
+    static String text(Type, const uint8_t* data, size_t length);
+
+private:
+    Vector<uint8_t> m_data;
+    size_t m_payloadSize { 0 };
+};
+
+} // namespace WebKit
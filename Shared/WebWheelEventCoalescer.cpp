@@ -36,6 +36,18 @@ namespace WebKit {
 // Represents the number of wheel events we can hold in the queue before we start pushing them preemptively.
 constexpr unsigned wheelEventQueueSizeThreshold = 10;
 
+// When the web process takes longer than this to handle wheel events, pushing more events only makes its
+// input queue longer. Events are then held back and coalesced until the web process catches up, up to a
+// much larger bound.
+constexpr Seconds slowEventHandlingThreshold { 32_ms };
+constexpr unsigned slowWheelEventQueueSizeThreshold = 100;
+
+// Weight of the most recent sample in the moving average of the event handling time.
+constexpr double eventHandlingTimeSmoothingFactor = 0.25;
+
+// Events handled but not yet matched with a presentation update, when updates stop arriving.
+constexpr size_t maximumEventTimestampsAwaitingPresentation = 256;
+
 #if !LOG_DISABLED
 static WTF::TextStream& operator<<(WTF::TextStream& ts, const WebWheelEvent& wheelEvent)
 {
@@ -54,7 +66,7 @@ bool WebWheelEventCoalescer::canCoalesce(const WebWheelEvent& a, const WebWheelE
         return false;
     if (a.granularity() != b.granularity())
         return false;
-#if PLATFORM(COCOA)
+#if PLATFORM(COCOA) || PLATFORM(GTK) || USE(LIBWPE)
     if (a.phase() != b.phase())
         return false;
     if (a.momentumPhase() != b.momentumPhase())
@@ -86,8 +98,16 @@ WebWheelEvent WebWheelEventCoalescer::coalesce(const WebWheelEvent& a, const Web
 #endif
 }
 
+bool WebWheelEventCoalescer::webProcessIsSlowToHandleEvents() const
+{
+    return m_averageEventHandlingTime >= slowEventHandlingThreshold;
+}
+
 bool WebWheelEventCoalescer::shouldDispatchEventNow(const WebWheelEvent& event) const
 {
+    if (webProcessIsSlowToHandleEvents())
+        return m_wheelEventQueue.size() >= slowWheelEventQueueSizeThreshold;
+
 #if PLATFORM(GTK)
     // Don't queue events representing a non-trivial scrolling phase to
     // avoid having them trapped in the queue, potentially preventing a
@@ -114,19 +134,20 @@ Optional<WebWheelEvent> WebWheelEventCoalescer::nextEventToDispatch()
     auto coalescedEvent = m_wheelEventQueue.takeFirst();
 
     auto coalescedSequence = makeUnique<CoalescedEventSequence>();
-    coalescedSequence->append(coalescedEvent);
+    coalescedSequence->events.append(coalescedEvent);
+    coalescedSequence->dispatchTime = MonotonicTime::now();
 
     WebWheelEvent coalescedWebEvent = coalescedEvent;
 
     while (!m_wheelEventQueue.isEmpty() && canCoalesce(coalescedWebEvent, m_wheelEventQueue.first())) {
         auto firstEvent = m_wheelEventQueue.takeFirst();
-        coalescedSequence->append(firstEvent);
+        coalescedSequence->events.append(firstEvent);
         coalescedWebEvent = coalesce(coalescedWebEvent, firstEvent);
     }
 
 #if !LOG_DISABLED
-    if (coalescedSequence->size() > 1)
-        LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::wheelEventWithCoalescing coalsesced " << *coalescedSequence << " into " << coalescedWebEvent);
+    if (coalescedSequence->events.size() > 1)
+        LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::wheelEventWithCoalescing coalsesced " << coalescedSequence->events << " into " << coalescedWebEvent);
 #endif
 
     m_eventsBeingProcessed.append(WTFMove(coalescedSequence));
@@ -155,13 +176,37 @@ NativeWebWheelEvent WebWheelEventCoalescer::takeOldestEventBeingProcessed()
 {
     ASSERT(hasEventsBeingProcessed());
     auto oldestSequence = m_eventsBeingProcessed.takeFirst();
-    return oldestSequence->last();
+
+    auto handlingTime = MonotonicTime::now() - oldestSequence->dispatchTime;
+    if (!m_averageEventHandlingTime)
+        m_averageEventHandlingTime = handlingTime;
+    else
+        m_averageEventHandlingTime = m_averageEventHandlingTime * (1 - eventHandlingTimeSmoothingFactor) + handlingTime * eventHandlingTimeSmoothingFactor;
+
+    auto now = WallTime::now();
+    for (auto& event : oldestSequence->events) {
+        m_latencyMetrics.inputToHandled.add(now - event.timestamp());
+        if (m_eventTimestampsAwaitingPresentation.size() < maximumEventTimestampsAwaitingPresentation)
+            m_eventTimestampsAwaitingPresentation.append(event.timestamp());
+    }
+
+    LOG_WITH_STREAM(WheelEvents, stream << "WebWheelEventCoalescer::takeOldestEventBeingProcessed - handled " << oldestSequence->events.size() << " events in " << handlingTime.milliseconds() << "ms (average " << m_averageEventHandlingTime.milliseconds() << "ms)");
+
+    return oldestSequence->events.last();
+}
+
+void WebWheelEventCoalescer::didPresentEvents(const Vector<WallTime>& eventTimestamps, WallTime presentationTime)
+{
+    for (auto timestamp : eventTimestamps)
+        m_latencyMetrics.inputToPresent.add(presentationTime - timestamp);
 }
 
 void WebWheelEventCoalescer::clear()
 {
     m_wheelEventQueue.clear();
     m_eventsBeingProcessed.clear();
+    m_eventTimestampsAwaitingPresentation.clear();
+    m_averageEventHandlingTime = { };
 }
 
 } // namespace WebKit
@@ -25,12 +25,22 @@
 
 #pragma once
 
+#include "LatencyHistogram.h"
 #include "NativeWebWheelEvent.h"
 #include <wtf/Deque.h>
 #include <wtf/FastMalloc.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/WallTime.h>
 
 namespace WebKit {
 
+struct WheelEventLatencyMetrics {
+    // From the time the event was generated until the web process reported it as handled.
+    LatencyHistogram inputToHandled;
+    // From the time the event was generated until the first presentation update after it was handled.
+    LatencyHistogram inputToPresent;
+};
+
 class WebWheelEventCoalescer {
     WTF_MAKE_FAST_ALLOCATED;
 public:
@@ -44,16 +54,35 @@ public:
     
     void clear();
 
+    // Returns the timestamps of the events handled since the last call, to be matched with the next presentation update.
+    Vector<WallTime> takeEventTimestampsAwaitingPresentation() { return std::exchange(m_eventTimestampsAwaitingPresentation, { }); }
+    bool hasEventsAwaitingPresentation() const { return !m_eventTimestampsAwaitingPresentation.isEmpty(); }
+    // Hidden pages don't present, the events handled meanwhile would only skew the metrics.
+    void clearEventTimestampsAwaitingPresentation() { m_eventTimestampsAwaitingPresentation.clear(); }
+    void didPresentEvents(const Vector<WallTime>& eventTimestamps, WallTime presentationTime);
+
+    const WheelEventLatencyMetrics& latencyMetrics() const { return m_latencyMetrics; }
+
 private:
-    using CoalescedEventSequence = Vector<NativeWebWheelEvent>;
+    struct CoalescedEventSequence {
+        Vector<NativeWebWheelEvent> events;
+        MonotonicTime dispatchTime;
+    };
 
     static bool canCoalesce(const WebWheelEvent&, const WebWheelEvent&);
     static WebWheelEvent coalesce(const WebWheelEvent&, const WebWheelEvent&);
 
     bool shouldDispatchEventNow(const WebWheelEvent&) const;
+    bool webProcessIsSlowToHandleEvents() const;
 
     Deque<NativeWebWheelEvent, 2> m_wheelEventQueue;
     Deque<std::unique_ptr<CoalescedEventSequence>> m_eventsBeingProcessed;
+
+    // Exponentially weighted moving average of the time the web process takes to handle a dispatched event.
+    Seconds m_averageEventHandlingTime;
+
+    Vector<WallTime> m_eventTimestampsAwaitingPresentation;
+    WheelEventLatencyMetrics m_latencyMetrics;
 };
 
 } // namespace WebKit
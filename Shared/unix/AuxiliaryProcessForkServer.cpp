@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "AuxiliaryProcessForkServer.h"
+
+#if OS(LINUX)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace WebKit {
+
+struct ForkServerRequest {
+    uint64_t processIdentifier;
+};
+
+bool sendForkServerRequest(int controlSocket, WebCore::ProcessIdentifier processIdentifier, int connectionSocket)
+{
+    ForkServerRequest request { processIdentifier.toUInt64() };
+    struct iovec iov = { &request, sizeof(request) };
+
+    char controlBuffer[CMSG_SPACE(sizeof(int))];
+    memset(controlBuffer, 0, sizeof(controlBuffer));
+
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = controlBuffer;
+    message.msg_controllen = sizeof(controlBuffer);
+
+    struct cmsghdr* controlMessage = CMSG_FIRSTHDR(&message);
+    controlMessage->cmsg_level = SOL_SOCKET;
+    controlMessage->cmsg_type = SCM_RIGHTS;
+    controlMessage->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(controlMessage), &connectionSocket, sizeof(int));
+
+    ssize_t bytesSent;
+    do {
+        bytesSent = sendmsg(controlSocket, &message, MSG_NOSIGNAL);
+    } while (bytesSent == -1 && errno == EINTR);
+
+    return bytesSent == sizeof(request);
+}
+
+bool receiveForkServerRequest(int controlSocket, WebCore::ProcessIdentifier& processIdentifier, int& connectionSocket)
+{
+    ForkServerRequest request;
+    struct iovec iov = { &request, sizeof(request) };
+
+    char controlBuffer[CMSG_SPACE(sizeof(int))];
+    struct msghdr message;
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+    message.msg_control = controlBuffer;
+    message.msg_controllen = sizeof(controlBuffer);
+
+    ssize_t bytesRead;
+    do {
+        // The connection socket is inherited by the forked process, but it must not leak to the processes it spawns.
+        bytesRead = recvmsg(controlSocket, &message, MSG_CMSG_CLOEXEC);
+    } while (bytesRead == -1 && errno == EINTR);
+
+    connectionSocket = -1;
+    struct cmsghdr* controlMessage = bytesRead > 0 ? CMSG_FIRSTHDR(&message) : nullptr;
+    if (controlMessage && controlMessage->cmsg_level == SOL_SOCKET && controlMessage->cmsg_type == SCM_RIGHTS && controlMessage->cmsg_len == CMSG_LEN(sizeof(int)))
+        memcpy(&connectionSocket, CMSG_DATA(controlMessage), sizeof(int));
+
+    if (bytesRead != sizeof(request) || connectionSocket == -1 || (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) || !request.processIdentifier) {
+        if (connectionSocket != -1)
+            close(connectionSocket);
+        return false;
+    }
+
+    processIdentifier = makeObjectIdentifier<WebCore::ProcessIdentifierType>(request.processIdentifier);
+    return true;
+}
+
+bool sendForkServerReply(int controlSocket, ProcessID processID)
+{
+    ssize_t bytesSent;
+    do {
+        bytesSent = send(controlSocket, &processID, sizeof(processID), MSG_NOSIGNAL);
+    } while (bytesSent == -1 && errno == EINTR);
+
+    return bytesSent == sizeof(processID);
+}
+
+bool receiveForkServerReply(int controlSocket, ProcessID& processID)
+{
+    ssize_t bytesRead;
+    do {
+        bytesRead = recv(controlSocket, &processID, sizeof(processID), MSG_DONTWAIT);
+    } while (bytesRead == -1 && errno == EINTR);
+
+    return bytesRead == sizeof(processID);
+}
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
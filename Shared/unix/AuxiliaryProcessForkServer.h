@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#if OS(LINUX)
+
+#include <WebCore/ProcessIdentifier.h>
+#include <wtf/ProcessID.h>
+
+namespace WebKit {
+
+// A fork server is an auxiliary process executable started with these arguments and the file descriptor of a
+// SOCK_SEQPACKET control socket. Once it's ready to accept requests it sends its own process identifier as a
+// reply. For every request received on the control socket it forks a process that runs as if it had been
+// launched with the given process identifier and IPC connection socket, and replies with the identifier of
+// the new process, or 0 when it couldn't be forked.
+static constexpr const char* forkServerSwitch = "--fork-server";
+
+bool sendForkServerRequest(int controlSocket, WebCore::ProcessIdentifier, int connectionSocket);
+bool receiveForkServerRequest(int controlSocket, WebCore::ProcessIdentifier&, int& connectionSocket);
+bool sendForkServerReply(int controlSocket, ProcessID);
+bool receiveForkServerReply(int controlSocket, ProcessID&);
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
@@ -28,8 +28,16 @@
 
 #include <JavaScriptCore/Options.h>
 #include <WebCore/ProcessIdentifier.h>
+#include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+
+#if OS(LINUX)
+#include <unicode/ubrk.h>
+#include <unicode/uclean.h>
+#include <unicode/uloc.h>
+#endif
 
 namespace WebKit {
 
@@ -48,4 +56,52 @@ bool AuxiliaryProcessMainBase::parseCommandLine(int argc, char** argv)
     return true;
 }
 
+#if OS(LINUX)
+static void prewarmForkServer()
+{
+    // Every web process loads the ICU data and the break iterator rules the first time it lays out text. ICU
+    // caches them without starting any thread and never modifies them afterwards, so they can be loaded once
+    // here and shared by all the forked processes.
+    UErrorCode status = U_ZERO_ERROR;
+    u_init(&status);
+    for (auto type : { UBRK_CHARACTER, UBRK_WORD, UBRK_LINE, UBRK_SENTENCE }) {
+        status = U_ZERO_ERROR;
+        if (auto* iterator = ubrk_open(type, uloc_getDefault(), nullptr, 0, &status))
+            ubrk_close(iterator);
+    }
+}
+
+bool AuxiliaryProcessMainBase::runForkServer(int controlSocket)
+{
+    // The forked processes are never waited for, let the kernel reap them.
+    signal(SIGCHLD, SIG_IGN);
+
+    prewarmForkServer();
+    if (!sendForkServerReply(controlSocket, getpid()))
+        return false;
+
+    while (true) {
+        WebCore::ProcessIdentifier processIdentifier;
+        int connectionSocket;
+        // The UI process closes the control socket when it no longer needs the fork server.
+        if (!receiveForkServerRequest(controlSocket, processIdentifier, connectionSocket))
+            return false;
+
+        pid_t processID = fork();
+        if (!processID) {
+            close(controlSocket);
+            signal(SIGCHLD, SIG_DFL);
+
+            m_parameters.processIdentifier = processIdentifier;
+            m_parameters.connectionIdentifier = connectionSocket;
+            return true;
+        }
+
+        close(connectionSocket);
+        if (!sendForkServerReply(controlSocket, processID > 0 ? processID : 0))
+            return false;
+    }
+}
+#endif
+
 } // namespace WebKit
@@ -31,18 +31,43 @@
 #include "WebCompiledContentRuleList.h"
 #include <WebCore/CombinedURLFilters.h>
 #include <WebCore/URLFilterParser.h>
+#include <wtf/NeverDestroyed.h>
 
 namespace API {
 
+static Vector<ContentRuleList*>& liveContentRuleLists()
+{
+    static NeverDestroyed<Vector<ContentRuleList*>> lists;
+    return lists;
+}
+
 ContentRuleList::ContentRuleList(const WTF::String& name, Ref<WebKit::WebCompiledContentRuleList>&& contentRuleList, WebKit::NetworkCache::Data&& mappedFile)
     : m_name(name)
     , m_compiledRuleList(WTFMove(contentRuleList))
     , m_mappedFile(WTFMove(mappedFile))
 {
+    liveContentRuleLists().append(this);
 }
 
 ContentRuleList::~ContentRuleList()
 {
+    liveContentRuleLists().removeFirst(this);
+}
+
+ContentRuleList* ContentRuleList::contentRuleListWithContentHash(const SHA1::Digest& contentHash)
+{
+    for (auto* contentRuleList : liveContentRuleLists()) {
+        if (contentRuleList->compiledRuleList().data().contentHash == contentHash)
+            return contentRuleList;
+    }
+    return nullptr;
+}
+
+Ref<ContentRuleList> ContentRuleList::copyWithName(const WTF::String& name) const
+{
+    // The mapped file is shared too since it owns the mapping of the compiled list.
+    auto mappedFile = m_mappedFile;
+    return create(name, m_compiledRuleList.copyRef(), WTFMove(mappedFile));
 }
 
 bool ContentRuleList::supportsRegularExpression(const WTF::String& regex)
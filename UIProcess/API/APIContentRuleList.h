@@ -27,6 +27,7 @@
 
 #include "APIObject.h"
 #include "NetworkCacheData.h"
+#include <wtf/SHA1.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebKit {
@@ -43,6 +44,10 @@ public:
         return adoptRef(*new ContentRuleList(name, WTFMove(contentRuleList), WTFMove(mappedFile)));
     }
 
+    // Returns a live list compiled to the same bytes, so a list stored under several identifiers is mapped once.
+    static ContentRuleList* contentRuleListWithContentHash(const SHA1::Digest&);
+    Ref<ContentRuleList> copyWithName(const WTF::String& name) const;
+
     ContentRuleList(const WTF::String& name, Ref<WebKit::WebCompiledContentRuleList>&&, WebKit::NetworkCache::Data&&);
     virtual ~ContentRuleList();
 
@@ -43,6 +43,7 @@
 #include <wtf/FileSystem.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/RunLoop.h>
+#include <wtf/SHA1.h>
 #include <wtf/WorkQueue.h>
 #include <wtf/persistence/PersistentDecoder.h>
 #include <wtf/persistence/PersistentEncoder.h>
@@ -118,7 +119,7 @@ static WTF::String constructedPath(const WTF::String& base, const WTF::String& i
 
 // The size and offset of the densely packed bytes in the file, not sizeof and offsetof, which would
 // represent the size and offset of the structure in memory, possibly with compiler-added padding.
-const size_t ContentRuleListFileHeaderSize = 2 * sizeof(uint32_t) + 5 * sizeof(uint64_t);
+const size_t ContentRuleListFileHeaderSize = 2 * sizeof(uint32_t) + 5 * sizeof(uint64_t) + SHA1::hashSize;
 const size_t ConditionsApplyOnlyToDomainOffset = sizeof(uint32_t) + 5 * sizeof(uint64_t);
 
 struct ContentRuleListMetaData {
@@ -129,6 +130,7 @@ struct ContentRuleListMetaData {
     uint64_t filtersWithConditionsBytecodeSize { 0 };
     uint64_t conditionedFiltersBytecodeSize { 0 };
     uint32_t conditionsApplyOnlyToDomain { false };
+    SHA1::Digest contentHash { };
     
     size_t fileSize() const
     {
@@ -152,6 +154,7 @@ static WebKit::NetworkCache::Data encodeContentRuleListMetaData(const ContentRul
     encoder << metaData.filtersWithConditionsBytecodeSize;
     encoder << metaData.conditionedFiltersBytecodeSize;
     encoder << metaData.conditionsApplyOnlyToDomain;
+    encoder << metaData.contentHash;
 
     ASSERT(encoder.bufferSize() == ContentRuleListFileHeaderSize);
     return WebKit::NetworkCache::Data(encoder.buffer(), encoder.bufferSize());
@@ -222,6 +225,15 @@ static Optional<ContentRuleListMetaData> decodeContentRuleListMetaData(const T&
             return false;
         metaData.conditionsApplyOnlyToDomain = WTFMove(*conditionsApplyOnlyToDomain);
 
+        // Older versions have no content hash in their header.
+        if (metaData.version == ContentRuleListStore::CurrentContentRuleListFileVersion) {
+            Optional<SHA1::Digest> contentHash;
+            decoder >> contentHash;
+            if (!contentHash)
+                return false;
+            metaData.contentHash = WTFMove(*contentHash);
+        }
+
         success = true;
         return false;
     });
@@ -244,7 +256,7 @@ static Optional<MappedData> openAndMapOrCopyContentRuleList(const WTF::String& p
     auto metaData = decodeContentRuleListMetaData(fileData);
     if (!metaData)
         return WTF::nullopt;
-    return {{ WTFMove(*metaData), { WTFMove(fileData) }}};
+    return {{ WTFMove(*metaData), { WTFMove(fileData) } }};
 }
 
 static bool writeDataToFile(const WebKit::NetworkCache::Data& fileData, PlatformFileHandle fd)
@@ -339,7 +351,16 @@ static Expected<MappedData, std::error_code> compiledToFile(WTF::String&& json,
             m_metaData.filtersWithConditionsBytecodeSize = m_filtersWithConditionBytecodeWritten;
             m_metaData.conditionedFiltersBytecodeSize = m_conditionFiltersBytecodeWritten;
             m_metaData.conditionsApplyOnlyToDomain = m_conditionsApplyOnlyToDomain;
-            
+
+            // The hash covers the whole file, with the header's hash field zeroed.
+            ASSERT(m_metaData.contentHash == SHA1::Digest { });
+            encodeContentRuleListMetaData(m_metaData).apply([this](const uint8_t* bytes, size_t size) {
+                m_contentHash.addBytes(bytes, size);
+                return true;
+            });
+            m_contentHash.computeHash(m_metaData.contentHash);
+            m_hashingContent = false;
+
             WebKit::NetworkCache::Data header = encodeContentRuleListMetaData(m_metaData);
             if (!m_fileError && seekFile(m_fileHandle, 0ll, FileSeekOrigin::Beginning) == -1) {
                 closeFile(m_fileHandle);
@@ -357,6 +378,12 @@ static Expected<MappedData, std::error_code> compiledToFile(WTF::String&& json,
         }
         void writeToFile(const WebKit::NetworkCache::Data& data)
         {
+            if (m_hashingContent) {
+                data.apply([this](const uint8_t* bytes, size_t size) {
+                    m_contentHash.addBytes(bytes, size);
+                    return true;
+                });
+            }
             if (!m_fileError && !writeDataToFile(data, m_fileHandle)) {
                 closeFile(m_fileHandle);
                 m_fileError = true;
@@ -372,6 +399,8 @@ static Expected<MappedData, std::error_code> compiledToFile(WTF::String&& json,
         size_t m_sourceWritten { 0 };
         bool m_conditionsApplyOnlyToDomain { false };
         bool m_fileError { false };
+        SHA1 m_contentHash;
+        bool m_hashingContent { true };
     };
 
     auto temporaryFileHandle = invalidPlatformFileHandle;
@@ -422,6 +451,11 @@ static Expected<MappedData, std::error_code> compiledToFile(WTF::String&& json,
 
 static Ref<API::ContentRuleList> createExtension(const WTF::String& identifier, MappedData&& data)
 {
+    // Identical lists share the mapping of the first one, so the bytecode is in the page cache once
+    // and the other processes reuse the list they already have. The new mapping is released with the data.
+    if (auto* contentRuleList = API::ContentRuleList::contentRuleListWithContentHash(data.metaData.contentHash))
+        return contentRuleList->copyWithName(identifier);
+
     auto sharedMemory = data.data.tryCreateSharedMemory();
 
     // Content extensions are always compiled to files, and at this point the file
@@ -431,6 +465,7 @@ static Ref<API::ContentRuleList> createExtension(const WTF::String& identifier,
     const size_t headerAndSourceSize = ContentRuleListFileHeaderSize + data.metaData.sourceSize;
     auto compiledContentRuleListData = WebKit::WebCompiledContentRuleListData(
         WTFMove(sharedMemory),
+        data.metaData.contentHash,
         ConditionsApplyOnlyToDomainOffset,
         headerAndSourceSize,
         data.metaData.actionsSize,
@@ -576,12 +611,14 @@ void ContentRuleListStore::getContentRuleListSource(const WTF::String& identifie
         switch (contentRuleList->metaData.version) {
         case 9:
         case 10:
+        case 11:
             if (!contentRuleList->metaData.sourceSize) {
                 complete({ });
                 return;
             }
-            bool is8Bit = contentRuleList->data.data()[ContentRuleListFileHeaderSize];
-            size_t start = ContentRuleListFileHeaderSize + sizeof(bool);
+            size_t headerSize = contentRuleList->metaData.version >= 11 ? ContentRuleListFileHeaderSize : ContentRuleListFileHeaderSize - SHA1::hashSize;
+            bool is8Bit = contentRuleList->data.data()[headerSize];
+            size_t start = headerSize + sizeof(bool);
             size_t length = contentRuleList->metaData.sourceSize - sizeof(bool);
             if (is8Bit)
                 complete(WTF::String(contentRuleList->data.data() + start, length));
@@ -57,7 +57,7 @@ public:
     // Also update ContentRuleListStore::getContentRuleListSource to be able to find the original JSON
     // source from old versions.
     // Update ContentRuleListStore::getContentRuleListSource with this.
-    static constexpr uint32_t CurrentContentRuleListFileVersion = 10;
+    static constexpr uint32_t CurrentContentRuleListFileVersion = 11;
 
     static ContentRuleListStore& defaultStore(bool legacyFilename);
     static Ref<ContentRuleListStore> storeWithPath(const WTF::String& storePath, bool legacyFilename);
@@ -45,6 +45,7 @@ Ref<ProcessPoolConfiguration> ProcessPoolConfiguration::copy()
     auto copy = this->create();
 
     copy->m_injectedBundlePath = this->m_injectedBundlePath;
+    copy->m_sharedNetworkCacheBlobsDirectory = this->m_sharedNetworkCacheBlobsDirectory;
     copy->m_customClassesForParameterCoder = this->m_customClassesForParameterCoder;
     copy->m_cachePartitionedURLSchemes = this->m_cachePartitionedURLSchemes;
     copy->m_alwaysRevalidatedURLSchemes = this->m_alwaysRevalidatedURLSchemes;
@@ -74,6 +74,10 @@ public:
     const WTF::String& injectedBundlePath() const { return m_injectedBundlePath; }
     void setInjectedBundlePath(const WTF::String& injectedBundlePath) { m_injectedBundlePath = injectedBundlePath; }
 
+    // Network caches of all the sessions keep their resource bodies in this directory when set, so identical bodies are stored once.
+    const WTF::String& sharedNetworkCacheBlobsDirectory() const { return m_sharedNetworkCacheBlobsDirectory; }
+    void setSharedNetworkCacheBlobsDirectory(const WTF::String& directory) { m_sharedNetworkCacheBlobsDirectory = directory; }
+
     const Vector<WTF::String>& customClassesForParameterCoder() const { return m_customClassesForParameterCoder; }
     void setCustomClassesForParameterCoder(Vector<WTF::String>&& classesForCoder) { m_customClassesForParameterCoder = WTFMove(classesForCoder); }
 
@@ -149,6 +153,7 @@ public:
 
 private:
     WTF::String m_injectedBundlePath;
+    WTF::String m_sharedNetworkCacheBlobsDirectory;
     Vector<WTF::String> m_customClassesForParameterCoder;
     Vector<WTF::String> m_cachePartitionedURLSchemes;
     Vector<WTF::String> m_alwaysRevalidatedURLSchemes;
@@ -79,6 +79,16 @@ void WKContextConfigurationSetInjectedBundlePath(WKContextConfigurationRef confi
     toImpl(configuration)->setInjectedBundlePath(toImpl(injectedBundlePath)->string());
 }
 
+WKStringRef WKContextConfigurationCopySharedNetworkCacheBlobsDirectory(WKContextConfigurationRef configuration)
+{
+    return toCopiedAPI(toImpl(configuration)->sharedNetworkCacheBlobsDirectory());
+}
+
+void WKContextConfigurationSetSharedNetworkCacheBlobsDirectory(WKContextConfigurationRef configuration, WKStringRef directory)
+{
+    toImpl(configuration)->setSharedNetworkCacheBlobsDirectory(toImpl(directory)->string());
+}
+
 WKArrayRef WKContextConfigurationCopyCustomClassesForParameterCoder(WKContextConfigurationRef configuration)
 {
     return toAPI(&API::Array::createStringArray(toImpl(configuration)->customClassesForParameterCoder()).leakRef());
@@ -48,6 +48,9 @@ WK_EXPORT void WKContextConfigurationSetIndexedDBDatabaseDirectory(WKContextConf
 WK_EXPORT WKStringRef WKContextConfigurationCopyInjectedBundlePath(WKContextConfigurationRef configuration);
 WK_EXPORT void WKContextConfigurationSetInjectedBundlePath(WKContextConfigurationRef configuration, WKStringRef injectedBundlePath);
 
+WK_EXPORT WKStringRef WKContextConfigurationCopySharedNetworkCacheBlobsDirectory(WKContextConfigurationRef configuration);
+WK_EXPORT void WKContextConfigurationSetSharedNetworkCacheBlobsDirectory(WKContextConfigurationRef configuration, WKStringRef directory);
+
 WK_EXPORT WKArrayRef WKContextConfigurationCopyCustomClassesForParameterCoder(WKContextConfigurationRef configuration);
 WK_EXPORT void WKContextConfigurationSetCustomClassesForParameterCoder(WKContextConfigurationRef configuration, WKArrayRef classesForCoder);
 
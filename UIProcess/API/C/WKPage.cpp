@@ -2899,6 +2899,13 @@ void WKPageDumpPrivateClickMeasurement(WKPageRef page, WKPageDumpPrivateClickMea
     });
 }
 
+void WKPageDumpWebSocketStatistics(WKPageRef page, WKPageDumpWebSocketStatisticsFunction callback, void* callbackContext)
+{
+    toImpl(page)->dumpWebSocketStatistics([callbackContext, callback] (const String& webSocketStatistics) {
+        callback(WebKit::toAPI(webSocketStatistics.impl()), callbackContext);
+    });
+}
+
 void WKPageClearPrivateClickMeasurement(WKPageRef page, WKPageClearPrivateClickMeasurementFunction callback, void* callbackContext)
 {
     toImpl(page)->clearPrivateClickMeasurement([callbackContext, callback] () {
@@ -171,6 +171,8 @@ WK_EXPORT void WKPageGetApplicationManifest_b(WKPageRef page, WKPageGetApplicati
 
 typedef void (*WKPageDumpPrivateClickMeasurementFunction)(WKStringRef privateClickMeasurementRepresentation, void* functionContext);
 WK_EXPORT void WKPageDumpPrivateClickMeasurement(WKPageRef, WKPageDumpPrivateClickMeasurementFunction, void* callbackContext);
+typedef void (*WKPageDumpWebSocketStatisticsFunction)(WKStringRef webSocketStatisticsRepresentation, void* functionContext);
+WK_EXPORT void WKPageDumpWebSocketStatistics(WKPageRef, WKPageDumpWebSocketStatisticsFunction, void* callbackContext);
 typedef void (*WKPageClearPrivateClickMeasurementFunction)(void* functionContext);
 WK_EXPORT void WKPageClearPrivateClickMeasurement(WKPageRef, WKPageClearPrivateClickMeasurementFunction, void* callbackContext);
 typedef void (*WKPageSetPrivateClickMeasurementOverrideTimerForTestingFunction)(void* functionContext);
@@ -118,6 +118,18 @@ void WKWebsiteDataStoreResetServiceWorkerFetchTimeoutForTesting(WKWebsiteDataSto
     WebKit::toImpl(dataStore)->resetServiceWorkerTimeoutForTesting();
 }
 
+void WKWebsiteDataStoreSetServiceWorkerCacheFirstRoutes(WKWebsiteDataStoreRef dataStore, WKURLRef scopeURL, WKStringRef cacheName, WKArrayRef urlPrefixes)
+{
+#if ENABLE(SERVICE_WORKER)
+    WebKit::toImpl(dataStore)->setServiceWorkerCacheFirstRoutes(URL { URL { }, WebKit::toWTFString(scopeURL) }, WebKit::toWTFString(cacheName), WebKit::toImpl(urlPrefixes)->toStringVector());
+#else
+    UNUSED_PARAM(dataStore);
+    UNUSED_PARAM(scopeURL);
+    UNUSED_PARAM(cacheName);
+    UNUSED_PARAM(urlPrefixes);
+#endif
+}
+
 void WKWebsiteDataStoreSetResourceLoadStatisticsEnabled(WKWebsiteDataStoreRef dataStoreRef, bool enable)
 {
     auto* websiteDataStore = WebKit::toImpl(dataStoreRef);
@@ -747,6 +747,7 @@ static void webkitWebViewBaseSnapshot(GtkWidget* widget, GtkSnapshot* snapshot)
 
     ASSERT(drawingArea->isInAcceleratedCompositingMode());
     webViewBase->priv->acceleratedBackingStore->snapshot(snapshot);
+    webViewBase->priv->pageProxy->didPresentFrame();
 
     if (webViewBase->priv->inspectorView)
         gtk_widget_snapshot_child(widget, webViewBase->priv->inspectorView, snapshot);
@@ -777,6 +778,7 @@ static gboolean webkitWebViewBaseDraw(GtkWidget* widget, cairo_t* cr)
         WebCore::Region unpaintedRegion; // This is simply unused.
         drawingArea->paint(cr, clipRect, unpaintedRegion);
     }
+    webViewBase->priv->pageProxy->didPresentFrame();
 
     if (showingNavigationSnapshot) {
         RefPtr<cairo_pattern_t> group = adoptRef(cairo_pop_group(cr));
@@ -235,6 +235,7 @@ void View::setClient(std::unique_ptr<API::ViewClient>&& client)
 
 void View::frameDisplayed()
 {
+    m_pageProxy->didPresentFrame();
     m_client->frameDisplayed(*this);
 }
 
@@ -27,6 +27,7 @@
 #include "BackgroundProcessResponsivenessTimer.h"
 
 #include "Logging.h"
+#include "ProcessAssertion.h"
 #include "WebProcessMessages.h"
 #include "WebProcessProxy.h"
 
@@ -134,6 +135,11 @@ void BackgroundProcessResponsivenessTimer::setResponsive(bool isResponsive)
 bool BackgroundProcessResponsivenessTimer::shouldBeActive() const
 {
 #if !PLATFORM(IOS_FAMILY)
+#if OS(LINUX)
+    // Like on iOS, processes without visible pages usually get suspended.
+    if (ProcessAssertion::isProcessThrottlingEnabled())
+        return false;
+#endif
     if (m_webProcessProxy.visiblePageCount())
         return false;
     if (m_webProcessProxy.isStandaloneServiceWorkerProcess())
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ForkServerLauncher.h"
+
+#if OS(LINUX)
+
+#include "AuxiliaryProcessForkServer.h"
+#include "ProcessExecutablePath.h"
+#include <gio/gio.h>
+#include <sys/socket.h>
+#include <wtf/Deque.h>
+#include <wtf/FileSystem.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/RunLoop.h>
+#include <wtf/UniStdExtras.h>
+#include <wtf/glib/GRefPtr.h>
+#include <wtf/glib/GSocketMonitor.h>
+#include <wtf/glib/GUniquePtr.h>
+#include <wtf/text/CString.h>
+
+namespace WebKit {
+
+class WebProcessForkServer {
+    WTF_MAKE_NONCOPYABLE(WebProcessForkServer);
+    friend class NeverDestroyed<WebProcessForkServer>;
+public:
+    static WebProcessForkServer& singleton()
+    {
+        static NeverDestroyed<WebProcessForkServer> forkServer;
+        return forkServer;
+    }
+
+    void start()
+    {
+        if (m_state != State::Stopped)
+            return;
+
+        int sockets[2];
+        if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, sockets) == -1)
+            return;
+
+        // The fork server is a web process executable, started without the sandbox since the processes it forks can't be sandboxed separately.
+        CString executablePath = FileSystem::fileSystemRepresentation(executablePathOfWebProcess());
+        GUniquePtr<gchar> controlSocket(g_strdup_printf("%d", sockets[1]));
+        const char* argv[] = { executablePath.data(), forkServerSwitch, controlSocket.get(), nullptr };
+
+        GRefPtr<GSubprocessLauncher> launcher = adoptGRef(g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_NONE));
+        g_subprocess_launcher_take_fd(launcher.get(), sockets[1], sockets[1]);
+
+        GUniqueOutPtr<GError> error;
+        m_process = adoptGRef(g_subprocess_launcher_spawnv(launcher.get(), argv, &error.outPtr()));
+        if (!m_process) {
+            g_warning("Unable to start the web process fork server: %s", error->message);
+            closeWithRetry(sockets[0]);
+            return;
+        }
+
+        // Don't expose the control socket to the processes launched later.
+        if (!setCloseOnExec(sockets[0]))
+            RELEASE_ASSERT_NOT_REACHED();
+
+        m_controlSocket = adoptGRef(g_socket_new_from_fd(sockets[0], nullptr));
+        if (!m_controlSocket) {
+            closeWithRetry(sockets[0]);
+            g_subprocess_force_exit(m_process.get());
+            m_process = nullptr;
+            return;
+        }
+
+        m_state = State::Starting;
+        m_controlSocketMonitor.start(m_controlSocket.get(), G_IO_IN, RunLoop::main(), [this](GIOCondition condition) -> gboolean {
+            ProcessID processID;
+            while (m_controlSocket && (condition & G_IO_IN) && receiveForkServerReply(g_socket_get_fd(m_controlSocket.get()), processID))
+                didReceiveReply(processID);
+
+            // Handling a reply can stop the fork server.
+            if (!m_controlSocket)
+                return G_SOURCE_REMOVE;
+
+            if (!(condition & (G_IO_HUP | G_IO_ERR | G_IO_NVAL)))
+                return G_SOURCE_CONTINUE;
+
+            // The fork server exited, start a new one unless it never got ready.
+            bool wasReady = m_state == State::Ready;
+            stop();
+            if (wasReady)
+                restart();
+            return G_SOURCE_REMOVE;
+        });
+    }
+
+    bool launch(WebCore::ProcessIdentifier processIdentifier, int connectionSocket, CompletionHandler<void(ProcessID)>&& completionHandler)
+    {
+        if (m_state != State::Ready)
+            return false;
+
+        if (!sendForkServerRequest(g_socket_get_fd(m_controlSocket.get()), processIdentifier, connectionSocket)) {
+            // The fork server is gone, start a new one for the next launches.
+            stop();
+            restart();
+            return false;
+        }
+
+        m_pendingReplies.append(WTFMove(completionHandler));
+        if (!m_replyTimer.isActive())
+            m_replyTimer.startOneShot(replyTimeout);
+        return true;
+    }
+
+private:
+    WebProcessForkServer()
+        : m_replyTimer(RunLoop::main(), this, &WebProcessForkServer::replyTimerFired)
+    {
+    }
+
+    // Forking should be almost immediate, a fork server that takes longer than this stopped responding.
+    static constexpr Seconds replyTimeout { 1_s };
+
+    void didReceiveReply(ProcessID processID)
+    {
+        if (m_state == State::Starting) {
+            // The first reply is the fork server announcing that it's ready.
+            if (processID != g_ascii_strtoll(g_subprocess_get_identifier(m_process.get()), nullptr, 0)) {
+                stop();
+                return;
+            }
+            m_state = State::Ready;
+            return;
+        }
+
+        if (m_pendingReplies.isEmpty()) {
+            stop();
+            return;
+        }
+
+        auto completionHandler = m_pendingReplies.takeFirst();
+        if (m_pendingReplies.isEmpty())
+            m_replyTimer.stop();
+        else
+            m_replyTimer.startOneShot(replyTimeout);
+
+        if (!processID) {
+            // The system is running out of resources, stop forking so that the process is spawned normally.
+            g_warning("The web process fork server failed to fork, falling back to spawning web processes");
+            stop();
+            completionHandler(0);
+            return;
+        }
+
+        completionHandler(processID);
+    }
+
+    void replyTimerFired()
+    {
+        g_warning("The web process fork server didn't reply, falling back to spawning web processes");
+        stop();
+    }
+
+    void restart()
+    {
+        // This can be called from the control socket monitor callback, which can't start monitoring a new socket.
+        RunLoop::main().dispatch([this] {
+            start();
+        });
+    }
+
+    void stop()
+    {
+        m_state = State::Stopped;
+        m_replyTimer.stop();
+        m_controlSocketMonitor.stop();
+
+        // Closing the control socket is enough for a working fork server to exit, this is for one that stopped responding.
+        if (auto controlSocket = std::exchange(m_controlSocket, nullptr))
+            g_socket_close(controlSocket.get(), nullptr);
+        if (auto process = std::exchange(m_process, nullptr))
+            g_subprocess_force_exit(process.get());
+
+        // The completion handlers can launch processes again, so only call them once the fork server is stopped.
+        auto pendingReplies = WTFMove(m_pendingReplies);
+        while (!pendingReplies.isEmpty())
+            pendingReplies.takeFirst()(0);
+    }
+
+    enum class State : uint8_t { Stopped, Starting, Ready };
+    State m_state { State::Stopped };
+    GRefPtr<GSubprocess> m_process;
+    GRefPtr<GSocket> m_controlSocket;
+    GSocketMonitor m_controlSocketMonitor;
+    Deque<CompletionHandler<void(ProcessID)>> m_pendingReplies;
+    RunLoop::Timer<WebProcessForkServer> m_replyTimer;
+};
+
+bool isWebProcessForkServerEnabled()
+{
+    static bool enabled = !g_strcmp0(g_getenv("WEBKIT_USE_WEB_PROCESS_FORK_SERVER"), "1");
+    return enabled;
+}
+
+void startWebProcessForkServer()
+{
+    ASSERT(RunLoop::isMain());
+    if (isWebProcessForkServerEnabled())
+        WebProcessForkServer::singleton().start();
+}
+
+bool forkServerSpawn(const WebKit::ProcessLauncher::LaunchOptions& launchOptions, int childProcessSocket, CompletionHandler<void(ProcessID)>&& completionHandler)
+{
+    ASSERT(launchOptions.processType == ProcessLauncher::ProcessType::Web);
+    ASSERT(RunLoop::isMain());
+
+    return WebProcessForkServer::singleton().launch(launchOptions.processIdentifier, childProcessSocket, WTFMove(completionHandler));
+}
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
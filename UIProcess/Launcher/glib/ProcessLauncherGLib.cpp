@@ -30,6 +30,7 @@
 #include "BubblewrapLauncher.h"
 #include "Connection.h"
 #include "FlatpakLauncher.h"
+#include "ForkServerLauncher.h"
 #include "ProcessExecutablePath.h"
 #include <errno.h>
 #include <fcntl.h>
@@ -165,6 +166,42 @@ void ProcessLauncher::launchProcess()
     argv[i++] = nullptr;
     argv[i++] = nullptr;
 
+#if OS(LINUX)
+    const char* sandboxEnv = g_getenv("WEBKIT_FORCE_SANDBOX");
+    bool sandboxEnabled = m_launchOptions.extraInitializationData.get("enable-sandbox") == "true";
+
+    if (sandboxEnv)
+        sandboxEnabled = !strcmp(sandboxEnv, "1");
+
+    // Processes forked from the fork server share its address space layout, so this is opt-in.
+    bool useForkServer = !sandboxEnabled && m_launchOptions.processType == ProcessLauncher::ProcessType::Web && isWebProcessForkServerEnabled();
+#if ENABLE(DEVELOPER_MODE)
+    useForkServer = useForkServer && prefixArgs.isEmpty() && !configureJSCForTesting;
+#endif
+    if (useForkServer) {
+        bool requestSent = forkServerSpawn(m_launchOptions, socketPair.client, [protectedThis = makeRef(*this), this, socketPair](ProcessID processIdentifier) {
+            // The forked process received its own copy of the client socket.
+            closeWithRetry(socketPair.client);
+            if (!processIdentifier) {
+                // The fork server may have forked a process with the client socket before failing, closing the server
+                // socket disconnects it. The fork server is stopped when it fails, so this spawns the process instead.
+                closeWithRetry(socketPair.server);
+                launchProcess();
+                return;
+            }
+
+            m_processIdentifier = processIdentifier;
+            didFinishLaunchingProcess(m_processIdentifier, socketPair.server);
+        });
+        if (requestSent) {
+            // Don't expose the client socket to the processes launched while waiting for the fork server.
+            if (!setCloseOnExec(socketPair.client))
+                RELEASE_ASSERT_NOT_REACHED();
+            return;
+        }
+    }
+#endif
+
     GRefPtr<GSubprocessLauncher> launcher = adoptGRef(g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_INHERIT_FDS));
     g_subprocess_launcher_set_child_setup(launcher.get(), childSetupFunction, GINT_TO_POINTER(socketPair.server), nullptr);
     g_subprocess_launcher_take_fd(launcher.get(), socketPair.client, socketPair.client);
@@ -173,12 +210,6 @@ void ProcessLauncher::launchProcess()
     GRefPtr<GSubprocess> process;
 
 #if OS(LINUX)
-    const char* sandboxEnv = g_getenv("WEBKIT_FORCE_SANDBOX");
-    bool sandboxEnabled = m_launchOptions.extraInitializationData.get("enable-sandbox") == "true";
-
-    if (sandboxEnv)
-        sandboxEnabled = !strcmp(sandboxEnv, "1");
-
     if (sandboxEnabled && isFlatpakSpawnUsable())
         process = flatpakSpawn(launcher.get(), m_launchOptions, argv, socketPair.client, &error.outPtr());
 #if ENABLE(BUBBLEWRAP_SANDBOX)
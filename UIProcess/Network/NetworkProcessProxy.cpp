@@ -149,6 +149,15 @@ void NetworkProcessProxy::sendCreationParametersToNewProcess()
     parameters.cacheModel = LegacyGlobalSettings::singleton().cacheModel();
     for (auto& scheme : WebProcessPool::urlSchemesWithCustomProtocolHandlers())
         parameters.urlSchemesRegisteredForCustomProtocols.append(scheme);
+    // The network process is shared by all the process pools, the first one asking for it enables shared cache blobs.
+    for (auto* processPool : WebProcessPool::allProcessPools()) {
+        auto& sharedNetworkCacheBlobsDirectory = processPool->configuration().sharedNetworkCacheBlobsDirectory();
+        if (sharedNetworkCacheBlobsDirectory.isEmpty())
+            continue;
+        parameters.sharedNetworkCacheBlobsDirectory = sharedNetworkCacheBlobsDirectory;
+        SandboxExtension::createHandleForReadWriteDirectory(sharedNetworkCacheBlobsDirectory, parameters.sharedNetworkCacheBlobsDirectoryExtensionHandle);
+        break;
+    }
 #if PLATFORM(IOS_FAMILY)
     if (String cookieStorageDirectory = WebProcessPool::cookieStorageDirectory(); !cookieStorageDirectory.isEmpty())
         SandboxExtension::createHandleForReadWriteDirectory(cookieStorageDirectory, parameters.cookieStorageDirectoryExtensionHandle);
@@ -26,7 +26,7 @@
 #include "config.h"
 #include "ProcessAssertion.h"
 
-#if !PLATFORM(IOS_FAMILY)
+#if !PLATFORM(IOS_FAMILY) && !OS(LINUX)
 
 #include "WKBase.h"
 
@@ -54,4 +54,4 @@ ProcessAndUIAssertion::~ProcessAndUIAssertion() = default;
 
 } // namespace WebKit
 
-#endif // !PLATFORM(IOS_FAMILY)
+#endif // !PLATFORM(IOS_FAMILY) && !OS(LINUX)
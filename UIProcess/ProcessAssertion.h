@@ -64,6 +64,13 @@ public:
 
     bool isValid() const;
 
+#if OS(LINUX)
+    // Assertions only throttle and suspend processes when WEBKIT_ENABLE_PROCESS_THROTTLING=1 is set,
+    // and only the processes registered here, which are web processes.
+    static bool isProcessThrottlingEnabled();
+    static void setProcessCanBeThrottled(ProcessID, bool);
+#endif
+
 #if PLATFORM(IOS_FAMILY)
 protected:
     virtual void processAssertionWasInvalidated();
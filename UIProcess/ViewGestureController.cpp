@@ -450,6 +450,11 @@ bool ViewGestureController::PendingSwipeTracker::handleEvent(PlatformScrollEvent
         if (!scrollEventCanBecomeSwipe(event, m_direction))
             return false;
 
+#if PLATFORM(GTK)
+        // Bring a spilled snapshot back in while the gesture is still below the swipe threshold.
+        m_viewGestureController.loadSpilledSnapshotForSwipe(m_direction);
+#endif
+
         if (!m_shouldIgnorePinnedState && m_webPageProxy.willHandleHorizontalScrollEvents()) {
             m_state = State::WaitingForWebCore;
             LOG(ViewGestures, "Swipe Start Hysteresis - waiting for WebCore to handle event");
@@ -317,6 +317,7 @@ private:
 
 #if PLATFORM(GTK)
     GRefPtr<GtkStyleContext> createStyleContext(const char*);
+    void loadSpilledSnapshotForSwipe(SwipeDirection);
 #endif
 
     WebPageProxy& m_webPageProxy;
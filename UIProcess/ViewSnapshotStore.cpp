@@ -77,7 +77,11 @@ void ViewSnapshotStore::pruneSnapshots(WebPageProxy& webPageProxy)
 
     // FIXME: We have enough information to do smarter-than-LRU eviction (making use of the back-forward lists, etc.)
 
+#if PLATFORM(GTK)
+    m_snapshotsWithImages.first()->spillImage();
+#else
     m_snapshotsWithImages.first()->clearImage();
+#endif
 }
 
 void ViewSnapshotStore::recordSnapshot(WebPageProxy& webPageProxy, WebBackForwardListItem& item)
@@ -97,6 +101,9 @@ void ViewSnapshotStore::recordSnapshot(WebPageProxy& webPageProxy, WebBackForwar
     snapshot->setDeviceScaleFactor(webPageProxy.deviceScaleFactor());
     snapshot->setBackgroundColor(webPageProxy.pageExtendedBackgroundColor());
     snapshot->setViewScrollPosition(WebCore::roundedIntPoint(webPageProxy.viewScrollPosition()));
+#if PLATFORM(GTK)
+    snapshot->setCanSpillImage(!webPageProxy.sessionID().isEphemeral());
+#endif
 
     item.setSnapshot(WTFMove(snapshot));
 }
@@ -110,6 +117,9 @@ void ViewSnapshotStore::discardSnapshotImages()
 ViewSnapshot::~ViewSnapshot()
 {
     clearImage();
+#if PLATFORM(GTK)
+    discardSpilledImage();
+#endif
 }
 
 } // namespace WebKit
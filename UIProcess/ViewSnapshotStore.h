@@ -29,6 +29,7 @@
 #include <WebCore/IntPoint.h>
 #include <wtf/ListHashSet.h>
 #include <wtf/Noncopyable.h>
+#include <wtf/WeakPtr.h>
 #include <wtf/text/WTFString.h>
 
 #if HAVE(IOSURFACE)
@@ -37,6 +38,8 @@
 
 #if PLATFORM(GTK)
 #include <WebCore/RefPtrCairo.h>
+#include <wtf/HashMap.h>
+#include <wtf/WorkQueue.h>
 #endif
 
 namespace WebKit {
@@ -44,7 +47,7 @@ namespace WebKit {
 class WebBackForwardListItem;
 class WebPageProxy;
 
-class ViewSnapshot : public RefCounted<ViewSnapshot> {
+class ViewSnapshot : public RefCounted<ViewSnapshot>, public CanMakeWeakPtr<ViewSnapshot> {
 public:
 #if HAVE(IOSURFACE)
     static Ref<ViewSnapshot> create(std::unique_ptr<WebCore::IOSurface>);
@@ -91,6 +94,13 @@ public:
 
     size_t imageSizeInBytes() const;
     WebCore::IntSize size() const;
+
+    // Evicted images are compressed to unnamed files and can be brought back in off the main thread.
+    // Images of ephemeral sessions are never written to disk, they are cleared instead.
+    void spillImage();
+    void loadSpilledImage();
+    bool hasSpilledImage() const { return !!m_spilledImageIdentifier; }
+    void setCanSpillImage(bool canSpillImage) { m_canSpillImage = canSpillImage; }
 #endif
 
 private:
@@ -103,7 +113,13 @@ private:
 #if PLATFORM(GTK)
     explicit ViewSnapshot(RefPtr<cairo_surface_t>&&);
 
+    void didLoadSpilledImage(RefPtr<cairo_surface_t>&&);
+    void discardSpilledImage();
+
     RefPtr<cairo_surface_t> m_surface;
+    uint64_t m_spilledImageIdentifier { 0 };
+    bool m_canSpillImage { false };
+    bool m_isLoadingSpilledImage { false };
 #endif
 
     uint64_t m_renderTreeSize;
@@ -133,10 +149,25 @@ private:
     void willRemoveImageFromSnapshot(ViewSnapshot&);
     void pruneSnapshots(WebPageProxy&);
 
+#if PLATFORM(GTK)
+    WorkQueue& spillQueue();
+    uint64_t nextSpillIdentifier() { return ++m_nextSpillIdentifier; }
+    void writeSpilledImage(uint64_t identifier, cairo_surface_t*);
+    RefPtr<cairo_surface_t> readSpilledImage(uint64_t identifier);
+    void removeSpilledImage(uint64_t identifier);
+#endif
+
     size_t m_snapshotCacheSize { 0 };
 
     ListHashSet<ViewSnapshot*> m_snapshotsWithImages;
     bool m_disableSnapshotVolatility { false };
+
+#if PLATFORM(GTK)
+    RefPtr<WorkQueue> m_spillQueue;
+    uint64_t m_nextSpillIdentifier { 0 };
+    // Only used on the spill queue.
+    HashMap<uint64_t, int> m_spillFiles;
+#endif
 };
 
 } // namespace WebKit
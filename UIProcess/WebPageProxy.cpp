@@ -660,7 +660,7 @@ bool WebPageProxy::hasRunningProcess() const
 
 void WebPageProxy::notifyProcessPoolToPrewarm()
 {
-    m_process->processPool().didReachGoodTimeToPrewarm();
+    m_process->processPool().didReachGoodTimeToPrewarm(RegistrableDomain { URL { { }, m_pageLoadState.url() } });
 }
 
 void WebPageProxy::setPreferences(WebPreferences& preferences)
@@ -2036,6 +2036,9 @@ void WebPageProxy::dispatchActivityStateChange()
         else {
             m_visiblePageToken = nullptr;
 
+            if (m_wheelEventCoalescer)
+                m_wheelEventCoalescer->clearEventTimestampsAwaitingPresentation();
+
             // If we've started the responsiveness timer as part of telling the web process to update the backing store
             // state, it might not send back a reply (since it won't paint anything if the web page is hidden) so we
             // stop the unresponsiveness timer here.
@@ -2708,6 +2711,19 @@ WebWheelEventCoalescer& WebPageProxy::wheelEventCoalescer()
     return *m_wheelEventCoalescer;
 }
 
+const WheelEventLatencyMetrics* WebPageProxy::wheelEventLatencyMetrics() const
+{
+    return m_wheelEventCoalescer ? &m_wheelEventCoalescer->latencyMetrics() : nullptr;
+}
+
+void WebPageProxy::didPresentFrame()
+{
+    if (!m_wheelEventCoalescer || !m_wheelEventCoalescer->hasEventsAwaitingPresentation())
+        return;
+
+    m_wheelEventCoalescer->didPresentEvents(m_wheelEventCoalescer->takeEventTimestampsAwaitingPresentation(), WallTime::now());
+}
+
 bool WebPageProxy::hasQueuedKeyEvent() const
 {
     return !m_keyEventQueue.isEmpty();
@@ -4238,6 +4254,16 @@ void WebPageProxy::forceRepaint(CompletionHandler<void()>&& callback)
     });
 }
 
+#if USE(COORDINATED_GRAPHICS)
+void WebPageProxy::getCompositorFrameTimeline(CompletionHandler<void(const String&)>&& callback)
+{
+    if (!hasRunningProcess())
+        return callback({ });
+
+    sendWithAsyncReply(Messages::WebPage::GetCompositorFrameTimeline(), WTFMove(callback));
+}
+#endif
+
 static OptionSet<IPC::SendOption> printingSendOptions(bool isPerformingDOMPrintOperation)
 {
     if (isPerformingDOMPrintOperation)
@@ -4978,8 +5004,10 @@ void WebPageProxy::didFirstVisuallyNonEmptyLayoutForFrame(FrameIdentifier frameI
     if (m_loaderClient)
         m_loaderClient->didFirstVisuallyNonEmptyLayoutForFrame(*this, *frame, m_process->transformHandlesToObjects(userData.object()).get());
 
-    if (frame->isMainFrame())
+    if (frame->isMainFrame()) {
         pageClient().didFirstVisuallyNonEmptyLayoutForMainFrame();
+        m_process->processPool().didReachFirstVisuallyNonEmptyLayout(m_process);
+    }
 }
 
 void WebPageProxy::didLayoutForCustomContentProvider()
@@ -10035,6 +10063,11 @@ void WebPageProxy::dumpPrivateClickMeasurement(CompletionHandler<void(const Stri
     websiteDataStore().networkProcess().sendWithAsyncReply(Messages::NetworkProcess::DumpPrivateClickMeasurement(m_websiteDataStore->sessionID()), WTFMove(completionHandler));
 }
 
+void WebPageProxy::dumpWebSocketStatistics(CompletionHandler<void(const String&)>&& completionHandler)
+{
+    websiteDataStore().networkProcess().sendWithAsyncReply(Messages::NetworkProcess::DumpWebSocketStatistics(m_websiteDataStore->sessionID()), WTFMove(completionHandler));
+}
+
 void WebPageProxy::clearPrivateClickMeasurement(CompletionHandler<void()>&& completionHandler)
 {
     websiteDataStore().networkProcess().sendWithAsyncReply(Messages::NetworkProcess::ClearPrivateClickMeasurement(m_websiteDataStore->sessionID()), WTFMove(completionHandler));
@@ -365,6 +365,7 @@ struct WebPopupItem;
 struct WebSpeechSynthesisVoice;
 struct URLSchemeTaskParameters;
 struct UserMessage;
+struct WheelEventLatencyMetrics;
 
 enum class CreateNewGroupForHighlight : bool;
 enum class NegotiatedLegacyTLS : bool;
@@ -940,6 +941,10 @@ public:
 
     bool isProcessingWheelEvents() const;
     void handleWheelEvent(const NativeWebWheelEvent&);
+    const WheelEventLatencyMetrics* wheelEventLatencyMetrics() const;
+
+    // Called by the view when a frame has been presented on screen.
+    void didPresentFrame();
 
     bool isProcessingKeyboardEvents() const;
     bool handleKeyboardEvent(const NativeWebKeyboardEvent&);
@@ -1142,6 +1147,11 @@ public:
     void runJavaScriptInFrameInScriptWorld(WebCore::RunJavaScriptParameters&&, Optional<WebCore::FrameIdentifier>, API::ContentWorld&, CompletionHandler<void(Expected<RefPtr<API::SerializedScriptValue>, WebCore::ExceptionDetails>&&)>&&);
     void forceRepaint(CompletionHandler<void()>&&);
 
+#if USE(COORDINATED_GRAPHICS)
+    // Returns the timings of the most recently composited frames in the Trace Event Format.
+    void getCompositorFrameTimeline(CompletionHandler<void(const String&)>&&);
+#endif
+
     float headerHeight(WebFrameProxy&);
     float footerHeight(WebFrameProxy&);
     void drawHeader(WebFrameProxy&, WebCore::FloatRect&&);
@@ -1440,6 +1450,7 @@ public:
     bool isShowingNavigationGestureSnapshot() const { return m_isShowingNavigationGestureSnapshot; }
 
     bool isPlayingAudio() const { return !!(m_mediaState & WebCore::MediaProducer::IsPlayingAudio); }
+    bool isCapturingMedia() const { return !!(m_mediaState & WebCore::MediaProducer::MediaCaptureMask); }
     void isPlayingMediaDidChange(WebCore::MediaProducer::MediaStateFlags, uint64_t);
     void updateReportedMediaCaptureState();
 
@@ -1679,6 +1690,7 @@ public:
 #endif
 
     void dumpPrivateClickMeasurement(CompletionHandler<void(const String&)>&&);
+    void dumpWebSocketStatistics(CompletionHandler<void(const String&)>&&);
     void clearPrivateClickMeasurement(CompletionHandler<void()>&&);
     void setPrivateClickMeasurementOverrideTimerForTesting(bool value, CompletionHandler<void()>&&);
     void markAttributedPrivateClickMeasurementsAsExpiredForTesting(CompletionHandler<void()>&&);
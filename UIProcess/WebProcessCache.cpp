@@ -28,6 +28,7 @@
 
 #include "LegacyGlobalSettings.h"
 #include "Logging.h"
+#include "WebProcessMessages.h"
 #include "WebProcessPool.h"
 #include "WebProcessProxy.h"
 #include <wtf/RAMSize.h>
@@ -41,6 +42,9 @@ namespace WebKit {
 Seconds WebProcessCache::cachedProcessLifetime { 30_min };
 Seconds WebProcessCache::clearingDelayAfterApplicationResignsActive { 5_min };
 
+// Used for processes whose footprint hasn't been sampled yet when no other process has been either.
+static const size_t defaultMemoryFootprintEstimate = 100 * MB;
+
 static uint64_t generateAddRequestIdentifier()
 {
     static uint64_t identifier = 0;
@@ -126,30 +130,97 @@ bool WebProcessCache::addProcess(std::unique_ptr<CachedProcess>&& cachedProcess)
     if (auto previousProcess = m_processesPerRegistrableDomain.take(registrableDomain))
         WEBPROCESSCACHE_RELEASE_LOG("addProcess: Evicting process from WebProcess cache because a new process was added for the same domain", previousProcess->process().processIdentifier());
 
-    while (m_processesPerRegistrableDomain.size() >= capacity()) {
-        auto it = m_processesPerRegistrableDomain.random();
-        WEBPROCESSCACHE_RELEASE_LOG("addProcess: Evicting process from WebProcess cache because capacity was reached", it->value->process().processIdentifier());
-        m_processesPerRegistrableDomain.remove(it);
-    }
-
-    WEBPROCESSCACHE_RELEASE_LOG("addProcess: Added process to WebProcess cache (size=%u, capacity=%u)", cachedProcess->process().processIdentifier(), size() + 1, capacity());
+    auto& process = cachedProcess->process();
+    WEBPROCESSCACHE_RELEASE_LOG("addProcess: Added process to WebProcess cache (size=%u, capacity=%u)", process.processIdentifier(), size() + 1, capacity());
     m_processesPerRegistrableDomain.add(registrableDomain, WTFMove(cachedProcess));
 
+    sampleMemoryFootprint(process);
+    evictProcessesIfNeeded(m_memoryBudget, capacity());
+
     return true;
 }
 
+void WebProcessCache::sampleMemoryFootprint(WebProcessProxy& process)
+{
+    process.sendWithAsyncReply(Messages::WebProcess::GetMemoryFootprint(), [weakThis = makeWeakPtr(*this), process = makeRef(process)](uint64_t footprint) {
+        // The reply is empty if the process exited.
+        if (weakThis && footprint)
+            weakThis->didSampleMemoryFootprint(process, footprint);
+    });
+}
+
+void WebProcessCache::didSampleMemoryFootprint(WebProcessProxy& process, size_t footprint)
+{
+    auto it = m_processesPerRegistrableDomain.find(process.registrableDomain());
+    if (it == m_processesPerRegistrableDomain.end() || &it->value->process() != &process)
+        return;
+
+    WEBPROCESSCACHE_RELEASE_LOG("didSampleMemoryFootprint: (footprint=%zu)", process.processIdentifier(), footprint);
+    it->value->setMemoryFootprint(footprint);
+    evictProcessesIfNeeded(m_memoryBudget, capacity());
+}
+
+size_t WebProcessCache::averageMemoryFootprint() const
+{
+    size_t totalFootprint = 0;
+    unsigned sampledProcessCount = 0;
+    for (auto& otherProcess : m_processesPerRegistrableDomain.values()) {
+        if (auto footprint = otherProcess->memoryFootprint()) {
+            totalFootprint += *footprint;
+            ++sampledProcessCount;
+        }
+    }
+    return sampledProcessCount ? totalFootprint / sampledProcessCount : defaultMemoryFootprintEstimate;
+}
+
+void WebProcessCache::evictProcessesIfNeeded(size_t memoryLimit, unsigned processLimit)
+{
+    // Until its footprint is known, a process is assumed to hold as much memory as the average cached process.
+    auto averageFootprint = averageMemoryFootprint();
+    auto estimatedMemoryFootprint = [averageFootprint](const CachedProcess& cachedProcess) {
+        return cachedProcess.memoryFootprint().valueOr(averageFootprint);
+    };
+
+    size_t totalFootprint = 0;
+    for (auto& cachedProcess : m_processesPerRegistrableDomain.values())
+        totalFootprint += estimatedMemoryFootprint(*cachedProcess);
+
+    while (!m_processesPerRegistrableDomain.isEmpty() && (totalFootprint > memoryLimit || size() > processLimit)) {
+        // Evict the process that has held the most memory for the longest time without being used.
+        auto now = MonotonicTime::now();
+        auto processToEvict = m_processesPerRegistrableDomain.end();
+        double highestCost = -1;
+        for (auto it = m_processesPerRegistrableDomain.begin(); it != m_processesPerRegistrableDomain.end(); ++it) {
+            double cost = estimatedMemoryFootprint(*it->value) * std::max(now - it->value->additionTime(), 1_s).seconds();
+            if (cost > highestCost) {
+                highestCost = cost;
+                processToEvict = it;
+            }
+        }
+
+        size_t footprint = estimatedMemoryFootprint(*processToEvict->value);
+        totalFootprint -= std::min(totalFootprint, footprint);
+        m_evictedMemoryFootprint += footprint;
+        WEBPROCESSCACHE_RELEASE_LOG("evictProcessesIfNeeded: Evicting process from WebProcess cache (footprint=%zu, remainingFootprint=%zu, memoryLimit=%zu, size=%u, processLimit=%u)", processToEvict->value->process().processIdentifier(), footprint, totalFootprint, memoryLimit, size() - 1, processLimit);
+        m_processesPerRegistrableDomain.remove(processToEvict);
+    }
+}
+
 RefPtr<WebProcessProxy> WebProcessCache::takeProcess(const WebCore::RegistrableDomain& registrableDomain, WebsiteDataStore& dataStore)
 {
     auto it = m_processesPerRegistrableDomain.find(registrableDomain);
-    if (it == m_processesPerRegistrableDomain.end())
-        return nullptr;
-
-    if (&it->value->process().websiteDataStore() != &dataStore)
+    if (it == m_processesPerRegistrableDomain.end() || &it->value->process().websiteDataStore() != &dataStore) {
+        // Lookups made while the cache is disabled would only skew the hit rate.
+        if (capacity())
+            ++m_missCount;
         return nullptr;
+    }
 
+    if (capacity())
+        ++m_hitCount;
     auto process = it->value->takeProcess();
     m_processesPerRegistrableDomain.remove(it);
-    WEBPROCESSCACHE_RELEASE_LOG("takeProcess: Taking process from WebProcess cache (size=%u, capacity=%u)", process->processIdentifier(), size(), capacity());
+    WEBPROCESSCACHE_RELEASE_LOG("takeProcess: Taking process from WebProcess cache (size=%u, capacity=%u, hits=%u, misses=%u)", process->processIdentifier(), size(), capacity(), m_hitCount, m_missCount);
 
     ASSERT(!process->pageCount());
     ASSERT(!process->provisionalPageCount());
@@ -170,15 +241,19 @@ void WebProcessCache::updateCapacity(WebProcessPool& processPool)
         else
             WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache is disabled because cache model is not PrimaryWebBrowser", 0);
         m_capacity = 0;
+        m_memoryBudget = 0;
     } else {
         size_t memorySize = ramSize() / GB;
         if (memorySize < 3) {
             m_capacity = 0;
+            m_memoryBudget = 0;
             WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache is disabled because device does not have enough RAM", 0);
         } else {
-            // Allow 4 processes in the cache per GB of RAM, up to 30 processes.
-            m_capacity = std::min<unsigned>(memorySize * 4, 30);
-            WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache has a capacity of %u processes", 0, capacity());
+            // Allow 4 processes in the cache per GB of RAM, up to 60 processes, as long as their
+            // footprints add up to less than an eighth of the RAM.
+            m_capacity = std::min<unsigned>(memorySize * 4, 60);
+            m_memoryBudget = ramSize() / 8;
+            WEBPROCESSCACHE_RELEASE_LOG("updateCapacity: Cache has a capacity of %u processes and a memory budget of %zu MB", 0, capacity(), memoryBudget() / MB);
         }
     }
 
@@ -191,7 +266,7 @@ void WebProcessCache::clear()
     if (m_pendingAddRequests.isEmpty() && m_processesPerRegistrableDomain.isEmpty())
         return;
 
-    WEBPROCESSCACHE_RELEASE_LOG("clear: Evicting %u processes", 0, m_pendingAddRequests.size() + m_processesPerRegistrableDomain.size());
+    WEBPROCESSCACHE_RELEASE_LOG("clear: Evicting %u processes (hits=%u, misses=%u, evictedFootprint=%" PRIu64 ")", 0, m_pendingAddRequests.size() + m_processesPerRegistrableDomain.size(), m_hitCount, m_missCount, m_evictedMemoryFootprint);
     m_pendingAddRequests.clear();
     m_processesPerRegistrableDomain.clear();
 }
@@ -219,6 +294,19 @@ void WebProcessCache::clearAllProcessesForSession(PAL::SessionID sessionID)
         m_pendingAddRequests.remove(key);
 }
 
+void WebProcessCache::handleMemoryPressureWarning(Critical critical)
+{
+    if (critical == Critical::Yes) {
+        clear();
+        return;
+    }
+
+    // Only keep the processes that are the most worth their memory until the pressure becomes critical.
+    WEBPROCESSCACHE_RELEASE_LOG("handleMemoryPressureWarning: Evicting processes down to half of the memory budget", 0);
+    m_pendingAddRequests.clear();
+    evictProcessesIfNeeded(m_memoryBudget / 2, capacity());
+}
+
 void WebProcessCache::setApplicationIsActive(bool isActive)
 {
     WEBPROCESSCACHE_RELEASE_LOG("setApplicationIsActive: (isActive=%d)", 0, isActive);
@@ -259,6 +347,7 @@ void WebProcessCache::removeProcess(WebProcessProxy& process, ShouldShutDownProc
 WebProcessCache::CachedProcess::CachedProcess(Ref<WebProcessProxy>&& process)
     : m_process(WTFMove(process))
     , m_evictionTimer(RunLoop::main(), this, &CachedProcess::evictionTimerFired)
+    , m_additionTime(MonotonicTime::now())
 {
     RELEASE_ASSERT(!m_process->pageCount());
     RELEASE_ASSERT_WITH_MESSAGE(!m_process->websiteDataStore().processes().contains(*m_process), "Only processes with pages should be registered with the data store");
@@ -29,7 +29,10 @@
 #include <WebCore/RegistrableDomain.h>
 #include <pal/SessionID.h>
 #include <wtf/HashMap.h>
+#include <wtf/MemoryPressureHandler.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/RunLoop.h>
+#include <wtf/WeakPtr.h>
 #include <wtf/text/WTFString.h>
 
 namespace WebKit {
@@ -38,21 +41,24 @@ class WebProcessPool;
 class WebProcessProxy;
 class WebsiteDataStore;
 
-class WebProcessCache {
+class WebProcessCache : public CanMakeWeakPtr<WebProcessCache> {
     WTF_MAKE_FAST_ALLOCATED;
 public:
     explicit WebProcessCache(WebProcessPool&);
 
     bool addProcessIfPossible(Ref<WebProcessProxy>&&);
     RefPtr<WebProcessProxy> takeProcess(const WebCore::RegistrableDomain&, WebsiteDataStore&);
+    bool hasProcess(const WebCore::RegistrableDomain& registrableDomain) const { return m_processesPerRegistrableDomain.contains(registrableDomain); }
 
     void updateCapacity(WebProcessPool&);
     unsigned capacity() const { return m_capacity; }
+    size_t memoryBudget() const { return m_memoryBudget; }
 
     unsigned size() const { return m_processesPerRegistrableDomain.size(); }
 
     void clear();
     void setApplicationIsActive(bool);
+    void handleMemoryPressureWarning(Critical);
 
     void clearAllProcessesForSession(PAL::SessionID);
 
@@ -72,18 +78,34 @@ private:
         Ref<WebProcessProxy> takeProcess();
         WebProcessProxy& process() { ASSERT(m_process); return *m_process; }
 
+        MonotonicTime additionTime() const { return m_additionTime; }
+        Optional<size_t> memoryFootprint() const { return m_memoryFootprint; }
+        void setMemoryFootprint(size_t footprint) { m_memoryFootprint = footprint; }
+
     private:
         void evictionTimerFired();
 
         RefPtr<WebProcessProxy> m_process;
         RunLoop::Timer<CachedProcess> m_evictionTimer;
+        MonotonicTime m_additionTime;
+        Optional<size_t> m_memoryFootprint;
     };
 
     bool canCacheProcess(WebProcessProxy&) const;
     void platformInitialize();
     bool addProcess(std::unique_ptr<CachedProcess>&&);
 
+    void sampleMemoryFootprint(WebProcessProxy&);
+    void didSampleMemoryFootprint(WebProcessProxy&, size_t);
+    size_t averageMemoryFootprint() const;
+    void evictProcessesIfNeeded(size_t memoryLimit, unsigned processLimit);
+
     unsigned m_capacity { 0 };
+    size_t m_memoryBudget { 0 };
+
+    unsigned m_hitCount { 0 };
+    unsigned m_missCount { 0 };
+    uint64_t m_evictedMemoryFootprint { 0 };
 
     HashMap<uint64_t, std::unique_ptr<CachedProcess>> m_pendingAddRequests;
     HashMap<WebCore::RegistrableDomain, std::unique_ptr<CachedProcess>> m_processesPerRegistrableDomain;
@@ -99,6 +99,7 @@
 #include <wtf/MainThread.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/ProcessPrivilege.h>
+#include <wtf/RAMSize.h>
 #include <wtf/RunLoop.h>
 #include <wtf/Scope.h>
 #include <wtf/URLParser.h>
@@ -265,6 +266,7 @@ WebProcessPool::WebProcessPool(API::ProcessPoolConfiguration& configuration)
     , m_processSuppressionDisabledForPageCounter([this](RefCounterEvent) { updateProcessSuppressionState(); })
     , m_hiddenPageThrottlingAutoIncreasesCounter([this](RefCounterEvent) { m_hiddenPageThrottlingTimer.startOneShot(0_s); })
     , m_hiddenPageThrottlingTimer(RunLoop::main(), this, &WebProcessPool::updateHiddenPageThrottlingAutoIncreaseLimit)
+    , m_processesPrewarmedForRegistrableDomainsExpirationTimer(RunLoop::main(), this, &WebProcessPool::shutDownExpiredProcessesPrewarmedForRegistrableDomains)
 #if ENABLE(GPU_PROCESS)
     , m_resetGPUProcessCrashCountTimer(RunLoop::main(), [this] { m_recentGPUProcessCrashCount = 0; })
 #endif
@@ -569,7 +571,7 @@ void WebProcessPool::establishWorkerContextConnectionToNetworkProcess(NetworkPro
 
     if (!s_useSeparateServiceWorkerProcess) {
         for (auto& process : processPool->m_processes) {
-            if (process == processPool->m_prewarmedProcess || process->isDummyProcessProxy())
+            if (process->isPrewarmed() || process->isDummyProcessProxy())
                 continue;
             if (&process->websiteDataStore() != websiteDataStore)
                 continue;
@@ -690,6 +692,27 @@ RefPtr<WebProcessProxy> WebProcessPool::tryTakePrewarmedProcess(WebsiteDataStore
     return std::exchange(m_prewarmedProcess, nullptr);
 }
 
+RefPtr<WebProcessProxy> WebProcessPool::tryTakeProcessPrewarmedForRegistrableDomain(WebsiteDataStore& websiteDataStore, const RegistrableDomain& registrableDomain)
+{
+    auto it = m_processesPrewarmedForRegistrableDomain.find(registrableDomain);
+    if (it == m_processesPrewarmedForRegistrableDomain.end())
+        return nullptr;
+
+    auto* process = it->value.process;
+    m_processesPrewarmedForRegistrableDomain.remove(it);
+
+    if (process->wasTerminated()) {
+        WEBPROCESSPOOL_RELEASE_LOG_ERROR(Process, "tryTakeProcessPrewarmedForRegistrableDomain: Not using prewarmed process because it has been terminated (process=%p, PID=%d)", process, process->processIdentifier());
+        return nullptr;
+    }
+
+    ASSERT(process->isPrewarmed());
+    process->markIsNoLongerInPrewarmedPool();
+    process->setWebsiteDataStore(websiteDataStore);
+
+    return process;
+}
+
 #if PLATFORM(MAC)
 static void displayReconfigurationCallBack(CGDirectDisplayID display, CGDisplayChangeSummaryFlags flags, void *userInfo)
 {
@@ -872,11 +895,8 @@ void WebProcessPool::initializeNewWebProcess(WebProcessProxy& process, WebsiteDa
 
     ASSERT(m_messagesToInjectedBundlePostedToEmptyContext.isEmpty());
 
-    if (isPrewarmed == WebProcessProxy::IsPrewarmed::Yes) {
-        ASSERT(!m_prewarmedProcess);
-        m_prewarmedProcess = &process;
+    if (isPrewarmed == WebProcessProxy::IsPrewarmed::Yes)
         process.send(Messages::WebProcess::PrewarmGlobally(), 0);
-    }
 
 #if PLATFORM(IOS_FAMILY) && !PLATFORM(MACCATALYST)
     process.send(Messages::WebProcess::BacklightLevelDidChange(displayBrightness()), 0);
@@ -895,7 +915,90 @@ void WebProcessPool::prewarmProcess()
         return;
 
     WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "prewarmProcess: Prewarming a WebProcess for performance");
-    createNewWebProcess(nullptr, WebProcessProxy::IsPrewarmed::Yes);
+    m_prewarmedProcess = &createNewWebProcess(nullptr, WebProcessProxy::IsPrewarmed::Yes);
+}
+
+void WebProcessPool::prewarmProcessesForPredictedRegistrableDomains(const RegistrableDomain& currentRegistrableDomain)
+{
+    static const unsigned maximumProcessCountPrewarmedForRegistrableDomains = 2;
+    static const Seconds processesPrewarmedForRegistrableDomainsLifetime { 60_s };
+
+    // Like the WebProcess cache, don't keep extra processes around on devices with little RAM.
+    static bool hasEnoughMemory = ramSize() / GB >= 3;
+    if (!hasEnoughMemory)
+        return;
+
+#if PLATFORM(GTK) || PLATFORM(WPE)
+    // Prewarmed processes are not used when sandboxing is enabled, see tryTakePrewarmedProcess().
+    if (m_sandboxEnabled)
+        return;
+#endif
+
+    auto expirationTime = MonotonicTime::now() + processesPrewarmedForRegistrableDomainsLifetime;
+    auto predictedRegistrableDomains = m_prewarmPredictor.predictedRegistrableDomains(currentRegistrableDomain, maximumProcessCountPrewarmedForRegistrableDomains);
+    for (auto& registrableDomain : predictedRegistrableDomains) {
+        // Processes prewarmed for earlier predictions are kept until they are used or are no longer predicted
+        // for a while, so that loads in other pages don't keep replacing them.
+        auto it = m_processesPrewarmedForRegistrableDomain.find(registrableDomain);
+        if (it != m_processesPrewarmedForRegistrableDomain.end()) {
+            it->value.expirationTime = expirationTime;
+            continue;
+        }
+
+        if (m_processesPrewarmedForRegistrableDomain.size() >= maximumProcessCountPrewarmedForRegistrableDomains)
+            continue;
+
+        // Navigations to domains that have a cached process will use it instead.
+        if (webProcessCache().hasProcess(registrableDomain))
+            continue;
+
+        WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "prewarmProcessesForPredictedRegistrableDomains: Prewarming a WebProcess for a likely next registrable domain");
+        auto& process = createNewWebProcess(nullptr, WebProcessProxy::IsPrewarmed::Yes);
+        tryPrewarmWithDomainInformation(process, registrableDomain);
+        m_processesPrewarmedForRegistrableDomain.add(registrableDomain, ProcessPrewarmedForRegistrableDomain { &process, expirationTime });
+    }
+
+    if (!m_processesPrewarmedForRegistrableDomain.isEmpty() && !m_processesPrewarmedForRegistrableDomainsExpirationTimer.isActive())
+        m_processesPrewarmedForRegistrableDomainsExpirationTimer.startOneShot(processesPrewarmedForRegistrableDomainsLifetime);
+}
+
+void WebProcessPool::shutDownExpiredProcessesPrewarmedForRegistrableDomains()
+{
+    auto now = MonotonicTime::now();
+    Vector<RefPtr<WebProcessProxy>> expiredProcesses;
+    auto nextExpirationTime = MonotonicTime::infinity();
+    for (auto& entry : m_processesPrewarmedForRegistrableDomain.values()) {
+        if (entry.expirationTime <= now)
+            expiredProcesses.append(entry.process);
+        else
+            nextExpirationTime = std::min(nextExpirationTime, entry.expirationTime);
+    }
+
+    // Shutting down a process removes it from m_processesPrewarmedForRegistrableDomain.
+    for (auto& process : expiredProcesses)
+        process->shutDown();
+
+    if (nextExpirationTime != MonotonicTime::infinity())
+        m_processesPrewarmedForRegistrableDomainsExpirationTimer.startOneShot(nextExpirationTime - now);
+}
+
+void WebProcessPool::shutDownProcessesPrewarmedForRegistrableDomains()
+{
+    m_processesPrewarmedForRegistrableDomainsExpirationTimer.stop();
+
+    Vector<RefPtr<WebProcessProxy>> processes;
+    for (auto& entry : m_processesPrewarmedForRegistrableDomain.values())
+        processes.append(entry.process);
+
+    for (auto& process : processes)
+        process->shutDown();
+    ASSERT(m_processesPrewarmedForRegistrableDomain.isEmpty());
+}
+
+void WebProcessPool::clearPrewarmPredictions()
+{
+    m_prewarmPredictor.clear();
+    shutDownProcessesPrewarmedForRegistrableDomains();
 }
 
 void WebProcessPool::enableProcessTermination()
@@ -954,6 +1057,10 @@ void WebProcessPool::disconnectProcess(WebProcessProxy* process)
     if (m_prewarmedProcess == process) {
         ASSERT(m_prewarmedProcess->isPrewarmed());
         m_prewarmedProcess = nullptr;
+    } else if (process->isPrewarmed()) {
+        m_processesPrewarmedForRegistrableDomain.removeIf([process](auto& entry) {
+            return entry.value.process == process;
+        });
     } else if (process->isDummyProcessProxy()) {
         auto removedProcess = m_dummyProcessProxies.take(process->sessionID());
         ASSERT_UNUSED(removedProcess, removedProcess == process);
@@ -980,6 +1087,7 @@ void WebProcessPool::disconnectProcess(WebProcessProxy* process)
 #endif
 
     removeProcessFromOriginCacheSet(*process);
+    m_pendingFirstLayoutMeasurements.remove(process->coreProcessIdentifier());
 }
 
 WebProcessProxy& WebProcessPool::processForRegistrableDomain(WebsiteDataStore& websiteDataStore, WebPageProxy* page, const RegistrableDomain& registrableDomain)
@@ -993,17 +1101,29 @@ WebProcessProxy& WebProcessPool::processForRegistrableDomain(WebsiteDataStore& w
             WEBPROCESSPOOL_RELEASE_LOG(ProcessSwapping, "processForRegistrableDomain: Using WebProcess from a SuspendedPage (process=%p, PID=%i)", process.get(), process->processIdentifier());
             return *process;
         }
+
+        if (auto process = tryTakeProcessPrewarmedForRegistrableDomain(websiteDataStore, registrableDomain)) {
+            WEBPROCESSPOOL_RELEASE_LOG(ProcessSwapping, "processForRegistrableDomain: Using process prewarmed for the registrable domain (process=%p, PID=%i)", process.get(), process->processIdentifier());
+            didChooseProcessForRegistrableDomain(*process, WebProcessPrewarmPredictor::Outcome::Hit);
+            return *process;
+        }
     }
 
     if (auto process = tryTakePrewarmedProcess(websiteDataStore)) {
         WEBPROCESSPOOL_RELEASE_LOG(ProcessSwapping, "processForRegistrableDomain: Using prewarmed process (process=%p, PID=%i)", process.get(), process->processIdentifier());
-        if (!registrableDomain.isEmpty())
+        if (!registrableDomain.isEmpty()) {
             tryPrewarmWithDomainInformation(*process, registrableDomain);
+            didChooseProcessForRegistrableDomain(*process, WebProcessPrewarmPredictor::Outcome::Miss);
+        }
         return *process;
     }
 
-    if (!usesSingleWebProcess())
-        return createNewWebProcess(&websiteDataStore);
+    if (!usesSingleWebProcess()) {
+        auto& process = createNewWebProcess(&websiteDataStore);
+        if (!registrableDomain.isEmpty())
+            didChooseProcessForRegistrableDomain(process, WebProcessPrewarmPredictor::Outcome::Miss);
+        return process;
+    }
 
 #if PLATFORM(COCOA)
     bool mustMatchDataStore = WebKit::WebsiteDataStore::defaultDataStoreExists() && &websiteDataStore != WebKit::WebsiteDataStore::defaultDataStore().ptr();
@@ -1012,7 +1132,7 @@ WebProcessProxy& WebProcessPool::processForRegistrableDomain(WebsiteDataStore& w
 #endif
 
     for (auto& process : m_processes) {
-        if (process == m_prewarmedProcess || process->isDummyProcessProxy())
+        if (process->isPrewarmed() || process->isDummyProcessProxy())
             continue;
 #if ENABLE(SERVICE_WORKER)
         if (process->isRunningServiceWorkers())
@@ -1191,7 +1311,26 @@ void WebProcessPool::postMessageToInjectedBundle(const String& messageName, API:
     }
 }
 
-void WebProcessPool::didReachGoodTimeToPrewarm()
+void WebProcessPool::didChooseProcessForRegistrableDomain(WebProcessProxy& process, WebProcessPrewarmPredictor::Outcome outcome)
+{
+    if (!configuration().isAutomaticProcessWarmingEnabled())
+        return;
+
+    m_prewarmPredictor.didChooseProcessForNavigation(outcome);
+    m_pendingFirstLayoutMeasurements.set(process.coreProcessIdentifier(), PendingFirstLayoutMeasurement { outcome, MonotonicTime::now() });
+}
+
+void WebProcessPool::didReachFirstVisuallyNonEmptyLayout(WebProcessProxy& process)
+{
+    auto it = m_pendingFirstLayoutMeasurements.find(process.coreProcessIdentifier());
+    if (it == m_pendingFirstLayoutMeasurements.end())
+        return;
+
+    m_prewarmPredictor.didReachFirstVisuallyNonEmptyLayout(it->value.outcome, MonotonicTime::now() - it->value.processChoiceTime);
+    m_pendingFirstLayoutMeasurements.remove(it);
+}
+
+void WebProcessPool::didReachGoodTimeToPrewarm(const RegistrableDomain& currentRegistrableDomain)
 {
     if (!configuration().isAutomaticProcessWarmingEnabled() || !configuration().processSwapsOnNavigation() || usesSingleWebProcess())
         return;
@@ -1203,6 +1342,7 @@ void WebProcessPool::didReachGoodTimeToPrewarm()
     }
 
     prewarmProcess();
+    prewarmProcessesForPredictedRegistrableDomains(currentRegistrableDomain);
 }
 
 void WebProcessPool::populateVisitedLinks()
@@ -1217,18 +1357,19 @@ WebProcessPool::Statistics& WebProcessPool::statistics()
     return statistics;
 }
 
-void WebProcessPool::handleMemoryPressureWarning(Critical)
+void WebProcessPool::handleMemoryPressureWarning(Critical critical)
 {
     WEBPROCESSPOOL_RELEASE_LOG(PerformanceLogging, "handleMemoryPressureWarning:");
 
     // Clear back/forward cache first as processes removed from the back/forward cache will likely
     // be added to the WebProcess cache.
     m_backForwardCache->clear();
-    m_webProcessCache->clear();
+    m_webProcessCache->handleMemoryPressureWarning(critical);
 
     if (m_prewarmedProcess)
         m_prewarmedProcess->shutDown();
     ASSERT(!m_prewarmedProcess);
+    shutDownProcessesPrewarmedForRegistrableDomains();
 }
 
 #if ENABLE(NETSCAPE_PLUGIN_API)
@@ -1892,6 +2033,9 @@ void WebProcessPool::processForNavigationInternal(WebPageProxy& page, const API:
     if (!sourceURL.isValid() || !targetURL.isValid() || sourceURL.isEmpty() || sourceURL.protocolIsAbout() || targetRegistrableDomain.matches(sourceURL))
         return completionHandler(WTFMove(sourceProcess), nullptr, "Navigation is same-site"_s);
 
+    if (!dataStore->sessionID().isEphemeral())
+        m_prewarmPredictor.didNavigate(RegistrableDomain { sourceURL }, targetRegistrableDomain);
+
     String reason = "Navigation is cross-site"_s;
     
     if (m_configuration->alwaysKeepAndReuseSwappedProcesses()) {
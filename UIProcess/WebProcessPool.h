@@ -40,6 +40,7 @@
 #include "WebContextClient.h"
 #include "WebContextConnectionClient.h"
 #include "WebPreferencesStore.h"
+#include "WebProcessPrewarmPredictor.h"
 #include "WebProcessProxy.h"
 #include "WebsiteDataStore.h"
 #include <WebCore/CrossSiteNavigationDataTransfer.h>
@@ -51,6 +52,7 @@
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
 #include <wtf/MemoryPressureHandler.h>
+#include <wtf/MonotonicTime.h>
 #include <wtf/OptionSet.h>
 #include <wtf/RefCounter.h>
 #include <wtf/RefPtr.h>
@@ -440,7 +442,9 @@ public:
 
     void processForNavigation(WebPageProxy&, const API::Navigation&, Ref<WebProcessProxy>&& sourceProcess, const URL& sourceURL, ProcessSwapRequestedByClient, Ref<WebsiteDataStore>&&, CompletionHandler<void(Ref<WebProcessProxy>&&, SuspendedPageProxy*, const String&)>&&);
 
-    void didReachGoodTimeToPrewarm();
+    void didReachGoodTimeToPrewarm(const WebCore::RegistrableDomain& currentRegistrableDomain);
+    void didReachFirstVisuallyNonEmptyLayout(WebProcessProxy&);
+    void clearPrewarmPredictions();
 
     void didCollectPrewarmInformation(const WebCore::RegistrableDomain&, const WebCore::PrewarmInformation&);
 
@@ -513,6 +517,11 @@ private:
     void processForNavigationInternal(WebPageProxy&, const API::Navigation&, Ref<WebProcessProxy>&& sourceProcess, const URL& sourceURL, ProcessSwapRequestedByClient, Ref<WebsiteDataStore>&&, CompletionHandler<void(Ref<WebProcessProxy>&&, SuspendedPageProxy*, const String&)>&&);
 
     RefPtr<WebProcessProxy> tryTakePrewarmedProcess(WebsiteDataStore&);
+    RefPtr<WebProcessProxy> tryTakeProcessPrewarmedForRegistrableDomain(WebsiteDataStore&, const WebCore::RegistrableDomain&);
+    void prewarmProcessesForPredictedRegistrableDomains(const WebCore::RegistrableDomain& currentRegistrableDomain);
+    void shutDownProcessesPrewarmedForRegistrableDomains();
+    void shutDownExpiredProcessesPrewarmedForRegistrableDomains();
+    void didChooseProcessForRegistrableDomain(WebProcessProxy&, WebProcessPrewarmPredictor::Outcome);
 
     WebProcessProxy& createNewWebProcess(WebsiteDataStore*, WebProcessProxy::IsPrewarmed = WebProcessProxy::IsPrewarmed::No);
     void initializeNewWebProcess(WebProcessProxy&, WebsiteDataStore*, WebProcessProxy::IsPrewarmed = WebProcessProxy::IsPrewarmed::No);
@@ -577,6 +586,11 @@ private:
 
     Vector<RefPtr<WebProcessProxy>> m_processes;
     WebProcessProxy* m_prewarmedProcess { nullptr };
+    struct ProcessPrewarmedForRegistrableDomain {
+        WebProcessProxy* process;
+        MonotonicTime expirationTime;
+    };
+    HashMap<WebCore::RegistrableDomain, ProcessPrewarmedForRegistrableDomain> m_processesPrewarmedForRegistrableDomain;
 
     HashMap<PAL::SessionID, WeakPtr<WebProcessProxy>> m_dummyProcessProxies; // Lightweight WebProcessProxy objects without backing process.
 
@@ -676,6 +690,7 @@ private:
     ProcessSuppressionDisabledCounter m_processSuppressionDisabledForPageCounter;
     HiddenPageThrottlingAutoIncreasesCounter m_hiddenPageThrottlingAutoIncreasesCounter;
     RunLoop::Timer<WebProcessPool> m_hiddenPageThrottlingTimer;
+    RunLoop::Timer<WebProcessPool> m_processesPrewarmedForRegistrableDomainsExpirationTimer;
 
 #if ENABLE(GPU_PROCESS)
     RunLoop::Timer<WebProcessPool> m_resetGPUProcessCrashCountTimer;
@@ -731,6 +746,13 @@ private:
 
     HashMap<WebCore::RegistrableDomain, std::unique_ptr<WebCore::PrewarmInformation>> m_prewarmInformationPerRegistrableDomain;
 
+    WebProcessPrewarmPredictor m_prewarmPredictor;
+    struct PendingFirstLayoutMeasurement {
+        WebProcessPrewarmPredictor::Outcome outcome;
+        MonotonicTime processChoiceTime;
+    };
+    HashMap<WebCore::ProcessIdentifier, PendingFirstLayoutMeasurement> m_pendingFirstLayoutMeasurements;
+
 #if PLATFORM(MAC) && ENABLE(WEBPROCESS_WINDOWSERVER_BLOCKING)
     Vector<std::unique_ptr<DisplayLink>> m_displayLinks;
 #endif
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "WebProcessPrewarmPredictor.h"
+
+#include "Logging.h"
+#include <wtf/StdLibExtras.h>
+
+namespace WebKit {
+using namespace WebCore;
+
+#define WEBPROCESSPREWARMPREDICTOR_RELEASE_LOG(fmt, ...) RELEASE_LOG(PerformanceLogging, "%p - WebProcessPrewarmPredictor::" fmt, this, ##__VA_ARGS__)
+
+// A domain is only predicted once it has been navigated to this many times, so one-off visits don't cost a process.
+static const unsigned minimumNavigationCountForPrediction = 2;
+
+static const size_t maximumSizeToPreventUnlimitedGrowth = 100;
+static const size_t maximumTargetCountPerRegistrableDomain = 20;
+
+template<typename Value>
+static void makeRoomIfNeeded(HashMap<RegistrableDomain, Value>& map, size_t maximumSize, const RegistrableDomain& registrableDomain)
+{
+    if (map.size() >= maximumSize && !map.contains(registrableDomain))
+        map.remove(map.random());
+}
+
+static void appendMostFrequentRegistrableDomains(Vector<RegistrableDomain>& result, const HashMap<RegistrableDomain, unsigned>& counts, const RegistrableDomain& excludedRegistrableDomain, unsigned maximumCount)
+{
+    Vector<std::pair<RegistrableDomain, unsigned>> candidates;
+    for (auto& entry : counts) {
+        if (entry.value < minimumNavigationCountForPrediction || entry.key == excludedRegistrableDomain || result.contains(entry.key))
+            continue;
+        candidates.append({ entry.key, entry.value });
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](auto& a, auto& b) {
+        return a.second > b.second;
+    });
+
+    for (auto& candidate : candidates) {
+        if (result.size() >= maximumCount)
+            return;
+        result.append(WTFMove(candidate.first));
+    }
+}
+
+void WebProcessPrewarmPredictor::didNavigate(const RegistrableDomain& sourceRegistrableDomain, const RegistrableDomain& targetRegistrableDomain)
+{
+    if (targetRegistrableDomain.isEmpty())
+        return;
+
+    makeRoomIfNeeded(m_visitCounts, maximumSizeToPreventUnlimitedGrowth, targetRegistrableDomain);
+    ++m_visitCounts.add(targetRegistrableDomain, 0).iterator->value;
+
+    if (sourceRegistrableDomain.isEmpty())
+        return;
+
+    makeRoomIfNeeded(m_navigationCounts, maximumSizeToPreventUnlimitedGrowth, sourceRegistrableDomain);
+    auto& targetCounts = m_navigationCounts.add(sourceRegistrableDomain, HashMap<RegistrableDomain, unsigned> { }).iterator->value;
+    makeRoomIfNeeded(targetCounts, maximumTargetCountPerRegistrableDomain, targetRegistrableDomain);
+    ++targetCounts.add(targetRegistrableDomain, 0).iterator->value;
+}
+
+Vector<RegistrableDomain> WebProcessPrewarmPredictor::predictedRegistrableDomains(const RegistrableDomain& currentRegistrableDomain, unsigned maximumCount) const
+{
+    Vector<RegistrableDomain> result;
+
+    // Domains usually navigated to from the current one come first, then the most visited ones.
+    auto it = m_navigationCounts.find(currentRegistrableDomain);
+    if (it != m_navigationCounts.end())
+        appendMostFrequentRegistrableDomains(result, it->value, currentRegistrableDomain, maximumCount);
+    appendMostFrequentRegistrableDomains(result, m_visitCounts, currentRegistrableDomain, maximumCount);
+
+    return result;
+}
+
+void WebProcessPrewarmPredictor::clear()
+{
+    m_navigationCounts.clear();
+    m_visitCounts.clear();
+}
+
+void WebProcessPrewarmPredictor::didChooseProcessForNavigation(Outcome outcome)
+{
+    if (outcome == Outcome::Hit)
+        ++m_hitCount;
+    else
+        ++m_missCount;
+
+    WEBPROCESSPREWARMPREDICTOR_RELEASE_LOG("didChooseProcessForNavigation: %s (hits=%u, misses=%u)", outcome == Outcome::Hit ? "hit" : "miss", m_hitCount, m_missCount);
+}
+
+void WebProcessPrewarmPredictor::didReachFirstVisuallyNonEmptyLayout(Outcome outcome, Seconds timeSinceProcessWasChosen)
+{
+    auto& time = layoutTime(outcome);
+    time.total += timeSinceProcessWasChosen;
+    ++time.count;
+
+    WEBPROCESSPREWARMPREDICTOR_RELEASE_LOG("didReachFirstVisuallyNonEmptyLayout: %.0fms (average for hits=%.0fms, average for misses=%.0fms)", timeSinceProcessWasChosen.milliseconds(), m_layoutTimeForHits.average().milliseconds(), m_layoutTimeForMisses.average().milliseconds());
+}
+
+} // namespace WebKit
@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <WebCore/RegistrableDomain.h>
+#include <wtf/HashMap.h>
+#include <wtf/Seconds.h>
+#include <wtf/Vector.h>
+
+namespace WebKit {
+
+// Predicts the registrable domains the next cross-site navigations will go to from the ones seen so far,
+// so processes can be prewarmed for them, and keeps track of how useful these processes turn out to be.
+class WebProcessPrewarmPredictor {
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    void didNavigate(const WebCore::RegistrableDomain& sourceRegistrableDomain, const WebCore::RegistrableDomain& targetRegistrableDomain);
+    Vector<WebCore::RegistrableDomain> predictedRegistrableDomains(const WebCore::RegistrableDomain& currentRegistrableDomain, unsigned maximumCount) const;
+
+    enum class Outcome : bool { Miss, Hit };
+    void didChooseProcessForNavigation(Outcome);
+    void didReachFirstVisuallyNonEmptyLayout(Outcome, Seconds timeSinceProcessWasChosen);
+
+    // The navigation history the predictions are based on is browsing data.
+    void clear();
+
+private:
+    struct LayoutTime {
+        Seconds total;
+        unsigned count { 0 };
+
+        Seconds average() const { return count ? total / count : 0_s; }
+    };
+    LayoutTime& layoutTime(Outcome outcome) { return outcome == Outcome::Hit ? m_layoutTimeForHits : m_layoutTimeForMisses; }
+
+    HashMap<WebCore::RegistrableDomain, HashMap<WebCore::RegistrableDomain, unsigned>> m_navigationCounts;
+    HashMap<WebCore::RegistrableDomain, unsigned> m_visitCounts;
+
+    unsigned m_hitCount { 0 };
+    unsigned m_missCount { 0 };
+    LayoutTime m_layoutTimeForHits;
+    LayoutTime m_layoutTimeForMisses;
+};
+
+} // namespace WebKit
@@ -202,7 +202,10 @@ WebProcessProxy::WebProcessProxy(WebProcessPool& processPool, WebsiteDataStore*
     , m_routingArbitrator(makeUniqueRef<AudioSessionRoutingArbitratorProxy>(*this))
 #endif
     , m_isResponsive(NoOrMaybe::Maybe)
-    , m_visiblePageCounter([this](RefCounterEvent) { updateBackgroundResponsivenessTimer(); })
+    , m_visiblePageCounter([this](RefCounterEvent) {
+        updateBackgroundResponsivenessTimer();
+        updateUnthrottledActivity();
+    })
     , m_websiteDataStore(websiteDataStore)
 #if PLATFORM(COCOA) && ENABLE(MEDIA_STREAM)
     , m_userMediaCaptureManagerProxy(makeUnique<UserMediaCaptureManagerProxy>(makeUniqueRef<UIProxyForCapture>(*this)))
@@ -453,6 +456,10 @@ void WebProcessProxy::shutDown()
         ASSERT(!m_isInProcessCache);
     }
 
+#if OS(LINUX)
+    ProcessAssertion::setProcessCanBeThrottled(processIdentifier(), false);
+#endif
+
     shutDownProcess();
 
     if (m_webConnection) {
@@ -464,6 +471,9 @@ void WebProcessProxy::shutDown()
     m_backgroundResponsivenessTimer.invalidate();
     m_activityForHoldingLockedFiles = nullptr;
     m_audibleMediaActivity = WTF::nullopt;
+#if OS(LINUX)
+    m_unthrottledActivity = nullptr;
+#endif
 
     for (auto& frame : copyToVector(m_frameMap.values()))
         frame->webProcessWillShutDown();
@@ -1037,6 +1047,13 @@ void WebProcessProxy::didFinishLaunching(ProcessLauncher* launcher, IPC::Connect
     }
 #endif
 
+#if OS(LINUX)
+    if (ProcessAssertion::isProcessThrottlingEnabled()) {
+        ProcessAssertion::setProcessCanBeThrottled(processIdentifier(), true);
+        m_throttler.didConnectToProcess(processIdentifier());
+    }
+#endif
+
 #if PLATFORM(COCOA)
     unblockAccessibilityServerIfNeeded();
 #if ENABLE(REMOTE_INSPECTOR)
@@ -1481,6 +1498,8 @@ void WebProcessProxy::didSetAssertionType(ProcessAssertionType type)
 
 void WebProcessProxy::updateAudibleMediaAssertions()
 {
+    updateUnthrottledActivity();
+
     bool newHasAudibleWebPage = WTF::anyOf(m_pageMap.values(), [] (auto& page) { return page->isPlayingAudio(); });
 
     bool hasAudibleMediaActivity = !!m_audibleMediaActivity;
@@ -1639,6 +1658,25 @@ void WebProcessProxy::updateBackgroundResponsivenessTimer()
     m_backgroundResponsivenessTimer.updateState();
 }
 
+void WebProcessProxy::updateUnthrottledActivity()
+{
+#if OS(LINUX)
+    // On iOS, WebPageProxy::updateThrottleState() takes activities per page instead. Besides visible pages,
+    // hidden pages playing audio or capturing media and service workers, which serve fetches of other
+    // processes, must keep running.
+    bool shouldRun = visiblePageCount() || isRunningServiceWorkers() || WTF::anyOf(m_pageMap.values(), [](auto& page) {
+        return page->isPlayingAudio() || page->isCapturingMedia();
+    });
+    if (!shouldRun) {
+        m_unthrottledActivity = nullptr;
+        return;
+    }
+
+    if (!m_unthrottledActivity || !m_unthrottledActivity->isValid())
+        m_unthrottledActivity = m_throttler.foregroundActivity("Process must keep running"_s).moveToUniquePtr();
+#endif
+}
+
 #if !PLATFORM(COCOA)
 const HashSet<String>& WebProcessProxy::platformPathsWithAssumedReadAccess()
 {
@@ -1914,6 +1952,7 @@ void WebProcessProxy::disableServiceWorkers()
 
     m_serviceWorkerInformation = { };
     updateBackgroundResponsivenessTimer();
+    updateUnthrottledActivity();
 
 #if ENABLE(SERVICE_WORKER)
     processPool().removeFromServiceWorkerProcesses(*this);
@@ -1956,6 +1995,7 @@ void WebProcessProxy::enableServiceWorkers(const UserContentControllerIdentifier
         { }
     };
     updateBackgroundResponsivenessTimer();
+    updateUnthrottledActivity();
 #if ENABLE(SERVICE_WORKER)
     updateServiceWorkerProcessAssertion();
 #endif
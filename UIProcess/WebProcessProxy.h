@@ -477,6 +477,7 @@ private:
 
     ResponsivenessTimer& responsivenessTimer() { return m_responsivenessTimer; }
     void updateBackgroundResponsivenessTimer();
+    void updateUnthrottledActivity();
 
     void processDidTerminateOrFailedToLaunch();
 
@@ -601,6 +602,9 @@ private:
     Vector<CompletionHandler<void(bool webProcessIsResponsive)>> m_isResponsiveCallbacks;
 
     VisibleWebPageCounter m_visiblePageCounter;
+#if OS(LINUX)
+    std::unique_ptr<ProcessThrottler::ForegroundActivity> m_unthrottledActivity;
+#endif
 
     RefPtr<WebsiteDataStore> m_websiteDataStore;
 
@@ -775,6 +775,7 @@ void WebsiteDataStore::removeData(OptionSet<WebsiteDataType> dataTypes, WallTime
             // be added to the WebProcess cache.
             processPool->backForwardCache().removeEntriesForSession(sessionID());
             processPool->webProcessCache().clearAllProcessesForSession(sessionID());
+            processPool->clearPrewarmPredictions();
         }
 
         for (auto& process : processes()) {
@@ -1039,6 +1040,9 @@ void WebsiteDataStore::removeData(OptionSet<WebsiteDataType> dataTypes, const Ve
 
     auto webProcessAccessType = computeWebProcessAccessTypeForDataRemoval(dataTypes, !isPersistent());
     if (webProcessAccessType != ProcessAccessType::None) {
+        for (auto& processPool : processPools())
+            processPool->clearPrewarmPredictions();
+
         for (auto& process : processes()) {
             switch (webProcessAccessType) {
             case ProcessAccessType::OnlyIfLaunched:
@@ -1198,6 +1202,13 @@ void WebsiteDataStore::resetServiceWorkerTimeoutForTesting()
     networkProcess().sendSync(Messages::NetworkProcess::ResetServiceWorkerFetchTimeoutForTesting(), Messages::NetworkProcess::ResetServiceWorkerFetchTimeoutForTesting::Reply(), 0);
 }
 
+#if ENABLE(SERVICE_WORKER)
+void WebsiteDataStore::setServiceWorkerCacheFirstRoutes(const URL& scopeURL, const String& cacheName, const Vector<String>& urlPrefixes)
+{
+    networkProcess().send(Messages::NetworkProcess::SetServiceWorkerCacheFirstRoutes(m_sessionID, scopeURL, cacheName, urlPrefixes), 0);
+}
+#endif
+
 #if ENABLE(RESOURCE_LOAD_STATISTICS)
 void WebsiteDataStore::setMaxStatisticsEntries(size_t maximumEntryCount, CompletionHandler<void()>&& completionHandler)
 {
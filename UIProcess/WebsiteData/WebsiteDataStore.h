@@ -168,6 +168,11 @@ public:
     void setCacheModelSynchronouslyForTesting(CacheModel);
     void setServiceWorkerTimeoutForTesting(Seconds);
     void resetServiceWorkerTimeoutForTesting();
+#if ENABLE(SERVICE_WORKER)
+    // Requests of the registration with this scope matching one of the URL prefixes are answered from the
+    // named CacheStorage cache without running the service worker. Empty prefixes remove the routes.
+    void setServiceWorkerCacheFirstRoutes(const URL& scopeURL, const String& cacheName, const Vector<String>& urlPrefixes);
+#endif
 
 #if ENABLE(RESOURCE_LOAD_STATISTICS)
     void fetchDataForRegistrableDomains(OptionSet<WebsiteDataType>, OptionSet<WebsiteDataFetchOption>, const Vector<WebCore::RegistrableDomain>&, CompletionHandler<void(Vector<WebsiteDataRecord>&&, HashSet<WebCore::RegistrableDomain>&&)>&&);
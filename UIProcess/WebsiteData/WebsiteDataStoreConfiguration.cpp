@@ -93,6 +93,14 @@ Ref<WebsiteDataStoreConfiguration> WebsiteDataStoreConfiguration::copy() const
     copy->m_preventsSystemHTTPProxyAuthentication = this->m_preventsSystemHTTPProxyAuthentication;
     copy->m_standaloneApplicationURL = this->m_standaloneApplicationURL;
     copy->m_enableInAppBrowserPrivacyForTesting = this->m_enableInAppBrowserPrivacyForTesting;
+#if USE(SOUP)
+    copy->m_segmentedDownloadsEnabled = this->m_segmentedDownloadsEnabled;
+    copy->m_webSocketDeflateEnabled = this->m_webSocketDeflateEnabled;
+    copy->m_webSocketDeflateClientMaxWindowBits = this->m_webSocketDeflateClientMaxWindowBits;
+    copy->m_webSocketDeflateServerMaxWindowBits = this->m_webSocketDeflateServerMaxWindowBits;
+    copy->m_webSocketDeflateClientNoContextTakeover = this->m_webSocketDeflateClientNoContextTakeover;
+    copy->m_webSocketDeflateServerNoContextTakeover = this->m_webSocketDeflateServerNoContextTakeover;
+#endif
 #if PLATFORM(COCOA)
     if (m_proxyConfiguration)
         copy->m_proxyConfiguration = adoptCF(CFDictionaryCreateCopy(nullptr, this->m_proxyConfiguration.get()));
@@ -165,7 +165,27 @@ public:
 
     bool enableInAppBrowserPrivacyForTesting() const { return m_enableInAppBrowserPrivacyForTesting; }
     void setEnableInAppBrowserPrivacyForTesting(bool value) { m_enableInAppBrowserPrivacyForTesting = value; }
-    
+
+#if USE(SOUP)
+    // Downloads from servers that support range requests are loaded with several parallel requests.
+    bool segmentedDownloadsEnabled() const { return m_segmentedDownloadsEnabled; }
+    void setSegmentedDownloadsEnabled(bool enabled) { m_segmentedDownloadsEnabled = enabled; }
+
+    bool webSocketDeflateEnabled() const { return m_webSocketDeflateEnabled; }
+    void setWebSocketDeflateEnabled(bool enabled) { m_webSocketDeflateEnabled = enabled; }
+
+    // permessage-deflate window sizes must be between 8 and 15 bits.
+    uint8_t webSocketDeflateClientMaxWindowBits() const { return m_webSocketDeflateClientMaxWindowBits; }
+    void setWebSocketDeflateClientMaxWindowBits(uint8_t bits) { m_webSocketDeflateClientMaxWindowBits = std::min<uint8_t>(std::max<uint8_t>(bits, 8), 15); }
+    uint8_t webSocketDeflateServerMaxWindowBits() const { return m_webSocketDeflateServerMaxWindowBits; }
+    void setWebSocketDeflateServerMaxWindowBits(uint8_t bits) { m_webSocketDeflateServerMaxWindowBits = std::min<uint8_t>(std::max<uint8_t>(bits, 8), 15); }
+
+    bool webSocketDeflateClientNoContextTakeover() const { return m_webSocketDeflateClientNoContextTakeover; }
+    void setWebSocketDeflateClientNoContextTakeover(bool noContextTakeover) { m_webSocketDeflateClientNoContextTakeover = noContextTakeover; }
+    bool webSocketDeflateServerNoContextTakeover() const { return m_webSocketDeflateServerNoContextTakeover; }
+    void setWebSocketDeflateServerNoContextTakeover(bool noContextTakeover) { m_webSocketDeflateServerNoContextTakeover = noContextTakeover; }
+#endif
+
 private:
     IsPersistent m_isPersistent { IsPersistent::No };
 
@@ -212,6 +232,14 @@ private:
     unsigned m_testSpeedMultiplier { 1 };
     URL m_standaloneApplicationURL;
     bool m_enableInAppBrowserPrivacyForTesting { false };
+#if USE(SOUP)
+    bool m_segmentedDownloadsEnabled { false };
+    bool m_webSocketDeflateEnabled { true };
+    uint8_t m_webSocketDeflateClientMaxWindowBits { 15 };
+    uint8_t m_webSocketDeflateServerMaxWindowBits { 15 };
+    bool m_webSocketDeflateClientNoContextTakeover { false };
+    bool m_webSocketDeflateServerNoContextTakeover { false };
+#endif
 #if PLATFORM(COCOA)
     RetainPtr<CFDictionaryRef> m_proxyConfiguration;
 #endif
@@ -41,6 +41,12 @@ void WebsiteDataStore::platformSetNetworkParameters(WebsiteDataStoreParameters&
     networkSessionParameters.persistentCredentialStorageEnabled = m_persistentCredentialStorageEnabled;
     networkSessionParameters.ignoreTLSErrors = m_ignoreTLSErrors;
     networkSessionParameters.proxySettings = m_networkProxySettings;
+    networkSessionParameters.segmentedDownloadsEnabled = m_configuration->segmentedDownloadsEnabled();
+    networkSessionParameters.webSocketDeflateEnabled = m_configuration->webSocketDeflateEnabled();
+    networkSessionParameters.webSocketDeflateClientMaxWindowBits = m_configuration->webSocketDeflateClientMaxWindowBits();
+    networkSessionParameters.webSocketDeflateServerMaxWindowBits = m_configuration->webSocketDeflateServerMaxWindowBits();
+    networkSessionParameters.webSocketDeflateClientNoContextTakeover = m_configuration->webSocketDeflateClientNoContextTakeover();
+    networkSessionParameters.webSocketDeflateServerNoContextTakeover = m_configuration->webSocketDeflateServerNoContextTakeover();
 
     networkProcess().cookieManager().getCookiePersistentStorage(m_sessionID, networkSessionParameters.cookiePersistentStoragePath, networkSessionParameters.cookiePersistentStorageType);
 }
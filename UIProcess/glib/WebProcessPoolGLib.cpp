@@ -34,6 +34,10 @@
 #include <WebCore/PlatformDisplay.h>
 #include <wtf/FileSystem.h>
 
+#if OS(LINUX)
+#include "ForkServerLauncher.h"
+#endif
+
 #if USE(GSTREAMER)
 #include <WebCore/GStreamerCommon.h>
 #endif
@@ -68,6 +72,11 @@ void WebProcessPool::platformInitialize()
 
     if (!memoryPressureMonitorDisabled())
         installMemoryPressureHandler();
+
+#if OS(LINUX)
+    // Web processes are only launched from the fork server once it's ready, start it before they are needed.
+    startWebProcessForkServer();
+#endif
 }
 
 void WebProcessPool::platformInitializeWebProcess(const WebProcessProxy& process, WebProcessCreationParameters& parameters)
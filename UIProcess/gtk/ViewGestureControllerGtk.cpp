@@ -321,6 +321,17 @@ static int elementWidth(GtkStyleContext* context)
     return width;
 }
 
+void ViewGestureController::loadSpilledSnapshotForSwipe(SwipeDirection direction)
+{
+    auto& backForwardList = m_webPageProxy.backForwardList();
+    auto* targetItem = direction == SwipeDirection::Back ? backForwardList.backItem() : backForwardList.forwardItem();
+    if (!targetItem)
+        return;
+
+    if (auto* snapshot = targetItem->snapshot())
+        snapshot->loadSpilledImage();
+}
+
 void ViewGestureController::beginSwipeGesture(WebBackForwardListItem* targetItem, SwipeDirection direction)
 {
     ASSERT(targetItem);
@@ -27,10 +27,126 @@
 #include "ViewSnapshotStore.h"
 
 #include <WebCore/CairoUtilities.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <glib.h>
+#include <unistd.h>
+#include <wtf/RunLoop.h>
+#include <wtf/UniStdExtras.h>
+#include <wtf/glib/GUniquePtr.h>
 
 namespace WebKit {
 using namespace WebCore;
 
+static int createSpillFile()
+{
+    // Snapshots show page contents. They are written to files without a name, so no other process can open them
+    // and nothing is left on disk once the process exits, however it exits.
+    GUniquePtr<char> directory(g_build_filename(g_get_user_cache_dir(), "webkitgtk", nullptr));
+    if (g_mkdir_with_parents(directory.get(), 0700) == -1)
+        return -1;
+
+#if defined(O_TMPFILE)
+    int fileDescriptor = open(directory.get(), O_TMPFILE | O_RDWR | O_CLOEXEC, 0600);
+    if (fileDescriptor != -1)
+        return fileDescriptor;
+#endif
+
+    // The file system doesn't support O_TMPFILE, unlink the file right after creating it.
+    GUniquePtr<char> path(g_build_filename(directory.get(), "WebKitViewSnapshot-XXXXXX", nullptr));
+    int temporaryFileDescriptor = g_mkstemp_full(path.get(), O_RDWR | O_CLOEXEC, 0600);
+    if (temporaryFileDescriptor != -1)
+        unlink(path.get());
+    return temporaryFileDescriptor;
+}
+
+static cairo_status_t writeToSpillFile(void* closure, const unsigned char* data, unsigned length)
+{
+    int fileDescriptor = *static_cast<int*>(closure);
+    while (length) {
+        ssize_t bytesWritten = write(fileDescriptor, data, length);
+        if (bytesWritten == -1) {
+            if (errno == EINTR)
+                continue;
+            return CAIRO_STATUS_WRITE_ERROR;
+        }
+        data += bytesWritten;
+        length -= bytesWritten;
+    }
+    return CAIRO_STATUS_SUCCESS;
+}
+
+static cairo_status_t readFromSpillFile(void* closure, unsigned char* data, unsigned length)
+{
+    int fileDescriptor = *static_cast<int*>(closure);
+    while (length) {
+        ssize_t bytesRead = read(fileDescriptor, data, length);
+        if (bytesRead == -1) {
+            if (errno == EINTR)
+                continue;
+            return CAIRO_STATUS_READ_ERROR;
+        }
+        if (!bytesRead)
+            return CAIRO_STATUS_READ_ERROR;
+        data += bytesRead;
+        length -= bytesRead;
+    }
+    return CAIRO_STATUS_SUCCESS;
+}
+
+WorkQueue& ViewSnapshotStore::spillQueue()
+{
+    // A serial queue, so a reload or a delete of a spilled image always runs after the write that produced it.
+    if (!m_spillQueue)
+        m_spillQueue = WorkQueue::create("com.apple.WebKit.ViewSnapshotStore.Spill", WorkQueue::Type::Serial, WorkQueue::QOS::Utility);
+    return *m_spillQueue;
+}
+
+void ViewSnapshotStore::writeSpilledImage(uint64_t identifier, cairo_surface_t* surface)
+{
+    ASSERT(!RunLoop::isMain());
+
+    int fileDescriptor = createSpillFile();
+    if (fileDescriptor == -1)
+        return;
+
+    if (cairo_surface_write_to_png_stream(surface, writeToSpillFile, &fileDescriptor) != CAIRO_STATUS_SUCCESS) {
+        closeWithRetry(fileDescriptor);
+        return;
+    }
+    m_spillFiles.add(identifier, fileDescriptor);
+}
+
+RefPtr<cairo_surface_t> ViewSnapshotStore::readSpilledImage(uint64_t identifier)
+{
+    ASSERT(!RunLoop::isMain());
+
+    auto it = m_spillFiles.find(identifier);
+    if (it == m_spillFiles.end())
+        return nullptr;
+
+    int fileDescriptor = it->value;
+    if (lseek(fileDescriptor, 0, SEEK_SET) == -1)
+        return nullptr;
+
+    auto surface = adoptRef(cairo_image_surface_create_from_png_stream(readFromSpillFile, &fileDescriptor));
+    if (cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS)
+        return nullptr;
+    return surface;
+}
+
+void ViewSnapshotStore::removeSpilledImage(uint64_t identifier)
+{
+    ASSERT(!RunLoop::isMain());
+
+    auto it = m_spillFiles.find(identifier);
+    if (it == m_spillFiles.end())
+        return;
+
+    closeWithRetry(it->value);
+    m_spillFiles.remove(it);
+}
+
 Ref<ViewSnapshot> ViewSnapshot::create(RefPtr<cairo_surface_t>&& surface)
 {
     return adoptRef(*new ViewSnapshot(WTFMove(surface)));
@@ -58,6 +174,74 @@ void ViewSnapshot::clearImage()
     m_surface = nullptr;
 }
 
+void ViewSnapshot::spillImage()
+{
+    if (!hasImage())
+        return;
+
+    if (!m_canSpillImage) {
+        clearImage();
+        return;
+    }
+
+    auto& store = ViewSnapshotStore::singleton();
+    store.willRemoveImageFromSnapshot(*this);
+
+    // Snapshot images never change once taken, so a previous spill can be reused as is.
+    if (hasSpilledImage()) {
+        m_surface = nullptr;
+        return;
+    }
+
+    m_spilledImageIdentifier = store.nextSpillIdentifier();
+    store.spillQueue().dispatch([&store, surface = WTFMove(m_surface), identifier = m_spilledImageIdentifier] {
+        store.writeSpilledImage(identifier, surface.get());
+    });
+}
+
+void ViewSnapshot::loadSpilledImage()
+{
+    if (hasImage() || !hasSpilledImage() || m_isLoadingSpilledImage)
+        return;
+
+    m_isLoadingSpilledImage = true;
+    auto& store = ViewSnapshotStore::singleton();
+    store.spillQueue().dispatch([&store, weakThis = makeWeakPtr(*this), identifier = m_spilledImageIdentifier]() mutable {
+        auto surface = store.readSpilledImage(identifier);
+        RunLoop::main().dispatch([weakThis = WTFMove(weakThis), surface = WTFMove(surface)]() mutable {
+            if (weakThis)
+                weakThis->didLoadSpilledImage(WTFMove(surface));
+        });
+    });
+}
+
+void ViewSnapshot::didLoadSpilledImage(RefPtr<cairo_surface_t>&& surface)
+{
+    m_isLoadingSpilledImage = false;
+
+    if (!surface) {
+        discardSpilledImage();
+        return;
+    }
+
+    if (hasImage())
+        return;
+
+    m_surface = WTFMove(surface);
+    ViewSnapshotStore::singleton().didAddImageToSnapshot(*this);
+}
+
+void ViewSnapshot::discardSpilledImage()
+{
+    if (!hasSpilledImage())
+        return;
+
+    auto& store = ViewSnapshotStore::singleton();
+    store.spillQueue().dispatch([&store, identifier = std::exchange(m_spilledImageIdentifier, 0)] {
+        store.removeSpilledImage(identifier);
+    });
+}
+
 size_t ViewSnapshot::imageSizeInBytes() const
 {
     if (!m_surface)
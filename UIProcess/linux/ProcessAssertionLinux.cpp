@@ -0,0 +1,323 @@
+/*
+ * Copyright (C) 2020 Igalia S.L.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. AND ITS CONTRIBUTORS ``AS IS''
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ * THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL APPLE INC. OR ITS CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "config.h"
+#include "ProcessAssertion.h"
+
+#if OS(LINUX)
+
+#include "Logging.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <wtf/FileSystem.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/ProcessID.h>
+#include <wtf/RunLoop.h>
+#include <wtf/UniStdExtras.h>
+#include <wtf/text/CString.h>
+#include <wtf/text/StringConcatenateNumbers.h>
+
+namespace WebKit {
+
+// Every throttled process is moved to a cgroup v2 of its own, named after the pids of the UI process and of the
+// throttled process, below a parent cgroup
+// that is either given with WEBKIT_PROCESS_THROTTLING_CGROUP or the one of the UI process. Processes are
+// only throttled when the cgroup can be frozen, which needs Linux 5.2. cpu.weight and cpu.max only exist
+// when the cpu controller is enabled for the children of the parent cgroup, which requires a delegated
+// cgroup without processes of its own.
+static const char* cgroupFileSystemPath = "/sys/fs/cgroup";
+static const char* processCgroupPrefix = "webkit-";
+
+// Background processes run at a fifth of the default weight and at most half of a CPU.
+static const char* backgroundCPUWeight = "20";
+static const char* backgroundCPUMax = "50000 100000";
+static const char* defaultCPUWeight = "100";
+static const char* defaultCPUMax = "max";
+
+enum class ThrottlingState : uint8_t {
+    Running,
+    Background,
+    Suspended,
+};
+
+static ThrottlingState throttlingStateForAssertionType(ProcessAssertionType type)
+{
+    switch (type) {
+    case ProcessAssertionType::Suspended:
+        return ThrottlingState::Suspended;
+    case ProcessAssertionType::Background:
+        return ThrottlingState::Background;
+    case ProcessAssertionType::UnboundedNetworking:
+    case ProcessAssertionType::Foreground:
+    case ProcessAssertionType::MediaPlayback:
+        break;
+    }
+    return ThrottlingState::Running;
+}
+
+struct ThrottledProcess {
+    Vector<ProcessAssertion*> assertions;
+    CString cgroupPath;
+    ThrottlingState state { ThrottlingState::Running };
+};
+
+static HashMap<ProcessID, ThrottledProcess>& throttledProcesses()
+{
+    static NeverDestroyed<HashMap<ProcessID, ThrottledProcess>> processes;
+    return processes;
+}
+
+static HashSet<ProcessID>& processesThatCanBeThrottled()
+{
+    static NeverDestroyed<HashSet<ProcessID>> processes;
+    return processes;
+}
+
+static bool writeCgroupFile(const CString& cgroupPath, const char* fileName, const char* value)
+{
+    CString filePath = makeString(cgroupPath.data(), '/', fileName).utf8();
+    int fd = open(filePath.data(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1)
+        return false;
+
+    size_t length = strlen(value);
+    ssize_t bytesWritten;
+    do {
+        bytesWritten = write(fd, value, length);
+    } while (bytesWritten == -1 && errno == EINTR);
+    closeWithRetry(fd);
+
+    return bytesWritten == static_cast<ssize_t>(length);
+}
+
+static CString cgroupPathOfUIProcess()
+{
+    FILE* file = fopen("/proc/self/cgroup", "re");
+    if (!file)
+        return { };
+
+    // The cgroup v2 hierarchy is the one with id 0 and no controllers: "0::/path".
+    CString path;
+    char* line = nullptr;
+    size_t lineSize = 0;
+    while (getline(&line, &lineSize, file) != -1) {
+        if (strncmp(line, "0::", 3))
+            continue;
+        line[strcspn(line, "\n")] = '\0';
+        path = makeString(cgroupFileSystemPath, line + 3).utf8();
+        break;
+    }
+    free(line);
+    fclose(file);
+    return path;
+}
+
+static bool isStaleProcessCgroup(const String& cgroupPath)
+{
+    // The name is the prefix followed by "<UI process pid>-<throttled process pid>".
+    auto name = FileSystem::pathGetFileName(cgroupPath);
+    auto separator = name.find('-', strlen(processCgroupPrefix));
+    if (separator == notFound)
+        return false;
+
+    bool ok;
+    auto ownerPID = name.substring(strlen(processCgroupPrefix), separator - strlen(processCgroupPrefix)).toIntStrict(&ok);
+    if (!ok || ownerPID <= 0 || ownerPID == getpid())
+        return false;
+
+    // The cgroup belongs to another UI process using the same parent cgroup while that process is alive.
+    return kill(ownerPID, 0) == -1 && errno == ESRCH;
+}
+
+static const CString& parentCgroupPath()
+{
+    static NeverDestroyed<CString> path = [] {
+        CString path;
+        if (const char* parentCgroup = getenv("WEBKIT_PROCESS_THROTTLING_CGROUP"))
+            path = parentCgroup;
+        else
+            path = cgroupPathOfUIProcess();
+
+        // Remove the cgroups left behind by UI processes that are gone. Their processes are thawed first, so they
+        // can notice the UI process is gone and exit. Cgroups that still have processes can't be removed yet.
+        if (!path.isNull()) {
+            for (auto& cgroupPath : FileSystem::listDirectory(FileSystem::stringFromFileSystemRepresentation(path.data()), makeString(processCgroupPrefix, '*'))) {
+                if (!isStaleProcessCgroup(cgroupPath))
+                    continue;
+                auto cgroupPathData = FileSystem::fileSystemRepresentation(cgroupPath);
+                writeCgroupFile(cgroupPathData, "cgroup.freeze", "0");
+                rmdir(cgroupPathData.data());
+            }
+        }
+        return path;
+    }();
+    return path;
+}
+
+static CString createCgroupForProcess(ProcessID pid)
+{
+    auto& parentPath = parentCgroupPath();
+    if (parentPath.isNull())
+        return { };
+
+    CString path = makeString(parentPath.data(), '/', processCgroupPrefix, getpid(), '-', pid).utf8();
+    if (mkdir(path.data(), 0755) == -1 && errno != EEXIST) {
+        RELEASE_LOG_ERROR(ProcessSuspension, "Unable to create cgroup %s for process %d: %s", path.data(), pid, strerror(errno));
+        return { };
+    }
+
+    if (access(makeString(path.data(), "/cgroup.freeze").utf8().data(), W_OK) == -1) {
+        RELEASE_LOG_ERROR(ProcessSuspension, "Not throttling process %d because cgroup %s can't be frozen", pid, path.data());
+        rmdir(path.data());
+        return { };
+    }
+
+    if (!writeCgroupFile(path, "cgroup.procs", String::number(pid).utf8().data())) {
+        RELEASE_LOG_ERROR(ProcessSuspension, "Unable to move process %d to cgroup %s: %s", pid, path.data(), strerror(errno));
+        rmdir(path.data());
+        return { };
+    }
+
+    return path;
+}
+
+static void setThrottlingState(ProcessID pid, ThrottledProcess& process, ThrottlingState state)
+{
+    // Processes without a cgroup are never throttled.
+    if (process.cgroupPath.isNull())
+        return;
+
+    auto previousState = std::exchange(process.state, state);
+    if (previousState == state)
+        return;
+
+    RELEASE_LOG(ProcessSuspension, "Changing throttling state of process %d from %u to %u", pid, static_cast<unsigned>(previousState), static_cast<unsigned>(state));
+
+    // These fail when the cpu controller is not available, leaving the process unthrottled.
+    bool isBackground = state == ThrottlingState::Background;
+    writeCgroupFile(process.cgroupPath, "cpu.weight", isBackground ? backgroundCPUWeight : defaultCPUWeight);
+    writeCgroupFile(process.cgroupPath, "cpu.max", isBackground ? backgroundCPUMax : defaultCPUMax);
+
+    if (state == ThrottlingState::Suspended)
+        writeCgroupFile(process.cgroupPath, "cgroup.freeze", "1");
+    else if (previousState == ThrottlingState::Suspended)
+        writeCgroupFile(process.cgroupPath, "cgroup.freeze", "0");
+}
+
+static void updateThrottlingState(ProcessID pid, ThrottledProcess& process)
+{
+    // A process is throttled according to the least restrictive of its assertions.
+    auto state = ThrottlingState::Suspended;
+    for (auto* assertion : process.assertions)
+        state = std::min(state, throttlingStateForAssertionType(assertion->type()));
+    setThrottlingState(pid, process, state);
+}
+
+bool ProcessAssertion::isProcessThrottlingEnabled()
+{
+    static bool isEnabled = [] {
+        const char* enableProcessThrottling = getenv("WEBKIT_ENABLE_PROCESS_THROTTLING");
+        return enableProcessThrottling && !strcmp(enableProcessThrottling, "1");
+    }();
+    return isEnabled;
+}
+
+void ProcessAssertion::setProcessCanBeThrottled(ProcessID pid, bool canBeThrottled)
+{
+    if (!pid || !isProcessThrottlingEnabled())
+        return;
+
+    ASSERT(pid != getCurrentProcessID());
+    if (canBeThrottled)
+        processesThatCanBeThrottled().add(pid);
+    else
+        processesThatCanBeThrottled().remove(pid);
+}
+
+ProcessAssertion::ProcessAssertion(ProcessID pid, const String&, ProcessAssertionType assertionType)
+    : m_assertionType(assertionType)
+    , m_pid(pid)
+{
+    // Assertions are also taken on the UI process and on the auxiliary processes, which must keep running.
+    if (!m_pid || !isProcessThrottlingEnabled() || m_pid == getCurrentProcessID() || !processesThatCanBeThrottled().contains(m_pid))
+        return;
+
+    auto addResult = throttledProcesses().add(m_pid, ThrottledProcess { });
+    auto& process = addResult.iterator->value;
+    if (addResult.isNewEntry)
+        process.cgroupPath = createCgroupForProcess(m_pid);
+    process.assertions.append(this);
+    updateThrottlingState(m_pid, process);
+}
+
+ProcessAssertion::~ProcessAssertion()
+{
+    if (!m_pid || !isProcessThrottlingEnabled())
+        return;
+
+    auto iterator = throttledProcesses().find(m_pid);
+    if (iterator == throttledProcesses().end())
+        return;
+
+    auto& process = iterator->value;
+    process.assertions.removeFirst(this);
+    if (!process.assertions.isEmpty()) {
+        updateThrottlingState(m_pid, process);
+        return;
+    }
+
+    // The process is most likely exiting, but it must not stay throttled if it isn't.
+    setThrottlingState(m_pid, process, ThrottlingState::Running);
+    if (!process.cgroupPath.isNull()) {
+        // A cgroup can only be removed once the process has exited.
+        RunLoop::main().dispatchAfter(1_s, [cgroupPath = WTFMove(process.cgroupPath)] {
+            rmdir(cgroupPath.data());
+        });
+    }
+    throttledProcesses().remove(iterator);
+}
+
+bool ProcessAssertion::isValid() const
+{
+    return true;
+}
+
+ProcessAndUIAssertion::ProcessAndUIAssertion(ProcessID pid, const String& reason, ProcessAssertionType assertionType)
+    : ProcessAssertion(pid, reason, assertionType)
+{
+}
+
+ProcessAndUIAssertion::~ProcessAndUIAssertion() = default;
+
+} // namespace WebKit
+
+#endif // OS(LINUX)
@@ -38,6 +38,8 @@
 #include <WebCore/PlatformTimeRanges.h>
 #include <WebCore/SourceBufferPrivateClient.h>
 #include <wtf/Ref.h>
+#include <wtf/MathExtras.h>
+#include <wtf/StdLibExtras.h>
 
 namespace WebCore {
 #if !RELEASE_LOG_DISABLED
@@ -49,6 +51,11 @@ namespace WebKit {
 
 using namespace WebCore;
 
+// Segments smaller than this are cheap enough to copy through the IPC encoder.
+static constexpr size_t minimumSharedMemoryAppendSize = 64 * KB;
+// Segments larger than this fall back to the IPC path rather than pinning a huge mapping in both processes.
+static constexpr size_t maximumSharedMemoryAppendSize = 32 * MB;
+
 Ref<SourceBufferPrivateRemote> SourceBufferPrivateRemote::create(GPUProcessConnection& gpuProcessConnection, RemoteSourceBufferIdentifier remoteSourceBufferIdentifier, const MediaSourcePrivateRemote& mediaSourcePrivate, const MediaPlayerPrivateRemote& mediaPlayerPrivate)
 {
     return adoptRef(*new SourceBufferPrivateRemote(gpuProcessConnection, remoteSourceBufferIdentifier, mediaSourcePrivate, mediaPlayerPrivate));
@@ -78,9 +85,45 @@ SourceBufferPrivateRemote::~SourceBufferPrivateRemote()
 
 void SourceBufferPrivateRemote::append(Vector<unsigned char>&& data)
 {
+    if (appendUsingSharedMemory(data))
+        return;
+
     m_gpuProcessConnection.connection().send(Messages::RemoteSourceBufferProxy::Append(IPC::DataReference(data)), m_remoteSourceBufferIdentifier);
 }
 
+bool SourceBufferPrivateRemote::appendUsingSharedMemory(const Vector<unsigned char>& data)
+{
+    if (data.size() < minimumSharedMemoryAppendSize || data.size() > maximumSharedMemoryAppendSize)
+        return false;
+
+    // The GPU process replies once it has copied the previous segment out, so only one append may use the buffer at a time.
+    if (m_isAppendSharedMemoryInUse)
+        return false;
+
+    if (!m_appendSharedMemory || m_appendSharedMemory->size() < data.size()) {
+        auto sharedMemory = SharedMemory::allocate(roundUpToPowerOfTwo(static_cast<uint32_t>(data.size())));
+        if (!sharedMemory)
+            return false;
+
+        SharedMemory::Handle handle;
+        if (!sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly))
+            return false;
+
+        m_appendSharedMemory = WTFMove(sharedMemory);
+        m_gpuProcessConnection.connection().send(Messages::RemoteSourceBufferProxy::SetAppendSharedMemory(SharedMemory::IPCHandle { WTFMove(handle), m_appendSharedMemory->size() }), m_remoteSourceBufferIdentifier);
+    }
+
+    memcpy(m_appendSharedMemory->data(), data.data(), data.size());
+
+    m_isAppendSharedMemoryInUse = true;
+    m_gpuProcessConnection.connection().sendWithAsyncReply(Messages::RemoteSourceBufferProxy::AppendFromSharedMemory(data.size()), [weakThis = makeWeakPtr(this)] {
+        if (weakThis)
+            weakThis->m_isAppendSharedMemoryInUse = false;
+    }, m_remoteSourceBufferIdentifier);
+
+    return true;
+}
+
 void SourceBufferPrivateRemote::abort()
 {
     m_gpuProcessConnection.connection().send(Messages::RemoteSourceBufferProxy::Abort(), m_remoteSourceBufferIdentifier);
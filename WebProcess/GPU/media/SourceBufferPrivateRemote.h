@@ -30,6 +30,7 @@
 #include "GPUProcessConnection.h"
 #include "MessageReceiver.h"
 #include "RemoteSourceBufferIdentifier.h"
+#include "SharedMemory.h"
 #include "TrackPrivateRemoteIdentifier.h"
 #include <WebCore/ContentType.h>
 #include <WebCore/MediaSample.h>
@@ -103,6 +104,8 @@ private:
 
     bool isActive() const final { return m_isActive; }
 
+    bool appendUsingSharedMemory(const Vector<unsigned char>&);
+
     // Internals Utility methods
     void bufferedSamplesForTrackId(const AtomString&, CompletionHandler<void(Vector<String>&&)>&&) final;
 
@@ -129,6 +132,9 @@ private:
 
     bool m_isActive { false };
 
+    RefPtr<SharedMemory> m_appendSharedMemory;
+    bool m_isAppendSharedMemoryInUse { false };
+
 #if !RELEASE_LOG_DISABLED
     const Logger& logger() const final { return m_logger.get(); }
     const char* logClassName() const override { return "SourceBufferPrivateRemote"; }
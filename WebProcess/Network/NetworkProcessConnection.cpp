@@ -247,7 +247,7 @@ void NetworkProcessConnection::cookieAcceptPolicyChanged(HTTPCookieAcceptPolicy
     m_cookieAcceptPolicy = newPolicy;
 }
 
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
 void NetworkProcessConnection::cookiesAdded(const String& host, const Vector<WebCore::Cookie>& cookies)
 {
     WebProcess::singleton().cookieJar().cookiesAdded(host, cookies);
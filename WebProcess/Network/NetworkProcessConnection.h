@@ -82,7 +82,7 @@ public:
     WebCore::HTTPCookieAcceptPolicy cookieAcceptPolicy() const { return m_cookieAcceptPolicy; }
     bool cookiesEnabled() const;
 
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
     void cookiesAdded(const String& host, const Vector<WebCore::Cookie>&);
     void cookiesDeleted(const String& host, const Vector<WebCore::Cookie>&);
     void allCookiesDeleted();
@@ -802,11 +802,48 @@ void WebLoaderStrategy::setOnLineState(bool isOnLine)
 
 void WebLoaderStrategy::setCaptureExtraNetworkLoadMetricsEnabled(bool enabled)
 {
+    if (!enabled) {
+        m_networkLoadInformation.clear();
+        m_networkLoadInformationIdentifiers.clear();
+    }
     WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::SetCaptureExtraNetworkLoadMetricsEnabled(enabled), 0);
 }
 
+NetworkLoadInformation& WebLoaderStrategy::ensureNetworkLoadInformation(ResourceLoadIdentifier identifier)
+{
+    static const unsigned maximumNetworkLoadInformationCount = 256;
+
+    auto addResult = m_networkLoadInformation.add(identifier, NetworkLoadInformation { });
+    if (addResult.isNewEntry) {
+        m_networkLoadInformationIdentifiers.add(identifier);
+        // The information is normally taken as soon as the load finishes, so only loads the inspector lost track of are dropped here.
+        if (m_networkLoadInformationIdentifiers.size() > maximumNetworkLoadInformationCount) {
+            m_networkLoadInformation.remove(m_networkLoadInformationIdentifiers.first());
+            m_networkLoadInformationIdentifiers.removeFirst();
+            return m_networkLoadInformation.find(identifier)->value;
+        }
+    }
+    return addResult.iterator->value;
+}
+
+void WebLoaderStrategy::addNetworkLoadInformation(ResourceLoadIdentifier identifier, ResourceResponse&& response, Vector<NetworkTransactionInformation>&& transactions)
+{
+    auto& information = ensureNetworkLoadInformation(identifier);
+    information.response = WTFMove(response);
+    information.transactions = WTFMove(transactions);
+}
+
+void WebLoaderStrategy::addNetworkLoadInformationMetrics(ResourceLoadIdentifier identifier, const NetworkLoadMetrics& metrics)
+{
+    ensureNetworkLoadInformation(identifier).metrics = metrics;
+}
+
 ResourceResponse WebLoaderStrategy::responseFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
+    auto iterator = m_networkLoadInformation.find(resourceLoadIdentifier);
+    if (iterator != m_networkLoadInformation.end())
+        return iterator->value.response;
+
     ResourceResponse response;
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::GetNetworkLoadInformationResponse { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::GetNetworkLoadInformationResponse::Reply { response }, 0);
     return response;
@@ -814,6 +851,10 @@ ResourceResponse WebLoaderStrategy::responseFromResourceLoadIdentifier(uint64_t
 
 Vector<NetworkTransactionInformation> WebLoaderStrategy::intermediateLoadInformationFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
+    auto iterator = m_networkLoadInformation.find(resourceLoadIdentifier);
+    if (iterator != m_networkLoadInformation.end())
+        return iterator->value.transactions;
+
     Vector<NetworkTransactionInformation> information;
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::GetNetworkLoadIntermediateInformation { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::GetNetworkLoadIntermediateInformation::Reply { information }, 0);
     return information;
@@ -821,6 +862,12 @@ Vector<NetworkTransactionInformation> WebLoaderStrategy::intermediateLoadInforma
 
 NetworkLoadMetrics WebLoaderStrategy::networkMetricsFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier)
 {
+    if (m_networkLoadInformation.contains(resourceLoadIdentifier)) {
+        auto metrics = m_networkLoadInformation.take(resourceLoadIdentifier).metrics;
+        m_networkLoadInformationIdentifiers.remove(resourceLoadIdentifier);
+        return metrics;
+    }
+
     NetworkLoadMetrics networkMetrics;
     WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::TakeNetworkLoadInformationMetrics { resourceLoadIdentifier }, Messages::NetworkConnectionToWebProcess::TakeNetworkLoadInformationMetrics::Reply { networkMetrics }, 0);
     return networkMetrics;
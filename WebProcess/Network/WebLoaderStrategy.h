@@ -27,10 +27,12 @@
 
 #include "WebResourceLoader.h"
 #include <WebCore/LoaderStrategy.h>
+#include <WebCore/NetworkLoadInformation.h>
 #include <WebCore/ResourceError.h>
 #include <WebCore/ResourceLoader.h>
 #include <WebCore/ResourceResponse.h>
 #include <wtf/HashSet.h>
+#include <wtf/ListHashSet.h>
 #include <wtf/RunLoop.h>
 
 namespace WebCore {
@@ -74,6 +76,9 @@ public:
     void didFinishPreconnection(uint64_t preconnectionIdentifier, WebCore::ResourceError&&);
 
     void setCaptureExtraNetworkLoadMetricsEnabled(bool) final;
+    void addNetworkLoadInformation(ResourceLoadIdentifier, WebCore::ResourceResponse&&, Vector<WebCore::NetworkTransactionInformation>&&);
+    void addNetworkLoadInformationMetrics(ResourceLoadIdentifier, const WebCore::NetworkLoadMetrics&);
+    void removeNetworkLoadInformation(ResourceLoadIdentifier identifier) { m_networkLoadInformation.remove(identifier); m_networkLoadInformationIdentifiers.remove(identifier); }
 
     WebResourceLoader* webResourceLoaderForIdentifier(ResourceLoadIdentifier identifier) const { return m_webResourceLoaders.get(identifier); }
     void schedulePluginStreamLoad(WebCore::Frame&, WebCore::NetscapePlugInStreamLoaderClient&, WebCore::ResourceRequest&&, CompletionHandler<void(RefPtr<WebCore::NetscapePlugInStreamLoader>&&)>&&);
@@ -109,6 +114,8 @@ private:
     Vector<WebCore::NetworkTransactionInformation> intermediateLoadInformationFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier) final;
     WebCore::NetworkLoadMetrics networkMetricsFromResourceLoadIdentifier(uint64_t resourceLoadIdentifier) final;
 
+    WebCore::NetworkLoadInformation& ensureNetworkLoadInformation(ResourceLoadIdentifier);
+
     bool shouldPerformSecurityChecks() const final;
     bool havePerformedSecurityChecks(const WebCore::ResourceResponse&) const final;
 
@@ -129,6 +136,10 @@ private:
     HashMap<unsigned long, PingLoadCompletionHandler> m_pingLoadCompletionHandlers;
     HashMap<unsigned long, PreconnectCompletionHandler> m_preconnectCompletionHandlers;
     Vector<Function<void(bool)>> m_onlineStateChangeListeners;
+    // Load information pushed by the network process when extra network load metrics are captured,
+    // oldest first. Loads that are not found here are looked up in the network process.
+    HashMap<ResourceLoadIdentifier, WebCore::NetworkLoadInformation> m_networkLoadInformation;
+    ListHashSet<ResourceLoadIdentifier> m_networkLoadInformationIdentifiers;
     bool m_isOnLine { true };
 };
 
@@ -47,6 +47,7 @@
 #include <WebCore/FrameLoader.h>
 #include <WebCore/FrameLoaderClient.h>
 #include <WebCore/InspectorInstrumentationWebKit.h>
+#include <WebCore/NetworkLoadInformation.h>
 #include <WebCore/NetworkLoadMetrics.h>
 #include <WebCore/Page.h>
 #include <WebCore/ResourceError.h>
@@ -210,6 +211,18 @@ void WebResourceLoader::didReceiveData(const IPC::DataReference& data, int64_t e
     m_coreLoader->didReceiveData(reinterpret_cast<const char*>(data.data()), data.size(), encodedDataLength, DataPayloadBytes);
 }
 
+void WebResourceLoader::didReceiveSharedMemoryData(const SharedMemory::IPCHandle& ipcHandle, int64_t encodedDataLength)
+{
+    auto sharedMemory = SharedMemory::map(ipcHandle.handle, SharedMemory::Protection::ReadOnly);
+    if (!sharedMemory || ipcHandle.dataSize > sharedMemory->size()) {
+        RELEASE_LOG_IF_ALLOWED("didReceiveSharedMemoryData: Unable to map shared memory");
+        m_coreLoader->didFail(internalError(m_coreLoader->request().url()));
+        return;
+    }
+
+    didReceiveData({ static_cast<const uint8_t*>(sharedMemory->data()), static_cast<size_t>(ipcHandle.dataSize) }, encodedDataLength);
+}
+
 void WebResourceLoader::didFinishResourceLoad(const NetworkLoadMetrics& networkLoadMetrics)
 {
     LOG(Network, "(WebProcess) WebResourceLoader::didFinishResourceLoad for '%s'", m_coreLoader->url().string().latin1().data());
@@ -227,6 +240,16 @@ void WebResourceLoader::didFinishResourceLoad(const NetworkLoadMetrics& networkL
     m_coreLoader->didFinishLoading(networkLoadMetrics);
 }
 
+void WebResourceLoader::didReceiveNetworkLoadInformation(ResourceResponse&& response, Vector<NetworkTransactionInformation>&& transactions)
+{
+    WebProcess::singleton().webLoaderStrategy().addNetworkLoadInformation(m_coreLoader->identifier(), WTFMove(response), WTFMove(transactions));
+}
+
+void WebResourceLoader::didReceiveNetworkLoadInformationMetrics(const NetworkLoadMetrics& networkLoadMetrics)
+{
+    WebProcess::singleton().webLoaderStrategy().addNetworkLoadInformationMetrics(m_coreLoader->identifier(), networkLoadMetrics);
+}
+
 void WebResourceLoader::didFailServiceWorkerLoad(const ResourceError& error)
 {
     if (auto* document = m_coreLoader->frame() ? m_coreLoader->frame()->document() : nullptr) {
@@ -266,6 +289,8 @@ void WebResourceLoader::didFailResourceLoad(const ResourceError& error)
         return;
     }
 
+    WebProcess::singleton().webLoaderStrategy().removeNetworkLoadInformation(m_coreLoader->identifier());
+
     ASSERT_WITH_MESSAGE(!m_isProcessingNetworkResponse, "Load should not be able to finish before we've validated the response");
 
     if (m_coreLoader->documentLoader()->applicationCacheHost().maybeLoadFallbackForError(m_coreLoader.get(), error))
@@ -29,6 +29,7 @@
 #include "DataReference.h"
 #include "MessageSender.h"
 #include "ShareableResource.h"
+#include "SharedMemory.h"
 #include "WebPageProxyIdentifier.h"
 #include "WebResourceInterceptController.h"
 #include <WebCore/FrameIdentifier.h>
@@ -46,6 +47,7 @@ class ResourceError;
 class ResourceLoader;
 class ResourceRequest;
 class ResourceResponse;
+struct NetworkTransactionInformation;
 }
 
 namespace WebKit {
@@ -84,7 +86,10 @@ private:
     void didSendData(uint64_t bytesSent, uint64_t totalBytesToBeSent);
     void didReceiveResponse(const WebCore::ResourceResponse&, bool needsContinueDidReceiveResponseMessage);
     void didReceiveData(const IPC::DataReference&, int64_t encodedDataLength);
+    void didReceiveSharedMemoryData(const SharedMemory::IPCHandle&, int64_t encodedDataLength);
     void didFinishResourceLoad(const WebCore::NetworkLoadMetrics&);
+    void didReceiveNetworkLoadInformation(WebCore::ResourceResponse&&, Vector<WebCore::NetworkTransactionInformation>&&);
+    void didReceiveNetworkLoadInformationMetrics(const WebCore::NetworkLoadMetrics&);
     void didFailResourceLoad(const WebCore::ResourceError&);
     void didFailServiceWorkerLoad(const WebCore::ResourceError&);
     void serviceWorkerDidNotHandle();
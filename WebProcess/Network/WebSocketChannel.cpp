@@ -38,6 +38,7 @@
 #include <WebCore/WebSocketChannel.h>
 #include <WebCore/WebSocketChannelClient.h>
 #include <wtf/CheckedArithmetic.h>
+#include <wtf/RunLoop.h>
 
 namespace WebKit {
 using namespace WebCore;
@@ -57,10 +58,10 @@ NetworkSendQueue WebSocketChannel::createMessageQueue(Document& document, WebSoc
 {
     return { document, [&channel](auto& utf8String) {
         channel.notifySendFrame(WebSocketFrame::OpCode::OpCodeText, utf8String.data(), utf8String.length());
-        channel.sendMessage(Messages::NetworkSocketChannel::SendString { IPC::DataReference { reinterpret_cast<const uint8_t*>(utf8String.data()), utf8String.length() } }, utf8String.length());
+        channel.enqueueMessageToSend(WebSocketMessageBatch::Type::UTF8Text, reinterpret_cast<const uint8_t*>(utf8String.data()), utf8String.length());
     }, [&channel](const char* data, size_t byteLength) {
         channel.notifySendFrame(WebSocketFrame::OpCode::OpCodeBinary, data, byteLength);
-        channel.sendMessage(Messages::NetworkSocketChannel::SendData { IPC::DataReference { reinterpret_cast<const uint8_t*>(data), byteLength } }, byteLength);
+        channel.enqueueMessageToSend(WebSocketMessageBatch::Type::Binary, reinterpret_cast<const uint8_t*>(data), byteLength);
     }, [&channel](ExceptionCode exceptionCode) {
         auto code = static_cast<int>(exceptionCode);
         channel.fail(makeString("Failed to load Blob: exception code = ", code));
@@ -157,6 +158,44 @@ template<typename T> void WebSocketChannel::sendMessage(T&& message, size_t byte
     sendWithAsyncReply(WTFMove(message), WTFMove(completionHandler));
 }
 
+void WebSocketChannel::enqueueMessageToSend(WebSocketMessageBatch::Type type, const uint8_t* data, size_t length)
+{
+    if (length >= WebSocketMessageBatch::maximumSize) {
+        flushMessagesToSend();
+        if (type == WebSocketMessageBatch::Type::UTF8Text)
+            sendMessage(Messages::NetworkSocketChannel::SendString { IPC::DataReference { data, length } }, length);
+        else
+            sendMessage(Messages::NetworkSocketChannel::SendData { IPC::DataReference { data, length } }, length);
+        return;
+    }
+
+    m_messagesToSend.append(type, data, length);
+    if (m_messagesToSend.size() >= WebSocketMessageBatch::maximumSize) {
+        flushMessagesToSend();
+        return;
+    }
+
+    // Messages sent in the same run loop iteration are sent together.
+    if (m_isMessagesToSendFlushScheduled)
+        return;
+
+    m_isMessagesToSendFlushScheduled = true;
+    RunLoop::main().dispatch([this, protectedThis = makeRef(*this)] {
+        m_isMessagesToSendFlushScheduled = false;
+        flushMessagesToSend();
+    });
+}
+
+void WebSocketChannel::flushMessagesToSend()
+{
+    if (m_messagesToSend.isEmpty())
+        return;
+
+    auto byteLength = m_messagesToSend.payloadSize();
+    auto messages = m_messagesToSend.take();
+    sendMessage(Messages::NetworkSocketChannel::SendMessages { IPC::DataReference { messages } }, byteLength);
+}
+
 WebSocketChannel::SendResult WebSocketChannel::send(const String& message)
 {
     auto utf8 = message.utf8(StrictConversionReplacingUnpairedSurrogatesWithFFFD);
@@ -208,6 +247,7 @@ void WebSocketChannel::close(int code, const String& reason)
     WebSocketFrame closingFrame(WebSocketFrame::OpCodeClose, true, false, true);
     m_inspector.didSendWebSocketFrame(m_document.get(), closingFrame);
 
+    flushMessagesToSend();
     MessageSender::send(Messages::NetworkSocketChannel::Close { code, reason });
 }
 
@@ -223,6 +263,7 @@ void WebSocketChannel::fail(const String& reason)
     if (m_isClosing)
         return;
 
+    flushMessagesToSend();
     MessageSender::send(Messages::NetworkSocketChannel::Close { 0, reason });
     didClose(WebCore::WebSocketChannel::CloseEventCodeAbnormalClosure, { });
 }
@@ -234,6 +275,8 @@ void WebSocketChannel::disconnect()
     m_pendingTasks.clear();
     m_messageQueue.clear();
 
+    // Messages sent right before the page goes away (e.g. from pagehide or unload) must still go out before the close.
+    flushMessagesToSend();
 
     m_inspector.didCloseWebSocket(m_document.get());
 
@@ -319,6 +362,20 @@ void WebSocketChannel::didReceiveBinaryData(IPC::DataReference&& data)
     m_client->didReceiveBinaryData(data.vector());
 }
 
+void WebSocketChannel::didReceiveMessages(IPC::DataReference&& messages)
+{
+    // The client can close the channel, potentially removing the last reference.
+    auto protectedThis = makeRef(*this);
+
+    bool isValid = WebSocketMessageBatch::forEachMessage(messages, [this](auto type, auto* data, size_t length) {
+        if (type == WebSocketMessageBatch::Type::Binary)
+            didReceiveBinaryData({ data, length });
+        else
+            didReceiveText(WebSocketMessageBatch::text(type, data, length));
+    });
+    ASSERT_UNUSED(isValid, isValid);
+}
+
 void WebSocketChannel::didClose(unsigned short code, String&& reason)
 {
     if (!m_client)
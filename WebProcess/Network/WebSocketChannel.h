@@ -28,6 +28,7 @@
 #include "DataReference.h"
 #include "MessageReceiver.h"
 #include "MessageSender.h"
+#include "WebSocketMessageBatch.h"
 #include <WebCore/NetworkSendQueue.h>
 #include <WebCore/ResourceRequest.h>
 #include <WebCore/ResourceResponse.h>
@@ -83,6 +84,7 @@ private:
     void didConnect(String&& subprotocol, String&& extensions);
     void didReceiveText(String&&);
     void didReceiveBinaryData(IPC::DataReference&&);
+    void didReceiveMessages(IPC::DataReference&&);
     void didClose(unsigned short code, String&&);
     void didReceiveMessageError(String&&);
     void didSendHandshakeRequest(WebCore::ResourceRequest&&);
@@ -95,6 +97,8 @@ private:
     bool increaseBufferedAmount(size_t);
     void decreaseBufferedAmount(size_t);
     template<typename T> void sendMessage(T&&, size_t byteLength);
+    void enqueueMessageToSend(WebSocketMessageBatch::Type, const uint8_t* data, size_t length);
+    void flushMessagesToSend();
     void enqueueTask(Function<void()>&&);
 
     unsigned long progressIdentifier() const final { return m_inspector.progressIdentifier(); }
@@ -113,6 +117,8 @@ private:
     bool m_isSuspended { false };
     Deque<Function<void()>> m_pendingTasks;
     WebCore::NetworkSendQueue m_messageQueue;
+    WebSocketMessageBatch m_messagesToSend;
+    bool m_isMessagesToSendFlushScheduled { false };
     WebCore::WebSocketChannelInspector m_inspector;
     WebCore::ResourceRequest m_handshakeRequest;
     WebCore::ResourceResponse m_handshakeResponse;
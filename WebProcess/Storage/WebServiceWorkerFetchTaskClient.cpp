@@ -32,6 +32,7 @@
 #include "Logging.h"
 #include "ServiceWorkerFetchTaskMessages.h"
 #include "SharedBufferDataReference.h"
+#include "SharedMemory.h"
 #include "WebCoreArgumentCoders.h"
 #include "WebErrors.h"
 #include <WebCore/ResourceError.h>
@@ -42,6 +43,9 @@
 namespace WebKit {
 using namespace WebCore;
 
+// Larger chunks are handed over in shared memory so that the network process only forwards a handle instead of decoding and re-encoding the bytes.
+static constexpr size_t minimumSharedMemoryDataSize = 64 * KB;
+
 WebServiceWorkerFetchTaskClient::WebServiceWorkerFetchTaskClient(Ref<IPC::Connection>&& connection, WebCore::ServiceWorkerIdentifier serviceWorkerIdentifier, WebCore::SWServerConnectionIdentifier serverConnectionIdentifier, FetchIdentifier fetchIdentifier, bool needsContinueDidReceiveResponseMessage)
     : m_connection(WTFMove(connection))
     , m_serverConnectionIdentifier(serverConnectionIdentifier)
@@ -84,9 +88,36 @@ void WebServiceWorkerFetchTaskClient::didReceiveData(Ref<SharedBuffer>&& buffer)
         return;
     }
 
+    bool sentUsingSharedMemory = sendDataUsingSharedMemory(buffer->size(), [&buffer](char* destination) {
+        for (auto& segment : buffer.get()) {
+            memcpy(destination, segment.segment->data(), segment.segment->size());
+            destination += segment.segment->size();
+        }
+    });
+    if (sentUsingSharedMemory)
+        return;
+
     m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveData { buffer.get(), static_cast<int64_t>(buffer->size()) }, m_fetchIdentifier);
 }
 
+template<typename CopyFunction> bool WebServiceWorkerFetchTaskClient::sendDataUsingSharedMemory(size_t size, CopyFunction&& copyData)
+{
+    if (size < minimumSharedMemoryDataSize)
+        return false;
+
+    auto sharedMemory = SharedMemory::allocate(size);
+    if (!sharedMemory)
+        return false;
+
+    SharedMemory::Handle handle;
+    if (!sharedMemory->createHandle(handle, SharedMemory::Protection::ReadOnly))
+        return false;
+
+    copyData(static_cast<char*>(sharedMemory->data()));
+    m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveSharedMemoryData { SharedMemory::IPCHandle { WTFMove(handle), size }, static_cast<int64_t>(size) }, m_fetchIdentifier);
+    return true;
+}
+
 void WebServiceWorkerFetchTaskClient::didReceiveFormDataAndFinish(Ref<FormData>&& formData)
 {
     if (auto sharedBuffer = formData->asSharedBuffer()) {
@@ -135,6 +166,9 @@ void WebServiceWorkerFetchTaskClient::didReceiveBlobChunk(const char* data, size
     if (!m_connection)
         return;
 
+    if (sendDataUsingSharedMemory(size, [data, size](char* destination) { memcpy(destination, data, size); }))
+        return;
+
     m_connection->send(Messages::ServiceWorkerFetchTask::DidReceiveData { { reinterpret_cast<const uint8_t*>(data), size }, static_cast<int64_t>(size) }, m_fetchIdentifier);
 }
 
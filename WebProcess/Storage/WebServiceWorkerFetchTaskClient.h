@@ -58,6 +58,7 @@ private:
     void continueDidReceiveResponse() final;
 
     void cleanup();
+    template<typename CopyFunction> bool sendDataUsingSharedMemory(size_t, CopyFunction&&);
     
     void didReceiveBlobChunk(const char* data, size_t size);
     void didFinishBlobLoading();
@@ -47,6 +47,7 @@
 #include "WKBundleAPICast.h"
 #include "WebAutomationSessionProxy.h"
 #include "WebBackForwardListProxy.h"
+#include "WebCookieJar.h"
 #include "WebCoreArgumentCoders.h"
 #include "WebDocumentLoader.h"
 #include "WebErrors.h"
@@ -74,6 +75,7 @@
 #include <WebCore/FrameLoader.h>
 #include <WebCore/FrameView.h>
 #include <WebCore/HTMLFormElement.h>
+#include <WebCore/HTMLFrameElementBase.h>
 #include <WebCore/HistoryController.h>
 #include <WebCore/HistoryItem.h>
 #include <WebCore/MIMETypeRegistry.h>
@@ -1590,6 +1592,10 @@ RefPtr<Frame> WebFrameLoaderClient::createFrame(const String& name, HTMLFrameOwn
 {
     auto* webPage = m_frame->page();
 
+    // Script in the subframe is likely to read its cookies, fetch them while the frame loads.
+    if (is<HTMLFrameElementBase>(ownerElement))
+        WebProcess::singleton().cookieJar().prefetchCookiesForSubframe(m_frame, ownerElement.document().firstPartyForCookies(), downcast<HTMLFrameElementBase>(ownerElement).location());
+
     auto subframe = WebFrame::createSubframe(webPage, name, &ownerElement);
     auto* coreSubframe = subframe->coreFrame();
     if (!coreSubframe)
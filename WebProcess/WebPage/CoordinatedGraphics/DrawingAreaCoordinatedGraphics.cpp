@@ -226,6 +226,15 @@ void DrawingAreaCoordinatedGraphics::forceRepaintAsync(WebPage& page, Completion
         completionHandler();
 }
 
+#if USE(COORDINATED_GRAPHICS)
+String DrawingAreaCoordinatedGraphics::compositorFrameTimeline() const
+{
+    if (!m_layerTreeHost)
+        return { };
+    return m_layerTreeHost->compositorFrameTimeline();
+}
+#endif
+
 void DrawingAreaCoordinatedGraphics::setLayerTreeStateIsFrozen(bool isFrozen)
 {
     if (m_layerTreeStateIsFrozen == isFrozen)
@@ -73,6 +73,7 @@ private:
 
 #if USE(COORDINATED_GRAPHICS)
     void layerHostDidFlushLayers() override;
+    String compositorFrameTimeline() const override;
 #endif
     
     RefPtr<WebCore::DisplayRefreshMonitor> createDisplayRefreshMonitor(WebCore::PlatformDisplayID) override;
@@ -190,6 +190,11 @@ void LayerTreeHost::forceRepaint()
     m_compositor->forceRepaint();
 }
 
+String LayerTreeHost::compositorFrameTimeline() const
+{
+    return m_compositor->frameTimeline().toTraceEventJSON();
+}
+
 void LayerTreeHost::forceRepaintAsync(CompletionHandler<void()>&& callback)
 {
     scheduleLayerFlush();
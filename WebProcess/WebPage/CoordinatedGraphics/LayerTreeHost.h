@@ -98,6 +98,10 @@ public:
 
     WebCore::PlatformDisplayID displayID() const { return m_displayID; }
 
+#if USE(COORDINATED_GRAPHICS)
+    String compositorFrameTimeline() const;
+#endif
+
 private:
 #if USE(COORDINATED_GRAPHICS)
     void layerFlushTimerFired();
@@ -139,6 +139,7 @@ public:
 
 #if USE(COORDINATED_GRAPHICS)
     virtual void layerHostDidFlushLayers() { }
+    virtual String compositorFrameTimeline() const { return { }; }
 #endif
 
 #if USE(COORDINATED_GRAPHICS) || USE(TEXTURE_MAPPER)
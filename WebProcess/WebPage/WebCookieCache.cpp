@@ -27,8 +27,10 @@
 #include "WebCookieCache.h"
 
 #include "NetworkConnectionToWebProcessMessages.h"
+#include "Logging.h"
 #include "NetworkProcessConnection.h"
 #include "WebProcess.h"
+#include <WebCore/NetworkStorageSession.h>
 
 namespace WebKit {
 
@@ -39,23 +41,39 @@ bool WebCookieCache::isSupported()
 #if HAVE(COOKIE_CHANGE_LISTENER_API)
     // FIXME: This can eventually be removed, this is merely to ensure a smooth transition to the new API.
     return inMemoryStorageSession().supportsCookieChangeListenerAPI();
+#elif USE(SOUP)
+    // The network process notifies cookie changes from the soup cookie jar.
+    return true;
 #else
     return false;
 #endif
 }
 
+// Bounds the cookies kept in memory rather than the number of hosts, so that pages with many frames from different hosts don't thrash the cache.
+static const size_t maximumCachedCookieBytes = 64 * KB;
+
+// Accounts for the cost of a cached host with few cookies, including its subscription to cookie changes in the network process.
+static const size_t hostEntryCost = 512;
+
+static size_t cookieBytes(const Cookie& cookie)
+{
+    return cookie.name.length() + cookie.value.length() + cookie.domain.length() + cookie.path.length();
+}
+
 String WebCookieCache::cookiesForDOM(const URL& firstParty, const SameSiteInfo& sameSiteInfo, const URL& url, FrameIdentifier frameID, PageIdentifier pageID, IncludeSecureCookies includeSecureCookies)
 {
     String host = url.host().toString();
-    if (!m_hostsWithInMemoryStorage.contains(host)) {
+    auto it = m_hostEntries.find(host);
+    if (it == m_hostEntries.end()) {
         Vector<Cookie> cookies;
-        bool subscribeToCookieChangeNotifications = true;
-        if (!WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::DomCookiesForHost(url.host().toString(), subscribeToCookieChangeNotifications), Messages::NetworkConnectionToWebProcess::DomCookiesForHost::Reply(cookies), 0))
+        // A pending prefetch already subscribed to the cookie changes of this host.
+        bool subscribeToCookieChangeNotifications = !m_hostsBeingPrefetched.remove(host);
+        if (!WebProcess::singleton().ensureNetworkProcessConnection().connection().sendSync(Messages::NetworkConnectionToWebProcess::DomCookiesForHost(host, subscribeToCookieChangeNotifications), Messages::NetworkConnectionToWebProcess::DomCookiesForHost::Reply(cookies), 0))
             return { };
-        pruneCacheIfNecessary();
-        m_hostsWithInMemoryStorage.add(host);
-        for (auto& cookie : cookies)
-            inMemoryStorageSession().setCookie(cookie);
+        addHost(host, cookies, 1);
+    } else {
+        ++it->value.hitCount;
+        m_hostsWithInMemoryStorage.appendOrMoveToLast(host);
     }
     return inMemoryStorageSession().cookiesForDOM(firstParty, sameSiteInfo, url, frameID, pageID, includeSecureCookies, ShouldAskITP::No, ShouldRelaxThirdPartyCookieBlocking::No).first;
 }
@@ -63,26 +81,75 @@ String WebCookieCache::cookiesForDOM(const URL& firstParty, const SameSiteInfo&
 void WebCookieCache::setCookiesFromDOM(const URL& firstParty, const SameSiteInfo& sameSiteInfo, const URL& url, FrameIdentifier frameID, PageIdentifier pageID, const String& cookieString, ShouldRelaxThirdPartyCookieBlocking shouldRelaxThirdPartyCookieBlocking)
 {
     String host = url.host().toString();
-    if (m_hostsWithInMemoryStorage.contains(host))
-        inMemoryStorageSession().setCookiesFromDOM(firstParty, sameSiteInfo, url, frameID, pageID, ShouldAskITP::No, cookieString, shouldRelaxThirdPartyCookieBlocking);
+    if (!m_hostEntries.contains(host))
+        return;
+
+    m_hostsWithInMemoryStorage.appendOrMoveToLast(host);
+    // The size of the cache is updated when the network process notifies the change.
+    inMemoryStorageSession().setCookiesFromDOM(firstParty, sameSiteInfo, url, frameID, pageID, ShouldAskITP::No, cookieString, shouldRelaxThirdPartyCookieBlocking);
+}
+
+void WebCookieCache::prefetchCookiesForHost(const String& host)
+{
+    if (host.isEmpty() || m_hostEntries.contains(host) || !m_hostsBeingPrefetched.add(host).isNewEntry)
+        return;
+
+    WebProcess::singleton().ensureNetworkProcessConnection().connection().sendWithAsyncReply(Messages::NetworkConnectionToWebProcess::PrefetchDOMCookiesForHost(host), [this, host](Optional<Vector<Cookie>>&& cookies) {
+        // The prefetch is dropped if the cookies were fetched synchronously meanwhile or if the cache was cleared.
+        if (!m_hostsBeingPrefetched.remove(host))
+            return;
+        // The reply is cancelled when the connection to the network process is closed.
+        if (!cookies)
+            return;
+        addHost(host, *cookies, 0);
+    });
+}
+
+void WebCookieCache::addHost(const String& host, const Vector<Cookie>& cookies, unsigned missCount)
+{
+    ASSERT(!m_hostEntries.contains(host));
+
+    HostEntry entry;
+    entry.missCount = missCount;
+    for (auto& cookie : cookies) {
+        inMemoryStorageSession().setCookie(cookie);
+        entry.cookieBytes += cookieBytes(cookie);
+    }
+    m_cachedCookieBytes += entry.cookieBytes;
+    m_hostEntries.add(host, entry);
+    m_hostsWithInMemoryStorage.add(host);
+
+    pruneCacheIfNecessary();
 }
 
 void WebCookieCache::cookiesAdded(const String& host, const Vector<Cookie>& cookies)
 {
-    if (!m_hostsWithInMemoryStorage.contains(host))
+    auto it = m_hostEntries.find(host);
+    if (it == m_hostEntries.end())
         return;
 
-    for (auto& cookie : cookies)
+    for (auto& cookie : cookies) {
         inMemoryStorageSession().setCookie(cookie);
+        it->value.cookieBytes += cookieBytes(cookie);
+        m_cachedCookieBytes += cookieBytes(cookie);
+    }
+
+    pruneCacheIfNecessary();
 }
 
 void WebCookieCache::cookiesDeleted(const String& host, const Vector<WebCore::Cookie>& cookies)
 {
-    if (!m_hostsWithInMemoryStorage.contains(host))
+    auto it = m_hostEntries.find(host);
+    if (it == m_hostEntries.end())
         return;
 
-    for (auto& cookie : cookies)
+    for (auto& cookie : cookies) {
         inMemoryStorageSession().deleteCookie(cookie);
+        // Replaced cookies are not always reported as deleted, so the size is only an estimate.
+        size_t bytes = std::min(cookieBytes(cookie), it->value.cookieBytes);
+        it->value.cookieBytes -= bytes;
+        m_cachedCookieBytes -= bytes;
+    }
 }
 
 void WebCookieCache::allCookiesDeleted()
@@ -90,38 +157,72 @@ void WebCookieCache::allCookiesDeleted()
     clear();
 }
 
+HashSet<String> WebCookieCache::hostsSubscribedToCookieChangeNotifications() const
+{
+    HashSet<String> hosts = m_hostsBeingPrefetched;
+    for (auto& host : m_hostsWithInMemoryStorage)
+        hosts.add(host);
+    return hosts;
+}
+
 void WebCookieCache::clear()
 {
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
-    if (!m_hostsWithInMemoryStorage.isEmpty())
-        WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::UnsubscribeFromCookieChangeNotifications(m_hostsWithInMemoryStorage), 0);
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
+    auto hosts = hostsSubscribedToCookieChangeNotifications();
+    if (!hosts.isEmpty())
+        WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::UnsubscribeFromCookieChangeNotifications(hosts), 0);
 #endif
+    removeAllHosts();
+}
+
+void WebCookieCache::networkProcessConnectionClosed()
+{
+    // The cookie change subscriptions went away with the connection, so the cached cookies can no longer be kept up to date.
+    removeAllHosts();
+}
+
+void WebCookieCache::removeAllHosts()
+{
     m_hostsWithInMemoryStorage.clear();
+    m_hostEntries.clear();
+    m_hostsBeingPrefetched.clear();
+    m_cachedCookieBytes = 0;
     m_inMemoryStorageSession = nullptr;
 }
 
 void WebCookieCache::clearForHost(const String& host)
 {
-    String removedHost = m_hostsWithInMemoryStorage.take(host);
-    if (removedHost.isNull())
+    auto entry = m_hostEntries.take(host);
+    if (!m_hostsWithInMemoryStorage.remove(host))
         return;
 
-    inMemoryStorageSession().deleteCookiesForHostnames(Vector<String> { removedHost });
-#if HAVE(COOKIE_CHANGE_LISTENER_API)
-    WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::UnsubscribeFromCookieChangeNotifications(HashSet<String> { removedHost }), 0);
+    LOG(Network, "WebCookieCache::clearForHost: %s (hits: %u, misses: %u, cookie bytes: %zu)", host.utf8().data(), entry.hitCount, entry.missCount, entry.cookieBytes);
+    m_cachedCookieBytes -= entry.cookieBytes;
+
+    inMemoryStorageSession().deleteCookiesForHostnames(Vector<String> { host });
+#if HAVE(COOKIE_CHANGE_LISTENER_API) || USE(SOUP)
+    WebProcess::singleton().ensureNetworkProcessConnection().connection().send(Messages::NetworkConnectionToWebProcess::UnsubscribeFromCookieChangeNotifications(HashSet<String> { host }), 0);
 #endif
 }
 
 void WebCookieCache::pruneCacheIfNecessary()
 {
-    // We may want to raise this limit if we start using the cache for third-party iframes.
-    static const unsigned maxCachedHosts = 5;
-
-    while (m_hostsWithInMemoryStorage.size() >= maxCachedHosts)
-        clearForHost(*m_hostsWithInMemoryStorage.random());
+    // The most recently used host is kept even if its cookies alone exceed the budget.
+    while (m_hostsWithInMemoryStorage.size() > 1 && m_cachedCookieBytes + m_hostsWithInMemoryStorage.size() * hostEntryCost > maximumCachedCookieBytes) {
+        String leastRecentlyUsedHost = m_hostsWithInMemoryStorage.first();
+        clearForHost(leastRecentlyUsedHost);
+    }
 }
 
-#if !PLATFORM(COCOA)
+#if USE(SOUP)
+NetworkStorageSession& WebCookieCache::inMemoryStorageSession()
+{
+    // A soup storage session without persistent storage keeps its cookies in a memory only jar.
+    if (!m_inMemoryStorageSession)
+        m_inMemoryStorageSession = makeUnique<NetworkStorageSession>(WebProcess::singleton().sessionID());
+    return *m_inMemoryStorageSession;
+}
+#elif !PLATFORM(COCOA)
 NetworkStorageSession& WebCookieCache::inMemoryStorageSession()
 {
     ASSERT_NOT_IMPLEMENTED_YET();
@@ -27,7 +27,10 @@
 
 #include <WebCore/CookieJar.h>
 #include <WebCore/SameSiteInfo.h>
+#include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
+#include <wtf/ListHashSet.h>
+#include <wtf/text/StringHash.h>
 
 namespace WebCore {
 class NetworkStorageSession;
@@ -45,18 +48,35 @@ public:
     String cookiesForDOM(const URL& firstParty, const WebCore::SameSiteInfo&, const URL&, WebCore::FrameIdentifier, WebCore::PageIdentifier, WebCore::IncludeSecureCookies);
     void setCookiesFromDOM(const URL& firstParty, const WebCore::SameSiteInfo&, const URL&, WebCore::FrameIdentifier, WebCore::PageIdentifier, const String& cookieString, WebCore::ShouldRelaxThirdPartyCookieBlocking);
 
+    // Fetches the cookies of the host asynchronously so that the first access from the DOM doesn't need a synchronous IPC.
+    void prefetchCookiesForHost(const String& host);
+
     void cookiesAdded(const String& host, const Vector<WebCore::Cookie>&);
     void cookiesDeleted(const String& host, const Vector<WebCore::Cookie>&);
     void allCookiesDeleted();
 
     void clear();
     void clearForHost(const String&);
+    void networkProcessConnectionClosed();
 
 private:
+    struct HostEntry {
+        size_t cookieBytes { 0 };
+        unsigned hitCount { 0 };
+        unsigned missCount { 0 };
+    };
+
     WebCore::NetworkStorageSession& inMemoryStorageSession();
+    void addHost(const String&, const Vector<WebCore::Cookie>&, unsigned missCount);
+    void removeAllHosts();
     void pruneCacheIfNecessary();
+    HashSet<String> hostsSubscribedToCookieChangeNotifications() const;
 
-    HashSet<String> m_hostsWithInMemoryStorage;
+    // Hosts are ordered from the least to the most recently used.
+    ListHashSet<String> m_hostsWithInMemoryStorage;
+    HashMap<String, HostEntry> m_hostEntries;
+    HashSet<String> m_hostsBeingPrefetched;
+    size_t m_cachedCookieBytes { 0 };
     std::unique_ptr<WebCore::NetworkStorageSession> m_inMemoryStorageSession;
 };
 
@@ -94,6 +94,11 @@ static bool shouldBlockCookies(WebFrame* frame, const URL& firstPartyForCookies,
 #endif
 
 bool WebCookieJar::isEligibleForCache(WebFrame& frame, const URL& firstPartyForCookies, const URL& resourceURL) const
+{
+    return isEligibleForCache(frame, frame.isMainFrame(), firstPartyForCookies, resourceURL);
+}
+
+bool WebCookieJar::isEligibleForCache(WebFrame& frame, bool isMainFrame, const URL& firstPartyForCookies, const URL& resourceURL) const
 {
     auto* page = frame.page() ? frame.page()->corePage() : nullptr;
     if (!page || !page->settings().inProcessCookieCacheEnabled())
@@ -107,7 +112,7 @@ bool WebCookieJar::isEligibleForCache(WebFrame& frame, const URL& firstPartyForC
     if (resourceDomain.isEmpty())
         return false;
 
-    return frame.isMainFrame() || RegistrableDomain { firstPartyForCookies } == resourceDomain;
+    return isMainFrame || RegistrableDomain { firstPartyForCookies } == resourceDomain;
 }
 
 static WebCore::ShouldRelaxThirdPartyCookieBlocking shouldRelaxThirdPartyCookieBlocking(const WebFrame* frame)
@@ -188,6 +193,16 @@ void WebCookieJar::allCookiesDeleted()
     m_cache.allCookiesDeleted();
 }
 
+void WebCookieJar::prefetchCookiesForSubframe(WebFrame& parentFrame, const URL& firstPartyForCookies, const URL& url)
+{
+    // The settings of the parent frame apply to the subframe, which is never the main frame.
+    bool isMainFrame = false;
+    if (!isEligibleForCache(parentFrame, isMainFrame, firstPartyForCookies, url))
+        return;
+
+    m_cache.prefetchCookiesForHost(url.host().toString());
+}
+
 void WebCookieJar::clearCache()
 {
     m_cache.clear();
@@ -198,6 +213,11 @@ void WebCookieJar::clearCacheForHost(const String& host)
     m_cache.clearForHost(host);
 }
 
+void WebCookieJar::networkProcessConnectionClosed()
+{
+    m_cache.networkProcessConnectionClosed();
+}
+
 bool WebCookieJar::cookiesEnabled(const Document& document) const
 {
     auto* webFrame = document.frame() ? WebFrame::fromCoreFrame(*document.frame()) : nullptr;
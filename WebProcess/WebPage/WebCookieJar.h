@@ -52,12 +52,18 @@ public:
     void cookiesDeleted(const String& host, const Vector<WebCore::Cookie>&);
     void allCookiesDeleted();
 
+    // Called before creating a subframe that will load the URL.
+    void prefetchCookiesForSubframe(WebFrame& parentFrame, const URL& firstPartyForCookies, const URL&);
+
+    void networkProcessConnectionClosed();
+
 private:
     WebCookieJar();
 
     void clearCache() final;
     void clearCacheForHost(const String&) final;
     bool isEligibleForCache(WebFrame&, const URL& firstPartyForCookies, const URL& resourceURL) const;
+    bool isEligibleForCache(WebFrame&, bool isMainFrame, const URL& firstPartyForCookies, const URL& resourceURL) const;
 
     mutable WebCookieCache m_cache;
 };
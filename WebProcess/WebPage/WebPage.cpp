@@ -3738,6 +3738,13 @@ void WebPage::forceRepaint(CompletionHandler<void()>&& completionHandler)
     m_drawingArea->forceRepaintAsync(*this, WTFMove(completionHandler));
 }
 
+#if USE(COORDINATED_GRAPHICS)
+void WebPage::getCompositorFrameTimeline(CompletionHandler<void(const String&)>&& completionHandler)
+{
+    completionHandler(m_drawingArea ? m_drawingArea->compositorFrameTimeline() : String());
+}
+#endif
+
 void WebPage::preferencesDidChange(const WebPreferencesStore& store)
 {
     WebPreferencesStore::removeTestRunnerOverrides();
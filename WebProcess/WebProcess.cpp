@@ -131,6 +131,7 @@
 #include <wtf/Algorithms.h>
 #include <wtf/CallbackAggregator.h>
 #include <wtf/Language.h>
+#include <wtf/MemoryFootprint.h>
 #include <wtf/ProcessPrivilege.h>
 #include <wtf/RunLoop.h>
 #include <wtf/SystemTracing.h>
@@ -912,6 +913,11 @@ void WebProcess::isJITEnabled(CompletionHandler<void(bool)>&& completionHandler)
     completionHandler(JSC::Options::useJIT());
 }
 
+void WebProcess::getMemoryFootprint(CompletionHandler<void(uint64_t)>&& completionHandler)
+{
+    completionHandler(WTF::memoryFootprint());
+}
+
 void WebProcess::refreshPlugins()
 {
 #if ENABLE(NETSCAPE_PLUGIN_API)
@@ -1122,6 +1128,7 @@ void WebProcess::networkProcessConnectionClosed(NetworkProcessConnection* connec
 
     logDiagnosticMessageForNetworkProcessCrash();
 
+    m_cookieJar->networkProcessConnectionClosed();
     m_webLoaderStrategy.networkProcessCrashed();
     WebSocketStream::networkProcessCrashed();
     m_webSocketChannelManager.networkProcessCrashed();
@@ -278,6 +278,7 @@ public:
     void sendPrewarmInformation(const URL&);
 
     void isJITEnabled(CompletionHandler<void(bool)>&&);
+    void getMemoryFootprint(CompletionHandler<void(uint64_t)>&&);
 
 #if PLATFORM(IOS_FAMILY)
     void resetAllGeolocationPermissions();